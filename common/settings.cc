@@ -40,6 +40,9 @@ std::string Settings::ToString() const {
   stream << "trace_systrace: " << trace_systrace << std::endl;
   stream << "dump_skp_on_shader_compilation: " << dump_skp_on_shader_compilation
          << std::endl;
+  stream << "shader_warm_up_skp_path: " << shader_warm_up_skp_path << std::endl;
+  stream << "shader_warm_up_budget_ms: " << shader_warm_up_budget_ms
+         << std::endl;
   stream << "endless_trace_buffer: " << endless_trace_buffer << std::endl;
   stream << "enable_dart_profiling: " << enable_dart_profiling << std::endl;
   stream << "disable_dart_asserts: " << disable_dart_asserts << std::endl;
@@ -49,6 +52,20 @@ std::string Settings::ToString() const {
   stream << "use_test_fonts: " << use_test_fonts << std::endl;
   stream << "enable_software_rendering: " << enable_software_rendering
          << std::endl;
+  stream << "enable_concurrent_raster_cache: "
+         << enable_concurrent_raster_cache << std::endl;
+  stream << "enable_adaptive_raster_cache: " << enable_adaptive_raster_cache
+         << std::endl;
+  stream << "enable_concurrent_software_paint: "
+         << enable_concurrent_software_paint << std::endl;
+  stream << "enable_frame_pipeline_mailbox: " << enable_frame_pipeline_mailbox
+         << std::endl;
+  stream << "enable_pointer_event_coalescing: "
+         << enable_pointer_event_coalescing << std::endl;
+  stream << "disable_frame_throttling: " << disable_frame_throttling
+         << std::endl;
+  stream << "decoded_image_cache_max_bytes: " << decoded_image_cache_max_bytes
+         << std::endl;
   stream << "log_tag: " << log_tag << std::endl;
   stream << "icu_initialization_required: " << icu_initialization_required
          << std::endl;
@@ -31,8 +31,27 @@ class FrameTiming {
     return data_[phase] = value;
   }
 
+  // How long the frame waited in the pipeline between the UI thread
+  // submitting it and the GPU thread picking it up.
+  fml::TimeDelta GetQueueingDelay() const { return queueing_delay_; }
+  void SetQueueingDelay(fml::TimeDelta delay) { queueing_delay_ = delay; }
+
+  // The time at which the vsync that started the frame expected it to be
+  // presented. The difference to |kBuildStart| is the frame budget.
+  fml::TimePoint GetFrameTargetTime() const { return frame_target_time_; }
+  void SetFrameTargetTime(fml::TimePoint time) { frame_target_time_ = time; }
+
+  // Whether Skia had to compile new shaders to rasterize the frame.
+  bool GetCompiledNewShaders() const { return compiled_new_shaders_; }
+  void SetCompiledNewShaders(bool compiled) {
+    compiled_new_shaders_ = compiled;
+  }
+
  private:
   fml::TimePoint data_[kCount];
+  fml::TimeDelta queueing_delay_;
+  fml::TimePoint frame_target_time_;
+  bool compiled_new_shaders_ = false;
 };
 
 using TaskObserverAdd =
@@ -93,6 +112,13 @@ struct Settings {
   bool trace_startup = false;
   bool trace_systrace = false;
   bool dump_skp_on_shader_compilation = false;
+  // Directory of SKPs (e.g. ones written because of
+  // |dump_skp_on_shader_compilation|) that are replayed before the first frame
+  // so that the shaders they use are compiled ahead of time. No warm-up is
+  // done if empty.
+  std::string shader_warm_up_skp_path;
+  // The maximum time spent replaying SKPs for shader warm-up.
+  uint32_t shader_warm_up_budget_ms = 500;
   bool endless_trace_buffer = false;
   bool enable_dart_profiling = false;
   bool disable_dart_asserts = false;
@@ -161,6 +187,37 @@ struct Settings {
   UnhandledExceptionCallback unhandled_exception_callback;
   bool enable_software_rendering = false;
   bool skia_deterministic_rendering_on_cpu = false;
+  // Rasterize raster cache entries for pictures on the concurrent worker pool
+  // instead of on the GPU thread. Pictures are drawn directly until their
+  // cache entries are ready.
+  bool enable_concurrent_raster_cache = false;
+  // Decide which pictures and layers to rasterize into the raster cache from
+  // their measured paint times instead of from static hints and complexity
+  // heuristics.
+  bool enable_adaptive_raster_cache = false;
+  // When non-zero, the time in milliseconds that may be spent rasterizing
+  // pictures into the raster cache on the GPU thread per frame. Replaces the
+  // fixed number of pictures that may be rasterized per frame.
+  uint32_t raster_cache_rasterization_budget_ms = 0;
+  // Split frames rendered by the software backend into bands that are painted
+  // concurrently on the concurrent worker pool.
+  bool enable_concurrent_software_paint = false;
+  // Let the UI thread replace a frame that is still waiting to be rasterized
+  // instead of waiting for the GPU thread to pick it up. The GPU thread then
+  // always draws the newest frame, which reduces latency when rasterization
+  // is the bottleneck at the cost of dropping frames.
+  bool enable_frame_pipeline_mailbox = false;
+  // Queue pointer events and deliver them to the framework once per frame,
+  // merging consecutive moves of a device and resampling them to the frame
+  // time, instead of making a Dart call for every platform event.
+  bool enable_pointer_event_coalescing = false;
+  // Begin a new frame as soon as the previous one was produced instead of
+  // waiting for vsync. Meant for headless rendering, where frames are not
+  // shown on a display.
+  bool disable_frame_throttling = false;
+  // The maximum number of bytes of decoded images the engine keeps so that
+  // decoding the same image again is free. Zero disables the cache.
+  uint64_t decoded_image_cache_max_bytes = 0;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
 
@@ -5,6 +5,7 @@
 #include "flutter/flow/compositor_context.h"
 
 #include "flutter/flow/layers/layer_tree.h"
+#include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace flutter {
@@ -29,6 +30,13 @@ void CompositorContext::EndFrame(ScopedFrame& frame,
   }
 }
 
+void CompositorContext::SetConcurrentPaintTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+    size_t max_band_count) {
+  concurrent_paint_task_runner_ = std::move(task_runner);
+  max_paint_band_count_ = max_band_count;
+}
+
 std::unique_ptr<CompositorContext::ScopedFrame> CompositorContext::AcquireFrame(
     GrContext* gr_context,
     SkCanvas* canvas,
@@ -63,7 +71,24 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
 RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
     bool ignore_raster_cache) {
+  if (partial_repaint_enabled_) {
+    frame_damage_ = std::make_unique<FrameDamage>(layer_tree.frame_size());
+  }
   layer_tree.Preroll(*this, ignore_raster_cache);
+
+  SkAutoCanvasRestore auto_restore(canvas(), canvas() != nullptr);
+  if (frame_damage_) {
+    damage_ = context_.UpdateFrameDamage(std::move(frame_damage_));
+    FML_TRACE_COUNTER("flutter", "FrameDamage",
+                      reinterpret_cast<int64_t>(&context_),  //
+                      "Width", damage_->width(),            //
+                      "Height", damage_->height()           //
+    );
+    if (canvas()) {
+      canvas()->clipRect(SkRect::Make(*damage_));
+    }
+  }
+
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
   if (canvas()) {
@@ -73,14 +98,23 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   return RasterStatus::kSuccess;
 }
 
+SkIRect CompositorContext::UpdateFrameDamage(
+    std::unique_ptr<FrameDamage> frame_damage) {
+  SkIRect damage = frame_damage->ComputeDamage(last_frame_damage_.get());
+  last_frame_damage_ = std::move(frame_damage);
+  return damage;
+}
+
 void CompositorContext::OnGrContextCreated() {
   texture_registry_.OnGrContextCreated();
   raster_cache_.Clear();
+  last_frame_damage_.reset();
 }
 
 void CompositorContext::OnGrContextDestroyed() {
   texture_registry_.OnGrContextDestroyed();
   raster_cache_.Clear();
+  last_frame_damage_.reset();
 }
 
 }  // namespace flutter
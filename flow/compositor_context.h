@@ -6,12 +6,15 @@
 #define FLUTTER_FLOW_COMPOSITOR_CONTEXT_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/frame_damage.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -47,6 +50,21 @@ class CompositorContext {
 
     GrContext* gr_context() const { return gr_context_; }
 
+    // Enables damage tracking for this frame. Must only be enabled when the
+    // canvas still holds the contents of the previous frame rastered with
+    // damage tracking enabled. Only the damaged area of the frame is then
+    // repainted.
+    void set_partial_repaint_enabled(bool enabled) {
+      partial_repaint_enabled_ = enabled;
+    }
+
+    // Valid during |Raster| when partial repaint is enabled.
+    FrameDamage* frame_damage() const { return frame_damage_.get(); }
+
+    // The area of the canvas that was repainted by |Raster|. Unset when the
+    // whole frame was repainted because partial repaint was not enabled.
+    const std::optional<SkIRect>& damage() const { return damage_; }
+
     virtual RasterStatus Raster(LayerTree& layer_tree,
                                 bool ignore_raster_cache);
 
@@ -57,6 +75,9 @@ class CompositorContext {
     ExternalViewEmbedder* view_embedder_;
     const SkMatrix& root_surface_transformation_;
     const bool instrumentation_enabled_;
+    bool partial_repaint_enabled_ = false;
+    std::unique_ptr<FrameDamage> frame_damage_;
+    std::optional<SkIRect> damage_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(ScopedFrame);
   };
@@ -86,17 +107,42 @@ class CompositorContext {
 
   Stopwatch& ui_time() { return ui_time_; }
 
+  // When a task runner is set, frames rasterized into CPU backed canvases are
+  // split into up to |max_band_count| horizontal bands that are painted
+  // concurrently on that runner and on the calling thread. Frames with layers
+  // that require serial painting, frames with platform views and frames
+  // rasterized with a GrContext are painted on the calling thread as usual.
+  // Pass nullptr to always paint on the calling thread.
+  void SetConcurrentPaintTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+      size_t max_band_count);
+
+  const std::shared_ptr<fml::ConcurrentTaskRunner>&
+  concurrent_paint_task_runner() const {
+    return concurrent_paint_task_runner_;
+  }
+
+  size_t max_paint_band_count() const { return max_paint_band_count_; }
+
  private:
   RasterCache raster_cache_;
   TextureRegistry texture_registry_;
+  // What was painted in the last frame rastered with partial repaint enabled.
+  std::unique_ptr<FrameDamage> last_frame_damage_;
   Counter frame_count_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_paint_task_runner_;
+  size_t max_paint_band_count_ = 0;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
   void EndFrame(ScopedFrame& frame, bool enable_instrumentation);
 
+  // Returns the damage of |frame_damage| relative to the last frame and
+  // retains it for the next frame.
+  SkIRect UpdateFrameDamage(std::unique_ptr<FrameDamage> frame_damage);
+
   FML_DISALLOW_COPY_AND_ASSIGN(CompositorContext);
 };
 
@@ -0,0 +1,111 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_damage.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+FrameDamage::FrameDamage(const SkISize& frame_size) : frame_size_(frame_size) {}
+
+FrameDamage::~FrameDamage() = default;
+
+void FrameDamage::AddLayer(uint64_t signature,
+                           const SkMatrix& matrix,
+                           const SkRect& paint_bounds) {
+  if (paint_bounds.isEmpty()) {
+    return;
+  }
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, paint_bounds);
+  SkIRect rounded_bounds;
+  // Outset by a pixel to account for anti-aliasing at the edges.
+  device_bounds.roundOut(&rounded_bounds);
+  rounded_bounds.outset(1, 1);
+  entries_.push_back({signature, rounded_bounds});
+}
+
+SkIRect FrameDamage::ComputeDamage(const FrameDamage* previous) const {
+  const SkIRect frame_rect = SkIRect::MakeSize(frame_size_);
+  if (previous == nullptr || previous->frame_size_ != frame_size_ ||
+      full_damage_ || previous->full_damage_) {
+    return frame_rect;
+  }
+
+  std::unordered_map<uint64_t, std::vector<SkIRect>> unmatched;
+  for (const auto& entry : previous->entries_) {
+    unmatched[entry.signature].push_back(entry.device_bounds);
+  }
+
+  SkIRect damage = SkIRect::MakeEmpty();
+  for (const auto& entry : entries_) {
+    if (entry.signature == kVolatileSignature) {
+      damage.join(entry.device_bounds);
+      continue;
+    }
+    auto found = unmatched.find(entry.signature);
+    if (found == unmatched.end()) {
+      damage.join(entry.device_bounds);
+      continue;
+    }
+    auto& candidates = found->second;
+    auto match = std::find(candidates.begin(), candidates.end(),
+                           entry.device_bounds);
+    if (match == candidates.end()) {
+      damage.join(entry.device_bounds);
+      continue;
+    }
+    *match = candidates.back();
+    candidates.pop_back();
+  }
+
+  // Whatever was painted in the previous frame but is gone now must be
+  // repainted as well.
+  for (const auto& item : unmatched) {
+    for (const auto& bounds : item.second) {
+      damage.join(bounds);
+    }
+  }
+
+  if (!damage.intersect(frame_rect)) {
+    return SkIRect::MakeEmpty();
+  }
+  return damage;
+}
+
+uint64_t FrameDamage::HashMatrix(uint64_t seed, const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  return HashBytes(seed, values, sizeof(values));
+}
+
+uint64_t FrameDamage::HashPath(uint64_t seed, const SkPath& path) {
+  uint64_t hash = Hash(seed, path.getFillType());
+  const int point_count = path.countPoints();
+  std::vector<SkPoint> points(point_count);
+  path.getPoints(points.data(), point_count);
+  hash = HashBytes(hash, points.data(), points.size() * sizeof(SkPoint));
+  const int verb_count = path.countVerbs();
+  std::vector<uint8_t> verbs(verb_count);
+  path.getVerbs(verbs.data(), verb_count);
+  return HashBytes(hash, verbs.data(), verbs.size());
+}
+
+uint64_t FrameDamage::HashFlattenable(uint64_t seed,
+                                      const SkFlattenable* flattenable) {
+  if (flattenable == nullptr) {
+    return Hash(seed, 0);
+  }
+  sk_sp<SkData> data = flattenable->serialize();
+  if (!data) {
+    return Hash(seed, flattenable);
+  }
+  return HashBytes(seed, data->data(), data->size());
+}
+
+}  // namespace flutter
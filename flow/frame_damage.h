@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_DAMAGE_H_
+#define FLUTTER_FLOW_FRAME_DAMAGE_H_
+
+#include <cstring>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace flutter {
+
+// Records what each layer in a frame contributes to the surface so that two
+// consecutive frames can be compared to find the area of the surface that
+// needs to be repainted.
+//
+// Layers are identified by a signature that describes their own content
+// (e.g. the picture they draw or the opacity they apply) combined with the
+// signature of their parent and their index among their siblings, so that
+// reordering or reparenting layers is detected as well. Layers are rebuilt by
+// the framework every frame, so the signature must not depend on object
+// identity unless the layer is retained.
+class FrameDamage {
+ public:
+  // The signature of layers whose output may change without the layer tree
+  // changing (e.g. external textures). These are damaged in every frame.
+  static constexpr uint64_t kVolatileSignature = 0;
+
+  explicit FrameDamage(const SkISize& frame_size);
+
+  ~FrameDamage();
+
+  const SkISize& frame_size() const { return frame_size_; }
+
+  // Records a layer whose |paint_bounds| are mapped to the surface by
+  // |matrix|.
+  void AddLayer(uint64_t signature,
+                const SkMatrix& matrix,
+                const SkRect& paint_bounds);
+
+  // Marks the entire frame as damaged. Used when the layer tree contains
+  // content whose extent cannot be tracked.
+  void AddFullDamage() { full_damage_ = true; }
+
+  // Returns the area of the surface that differs between |previous| and this
+  // frame, clamped to the frame. The whole frame is damaged when there is no
+  // previous frame or the frame size changed.
+  SkIRect ComputeDamage(const FrameDamage* previous) const;
+
+  size_t layer_count() const { return entries_.size(); }
+
+  // Helpers for layers to build their signatures.
+  static uint64_t Seed(const char* layer_type) {
+    return HashBytes(0, layer_type, std::strlen(layer_type));
+  }
+
+  static uint64_t Combine(uint64_t seed, uint64_t value) {
+    // Same mixing as boost::hash_combine, widened to 64 bits.
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+  }
+
+  static uint64_t HashBytes(uint64_t seed, const void* data, size_t length) {
+    // FNV-1a.
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed ^ 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; i++) {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ull;
+    }
+    return hash;
+  }
+
+  template <typename T>
+  static uint64_t Hash(uint64_t seed, const T& value) {
+    return HashBytes(seed, &value, sizeof(T));
+  }
+
+  static uint64_t HashMatrix(uint64_t seed, const SkMatrix& matrix);
+
+  static uint64_t HashPath(uint64_t seed, const SkPath& path);
+
+  // Hashes the serialized form of |flattenable| (e.g. a filter or a shader),
+  // which is recreated by the framework every frame.
+  static uint64_t HashFlattenable(uint64_t seed,
+                                  const SkFlattenable* flattenable);
+
+ private:
+  struct Entry {
+    uint64_t signature;
+    SkIRect device_bounds;
+  };
+
+  const SkISize frame_size_;
+  std::vector<Entry> entries_;
+  bool full_damage_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameDamage);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_FRAME_DAMAGE_H_
@@ -0,0 +1,192 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_damage.h"
+
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// A leaf layer that paints |content| (standing in for e.g. a picture) at
+// |bounds|.
+class ContentLayer : public Layer {
+ public:
+  ContentLayer(uint64_t content, const SkRect& bounds)
+      : content_(content), bounds_(bounds) {}
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    set_paint_bounds(bounds_);
+  }
+
+  void Paint(PaintContext& context) const override {}
+
+  uint64_t damage_signature() const override { return content_; }
+
+ private:
+  uint64_t content_;
+  SkRect bounds_;
+};
+
+std::shared_ptr<ContentLayer> MakeContentLayer(uint64_t content,
+                                               const SkPoint& offset) {
+  return std::make_shared<ContentLayer>(
+      content, SkRect::MakeXYWH(offset.x(), offset.y(), 50, 50));
+}
+
+std::unique_ptr<FrameDamage> PrerollWithDamage(Layer* root) {
+  auto frame_damage = std::make_unique<FrameDamage>(SkISize::Make(800, 600));
+  const Stopwatch unused_stopwatch;
+  TextureRegistry unused_texture_registry;
+  MutatorsStack unused_stack;
+  PrerollContext preroll_context{
+      nullptr,                  // raster_cache (don't consult the cache)
+      nullptr,                  // gr_context  (used for the raster cache)
+      nullptr,                  // external view embedder
+      unused_stack,             // mutator stack
+      nullptr,                  // SkColorSpace* dst_color_space
+      kGiantRect,               // SkRect cull_rect
+      unused_stopwatch,         // frame time (dont care)
+      unused_stopwatch,         // engine time (dont care)
+      unused_texture_registry,  // texture registry (not supported)
+      false,                    // checkerboard_offscreen_layers
+      0.0f,                     // total elevation
+      frame_damage.get(),       // frame damage
+  };
+  root->Preroll(&preroll_context, SkMatrix::I());
+  return frame_damage;
+}
+
+}  // namespace
+
+TEST(FrameDamage, FirstFrameIsFullyDamaged) {
+  FrameDamage frame(SkISize::Make(800, 600));
+  frame.AddLayer(1, SkMatrix::I(), SkRect::MakeXYWH(10, 10, 10, 10));
+  ASSERT_EQ(frame.ComputeDamage(nullptr), SkIRect::MakeWH(800, 600));
+}
+
+TEST(FrameDamage, IdenticalFramesHaveNoDamage) {
+  FrameDamage previous(SkISize::Make(800, 600));
+  previous.AddLayer(1, SkMatrix::I(), SkRect::MakeXYWH(10, 10, 10, 10));
+  FrameDamage current(SkISize::Make(800, 600));
+  current.AddLayer(1, SkMatrix::I(), SkRect::MakeXYWH(10, 10, 10, 10));
+  ASSERT_TRUE(current.ComputeDamage(&previous).isEmpty());
+}
+
+TEST(FrameDamage, ResizedFrameIsFullyDamaged) {
+  FrameDamage previous(SkISize::Make(800, 600));
+  previous.AddLayer(1, SkMatrix::I(), SkRect::MakeXYWH(10, 10, 10, 10));
+  FrameDamage current(SkISize::Make(400, 300));
+  current.AddLayer(1, SkMatrix::I(), SkRect::MakeXYWH(10, 10, 10, 10));
+  ASSERT_EQ(current.ComputeDamage(&previous), SkIRect::MakeWH(400, 300));
+}
+
+TEST(FrameDamage, MovedLayerDamagesOldAndNewBounds) {
+  FrameDamage previous(SkISize::Make(800, 600));
+  previous.AddLayer(1, SkMatrix::I(), SkRect::MakeXYWH(10, 10, 10, 10));
+  FrameDamage current(SkISize::Make(800, 600));
+  current.AddLayer(1, SkMatrix::MakeTrans(100, 0),
+                   SkRect::MakeXYWH(10, 10, 10, 10));
+  // Bounds are outset by a pixel for anti-aliasing.
+  ASSERT_EQ(current.ComputeDamage(&previous),
+            SkIRect::MakeLTRB(9, 9, 121, 21));
+}
+
+TEST(FrameDamage, VolatileLayersAreAlwaysDamaged) {
+  FrameDamage previous(SkISize::Make(800, 600));
+  previous.AddLayer(FrameDamage::kVolatileSignature, SkMatrix::I(),
+                    SkRect::MakeXYWH(10, 10, 10, 10));
+  FrameDamage current(SkISize::Make(800, 600));
+  current.AddLayer(FrameDamage::kVolatileSignature, SkMatrix::I(),
+                   SkRect::MakeXYWH(10, 10, 10, 10));
+  ASSERT_EQ(current.ComputeDamage(&previous), SkIRect::MakeLTRB(9, 9, 21, 21));
+}
+
+TEST(FrameDamage, RebuiltLayerTreeWithSameContentHasNoDamage) {
+  auto previous_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  previous_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  previous_root->Add(MakeContentLayer(2, SkPoint::Make(100, 0)));
+  auto previous = PrerollWithDamage(previous_root.get());
+
+  auto current_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  current_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  current_root->Add(MakeContentLayer(2, SkPoint::Make(100, 0)));
+  auto current = PrerollWithDamage(current_root.get());
+
+  ASSERT_TRUE(current->ComputeDamage(previous.get()).isEmpty());
+}
+
+TEST(FrameDamage, ChangedContentDamagesOnlyItsBounds) {
+  auto previous_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  previous_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  previous_root->Add(MakeContentLayer(2, SkPoint::Make(100, 0)));
+  auto previous = PrerollWithDamage(previous_root.get());
+
+  auto current_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  current_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  current_root->Add(MakeContentLayer(3, SkPoint::Make(100, 0)));
+  auto current = PrerollWithDamage(current_root.get());
+
+  ASSERT_EQ(current->ComputeDamage(previous.get()),
+            SkIRect::MakeLTRB(99, 0, 151, 51));
+}
+
+TEST(FrameDamage, ChangedContentDoesNotDamageFollowingSiblings) {
+  auto previous_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  previous_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  previous_root->Add(MakeContentLayer(2, SkPoint::Make(100, 0)));
+  previous_root->Add(MakeContentLayer(3, SkPoint::Make(200, 0)));
+  previous_root->Add(MakeContentLayer(4, SkPoint::Make(300, 0)));
+  auto previous = PrerollWithDamage(previous_root.get());
+
+  auto current_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  current_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  current_root->Add(MakeContentLayer(5, SkPoint::Make(100, 0)));
+  current_root->Add(MakeContentLayer(3, SkPoint::Make(200, 0)));
+  current_root->Add(MakeContentLayer(4, SkPoint::Make(300, 0)));
+  auto current = PrerollWithDamage(current_root.get());
+
+  ASSERT_EQ(current->ComputeDamage(previous.get()),
+            SkIRect::MakeLTRB(99, 0, 151, 51));
+}
+
+TEST(FrameDamage, ChangedTransformDamagesChildren) {
+  auto previous_root = std::make_shared<TransformLayer>(SkMatrix::I());
+  previous_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  auto previous = PrerollWithDamage(previous_root.get());
+
+  auto current_root =
+      std::make_shared<TransformLayer>(SkMatrix::MakeTrans(0, 100));
+  current_root->Add(MakeContentLayer(1, SkPoint::Make(0, 0)));
+  auto current = PrerollWithDamage(current_root.get());
+
+  ASSERT_EQ(current->ComputeDamage(previous.get()),
+            SkIRect::MakeLTRB(0, 0, 51, 151));
+}
+
+TEST(FrameDamage, OpacityOffsetIsScaledByTheParentTransform) {
+  auto make_root = [](uint64_t content) {
+    // A device pixel ratio of 2.
+    auto root = std::make_shared<TransformLayer>(SkMatrix::MakeScale(2));
+    auto opacity =
+        std::make_shared<OpacityLayer>(128, SkPoint::Make(100, 100));
+    opacity->Add(MakeContentLayer(content, SkPoint::Make(0, 0)));
+    root->Add(opacity);
+    return root;
+  };
+  auto previous_root = make_root(1);
+  auto previous = PrerollWithDamage(previous_root.get());
+  auto current_root = make_root(2);
+  auto current = PrerollWithDamage(current_root.get());
+
+  // The content is painted at (100, 100) in the space of the opacity layer,
+  // which is (200, 200) on the device.
+  ASSERT_EQ(current->ComputeDamage(previous.get()),
+            SkIRect::MakeLTRB(199, 199, 301, 301));
+}
+
+}  // namespace flutter
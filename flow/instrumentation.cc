@@ -5,6 +5,7 @@
 #include "flutter/flow/instrumentation.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "third_party/skia/include/core/SkPath.h"
@@ -291,6 +292,106 @@ void CounterValues::Visualize(SkCanvas& canvas, const SkRect& rect) const {
   canvas.drawRect(marker_rect, paint);
 }
 
+// Durations below 2 * |kSubBucketHalfCount| microseconds get a bucket each.
+// Above that, every power of two is split into |kSubBucketHalfCount| linear
+// sub-buckets.
+static constexpr int kSubBucketHalfCountMagnitude = 6;
+static constexpr int64_t kSubBucketHalfCount = 1
+                                               << kSubBucketHalfCountMagnitude;
+// Durations are clamped to 2^32us, a bit more than an hour.
+static constexpr int kMaxValueMagnitude = 32;
+static constexpr int64_t kMaxHistogramValue =
+    (static_cast<int64_t>(1) << kMaxValueMagnitude) - 1;
+static constexpr size_t kHistogramBucketCount =
+    (kMaxValueMagnitude - kSubBucketHalfCountMagnitude + 1) *
+    kSubBucketHalfCount;
+
+static inline int HighestBit(uint64_t value) {
+  int bit = -1;
+  while (value != 0) {
+    value >>= 1;
+    bit++;
+  }
+  return bit;
+}
+
+static size_t HistogramBucketIndex(int64_t micros) {
+  if (micros < 2 * kSubBucketHalfCount) {
+    return static_cast<size_t>(micros);
+  }
+  const int shift = HighestBit(micros) - kSubBucketHalfCountMagnitude;
+  return (shift + 1) * kSubBucketHalfCount +
+         ((micros >> shift) - kSubBucketHalfCount);
+}
+
+// The largest duration that falls into the bucket at |index|.
+static int64_t HistogramBucketUpperBound(size_t index) {
+  if (index < 2 * kSubBucketHalfCount) {
+    return static_cast<int64_t>(index);
+  }
+  const int shift = index / kSubBucketHalfCount - 1;
+  const int64_t sub_bucket = index % kSubBucketHalfCount + kSubBucketHalfCount;
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+TimeHistogram::TimeHistogram() : buckets_(kHistogramBucketCount, 0) {
+  Reset();
+}
+
+TimeHistogram::~TimeHistogram() = default;
+
+void TimeHistogram::Record(fml::TimeDelta delta) {
+  const int64_t micros =
+      std::clamp<int64_t>(delta.ToMicroseconds(), 0, kMaxHistogramValue);
+  buckets_[HistogramBucketIndex(micros)]++;
+  count_++;
+  min_micros_ = std::min(min_micros_, micros);
+  max_micros_ = std::max(max_micros_, micros);
+  sum_micros_ += micros;
+}
+
+void TimeHistogram::Reset() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = 0;
+  min_micros_ = std::numeric_limits<int64_t>::max();
+  max_micros_ = 0;
+  sum_micros_ = 0;
+}
+
+fml::TimeDelta TimeHistogram::Min() const {
+  return fml::TimeDelta::FromMicroseconds(count_ == 0 ? 0 : min_micros_);
+}
+
+fml::TimeDelta TimeHistogram::Max() const {
+  return fml::TimeDelta::FromMicroseconds(max_micros_);
+}
+
+fml::TimeDelta TimeHistogram::Mean() const {
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  return fml::TimeDelta::FromMicroseconds(sum_micros_ / count_);
+}
+
+fml::TimeDelta TimeHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      // The bucket bound may overshoot the largest recorded duration.
+      return fml::TimeDelta::FromMicroseconds(
+          std::min(HistogramBucketUpperBound(i), max_micros_));
+    }
+  }
+  return Max();
+}
+
 int64_t CounterValues::GetCurrentValue() const {
   return values_[current_sample_];
 }
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_INSTRUMENTATION_H_
 #define FLUTTER_FLOW_INSTRUMENTATION_H_
 
+#include <cstdint>
 #include <vector>
 
 #include "flutter/fml/macros.h"
@@ -55,6 +56,48 @@ class Stopwatch {
   FML_DISALLOW_COPY_AND_ASSIGN(Stopwatch);
 };
 
+// A log-linear histogram of durations in the spirit of HdrHistogram. Values
+// are bucketed at microsecond resolution with a relative error of at most
+// 1/64 (~1.6%), independently of their magnitude, so tail percentiles of
+// long frames are as meaningful as the median of short ones. Recording is
+// O(1) and the memory footprint is fixed.
+//
+// Unlike |Stopwatch|, which only keeps the last few laps around for the
+// performance overlay, the histogram summarizes every recorded duration since
+// the last |Reset|.
+class TimeHistogram {
+ public:
+  TimeHistogram();
+
+  ~TimeHistogram();
+
+  void Record(fml::TimeDelta delta);
+
+  void Reset();
+
+  size_t count() const { return count_; }
+
+  fml::TimeDelta Min() const;
+
+  fml::TimeDelta Max() const;
+
+  fml::TimeDelta Mean() const;
+
+  // Returns the smallest recorded duration that is greater than or equal to
+  // |percentile| percent (0-100) of the recorded durations, rounded up to
+  // the bucket resolution. Returns zero for an empty histogram.
+  fml::TimeDelta Percentile(double percentile) const;
+
+ private:
+  std::vector<uint64_t> buckets_;
+  size_t count_;
+  int64_t min_micros_;
+  int64_t max_micros_;
+  int64_t sum_micros_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TimeHistogram);
+};
+
 class Counter {
  public:
   Counter() : count_(0) {}
@@ -0,0 +1,88 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/instrumentation.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static fml::TimeDelta Micros(int64_t micros) {
+  return fml::TimeDelta::FromMicroseconds(micros);
+}
+
+TEST(TimeHistogram, EmptyHistogramReportsZero) {
+  TimeHistogram histogram;
+  ASSERT_EQ(histogram.count(), 0u);
+  ASSERT_EQ(histogram.Min(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.Max(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.Mean(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.Percentile(50), fml::TimeDelta::Zero());
+}
+
+TEST(TimeHistogram, SmallValuesAreExact) {
+  TimeHistogram histogram;
+  for (int64_t i = 1; i <= 100; i++) {
+    histogram.Record(Micros(i));
+  }
+  ASSERT_EQ(histogram.count(), 100u);
+  ASSERT_EQ(histogram.Min(), Micros(1));
+  ASSERT_EQ(histogram.Max(), Micros(100));
+  ASSERT_EQ(histogram.Percentile(50), Micros(50));
+  ASSERT_EQ(histogram.Percentile(90), Micros(90));
+  ASSERT_EQ(histogram.Percentile(99), Micros(99));
+  ASSERT_EQ(histogram.Percentile(100), Micros(100));
+}
+
+TEST(TimeHistogram, LargeValuesStayWithinRelativeError) {
+  TimeHistogram histogram;
+  // 1ms to 100ms.
+  for (int64_t i = 1; i <= 100; i++) {
+    histogram.Record(Micros(i * 1000));
+  }
+  const std::pair<double, int64_t> expectations[] = {
+      {50, 50000}, {90, 90000}, {99, 99000}, {99.9, 100000}};
+  for (const auto& [percentile, expected] : expectations) {
+    const int64_t actual = histogram.Percentile(percentile).ToMicroseconds();
+    ASSERT_GE(actual, expected) << percentile;
+    ASSERT_LE(actual, expected + expected / 64) << percentile;
+  }
+  ASSERT_EQ(histogram.Percentile(100), Micros(100000));
+  ASSERT_EQ(histogram.Mean(), Micros(50500));
+}
+
+TEST(TimeHistogram, TailIsNotHiddenByAverage) {
+  TimeHistogram histogram;
+  for (int i = 0; i < 990; i++) {
+    histogram.Record(fml::TimeDelta::FromMilliseconds(8));
+  }
+  for (int i = 0; i < 10; i++) {
+    histogram.Record(fml::TimeDelta::FromMilliseconds(100));
+  }
+  ASSERT_LT(histogram.Percentile(99), fml::TimeDelta::FromMilliseconds(9));
+  ASSERT_GE(histogram.Percentile(99.9), fml::TimeDelta::FromMilliseconds(100));
+}
+
+TEST(TimeHistogram, ClampsOutOfRangeValues) {
+  TimeHistogram histogram;
+  histogram.Record(Micros(-5));
+  histogram.Record(fml::TimeDelta::FromSeconds(100000));
+  ASSERT_EQ(histogram.count(), 2u);
+  ASSERT_EQ(histogram.Min(), fml::TimeDelta::Zero());
+  ASSERT_EQ(histogram.Percentile(100), histogram.Max());
+}
+
+TEST(TimeHistogram, Reset) {
+  TimeHistogram histogram;
+  histogram.Record(Micros(42));
+  histogram.Reset();
+  ASSERT_EQ(histogram.count(), 0u);
+  ASSERT_EQ(histogram.Percentile(50), fml::TimeDelta::Zero());
+  histogram.Record(Micros(7));
+  ASSERT_EQ(histogram.Min(), Micros(7));
+  ASSERT_EQ(histogram.Max(), Micros(7));
+}
+
+}  // namespace testing
+}  // namespace flutter
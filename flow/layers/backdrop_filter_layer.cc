@@ -11,6 +11,18 @@ BackdropFilterLayer::BackdropFilterLayer(sk_sp<SkImageFilter> filter)
 
 BackdropFilterLayer::~BackdropFilterLayer() = default;
 
+std::shared_ptr<Layer> BackdropFilterLayer::Clone() const {
+  auto clone = std::make_shared<BackdropFilterLayer>(filter_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
+void BackdropFilterLayer::Preroll(PrerollContext* context,
+                                  const SkMatrix& matrix) {
+  // The filter samples the backdrop beyond the region being painted.
+  context->requires_serial_paint = true;
+  ContainerLayer::Preroll(context, matrix);
+}
+
 void BackdropFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -21,4 +33,9 @@ void BackdropFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+uint64_t BackdropFilterLayer::damage_signature() const {
+  // The output depends on everything painted below this layer.
+  return FrameDamage::kVolatileSignature;
+}
+
 }  // namespace flutter
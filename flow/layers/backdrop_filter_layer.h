@@ -16,8 +16,14 @@ class BackdropFilterLayer : public ContainerLayer {
   BackdropFilterLayer(sk_sp<SkImageFilter> filter);
   ~BackdropFilterLayer() override;
 
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  std::shared_ptr<Layer> Clone() const override;
+
+  uint64_t damage_signature() const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
 
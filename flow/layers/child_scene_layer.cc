@@ -17,6 +17,11 @@ ChildSceneLayer::ChildSceneLayer(zx_koid_t layer_id,
       size_(size),
       hit_testable_(hit_testable) {}
 
+std::shared_ptr<Layer> ChildSceneLayer::Clone() const {
+  return std::make_shared<ChildSceneLayer>(layer_id_, offset_, size_,
+                                           hit_testable_);
+}
+
 void ChildSceneLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   set_needs_system_composite(true);
 }
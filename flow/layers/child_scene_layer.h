@@ -27,6 +27,8 @@ class ChildSceneLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  std::shared_ptr<Layer> Clone() const override;
+
   void UpdateScene(SceneUpdateContext& context) override;
 
  private:
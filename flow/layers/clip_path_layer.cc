@@ -19,6 +19,11 @@ ClipPathLayer::ClipPathLayer(const SkPath& clip_path, Clip clip_behavior)
 
 ClipPathLayer::~ClipPathLayer() = default;
 
+std::shared_ptr<Layer> ClipPathLayer::Clone() const {
+  auto clone = std::make_shared<ClipPathLayer>(clip_path_, clip_behavior_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void ClipPathLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkRect previous_cull_rect = context->cull_rect;
   SkRect clip_path_bounds = clip_path_.getBounds();
@@ -72,4 +77,10 @@ void ClipPathLayer::Paint(PaintContext& context) const {
   }
 }
 
+uint64_t ClipPathLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("ClipPathLayer");
+  signature = FrameDamage::HashPath(signature, clip_path_);
+  return FrameDamage::Hash(signature, clip_behavior_);
+}
+
 }  // namespace flutter
@@ -13,6 +13,11 @@ ClipRectLayer::ClipRectLayer(const SkRect& clip_rect, Clip clip_behavior)
 
 ClipRectLayer::~ClipRectLayer() = default;
 
+std::shared_ptr<Layer> ClipRectLayer::Clone() const {
+  auto clone = std::make_shared<ClipRectLayer>(clip_rect_, clip_behavior_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkRect previous_cull_rect = context->cull_rect;
   if (context->cull_rect.intersect(clip_rect_)) {
@@ -62,4 +67,10 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+uint64_t ClipRectLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("ClipRectLayer");
+  signature = FrameDamage::Hash(signature, clip_rect_);
+  return FrameDamage::Hash(signature, clip_behavior_);
+}
+
 }  // namespace flutter
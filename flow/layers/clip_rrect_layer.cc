@@ -13,6 +13,11 @@ ClipRRectLayer::ClipRRectLayer(const SkRRect& clip_rrect, Clip clip_behavior)
 
 ClipRRectLayer::~ClipRRectLayer() = default;
 
+std::shared_ptr<Layer> ClipRRectLayer::Clone() const {
+  auto clone = std::make_shared<ClipRRectLayer>(clip_rrect_, clip_behavior_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkRect previous_cull_rect = context->cull_rect;
   SkRect clip_rrect_bounds = clip_rrect_.getBounds();
@@ -70,4 +75,15 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+uint64_t ClipRRectLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("ClipRRectLayer");
+  SkVector radii[4];
+  for (int i = 0; i < 4; i++) {
+    radii[i] = clip_rrect_.radii(static_cast<SkRRect::Corner>(i));
+  }
+  signature = FrameDamage::Hash(signature, clip_rrect_.rect());
+  signature = FrameDamage::Hash(signature, radii);
+  return FrameDamage::Hash(signature, clip_behavior_);
+}
+
 }  // namespace flutter
@@ -11,6 +11,11 @@ ColorFilterLayer::ColorFilterLayer(sk_sp<SkColorFilter> filter)
 
 ColorFilterLayer::~ColorFilterLayer() = default;
 
+std::shared_ptr<Layer> ColorFilterLayer::Clone() const {
+  auto clone = std::make_shared<ColorFilterLayer>(filter_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void ColorFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ColorFilterLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -23,4 +28,9 @@ void ColorFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+uint64_t ColorFilterLayer::damage_signature() const {
+  return FrameDamage::HashFlattenable(FrameDamage::Seed("ColorFilterLayer"),
+                                      filter_.get());
+}
+
 }  // namespace flutter
@@ -18,6 +18,10 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  std::shared_ptr<Layer> Clone() const override;
+
+  uint64_t damage_signature() const override;
+
  private:
   sk_sp<SkColorFilter> filter_;
 
@@ -15,6 +15,25 @@ void ContainerLayer::Add(std::shared_ptr<Layer> layer) {
   layers_.push_back(std::move(layer));
 }
 
+void ContainerLayer::AddUnowned(Layer* layer) {
+  // A shared pointer with an empty owner doesn't allocate a control block and
+  // is copied without touching reference counts.
+  Add(std::shared_ptr<Layer>(std::shared_ptr<Layer>(), layer));
+}
+
+bool ContainerLayer::CloneChildren(ContainerLayer* clone) const {
+  // Children are copied even if they are individually owned already, as they
+  // may still refer to unowned layers of an arena.
+  for (const auto& layer : layers_) {
+    auto child = layer->Clone();
+    if (!child) {
+      return false;
+    }
+    clone->Add(std::move(child));
+  }
+  return true;
+}
+
 void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "ContainerLayer::Preroll");
 
@@ -26,6 +45,14 @@ void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 void ContainerLayer::PrerollChildren(PrerollContext* context,
                                      const SkMatrix& child_matrix,
                                      SkRect* child_paint_bounds) {
+  // Children are identified relative to this layer and their position among
+  // their siblings so that moving them around in the tree damages them. The
+  // position doesn't depend on the content of the siblings, so changing one
+  // child doesn't damage the children after it.
+  const uint64_t parent_signature =
+      context->frame_damage ? damage_signature() : 0;
+  uint64_t child_index = 0;
+
   for (auto& layer : layers_) {
     layer->Preroll(context, child_matrix);
 
@@ -33,6 +60,22 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
       set_needs_system_composite(true);
     }
     child_paint_bounds->join(layer->paint_bounds());
+
+    if (context->frame_damage) {
+      uint64_t signature = layer->damage_signature();
+      if (signature != FrameDamage::kVolatileSignature) {
+        signature = FrameDamage::Combine(signature, parent_signature);
+        signature = FrameDamage::Combine(signature, child_index);
+      }
+      // Nothing outside of the cull rect is visible, so changes there don't
+      // damage the frame.
+      SkRect visible_bounds = layer->paint_bounds();
+      if (!visible_bounds.intersect(context->cull_rect)) {
+        visible_bounds.setEmpty();
+      }
+      context->frame_damage->AddLayer(signature, child_matrix, visible_bounds);
+      child_index++;
+    }
   }
 }
 
@@ -42,9 +85,16 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // Intentionally not tracing here as there should be no self-time
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
-    if (layer->needs_painting()) {
-      layer->Paint(context);
+    if (!layer->needs_painting()) {
+      continue;
     }
+    // Skip children that lie entirely outside of the current clip. The paint
+    // bounds are in the coordinate space of the current matrix. Only the leaf
+    // canvas also carries the root surface transformation.
+    if (context.leaf_nodes_canvas->quickReject(layer->paint_bounds())) {
+      continue;
+    }
+    layer->Paint(context);
   }
 }
 
@@ -68,4 +118,10 @@ void ContainerLayer::UpdateSceneChildren(SceneUpdateContext& context) {
 
 #endif  // defined(OS_FUCHSIA)
 
+uint64_t ContainerLayer::damage_signature() const {
+  // A plain container paints nothing itself. Its children are tracked
+  // separately.
+  return FrameDamage::Seed("ContainerLayer");
+}
+
 }  // namespace flutter
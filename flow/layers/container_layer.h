@@ -17,8 +17,14 @@ class ContainerLayer : public Layer {
 
   void Add(std::shared_ptr<Layer> layer);
 
+  // Adds a child whose lifetime is managed elsewhere, typically by the
+  // LayerArena that also owns this layer. The child must outlive this layer.
+  void AddUnowned(Layer* layer);
+
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
+  uint64_t damage_signature() const override;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
@@ -31,6 +37,11 @@ class ContainerLayer : public Layer {
                        SkRect* child_paint_bounds);
   void PaintChildren(PaintContext& context) const;
 
+  // Adds copies of the children of this layer to |clone|, for use by the
+  // |Clone| methods of subclasses. Returns false if one of them cannot be
+  // copied.
+  bool CloneChildren(ContainerLayer* clone) const;
+
 #if defined(OS_FUCHSIA)
   void UpdateSceneChildren(SceneUpdateContext& context);
 #endif  // defined(OS_FUCHSIA)
@@ -0,0 +1,189 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/container_layer.h"
+
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
+
+namespace flutter {
+
+namespace {
+
+// A leaf layer that counts how many times it was painted.
+class CountingLayer : public Layer {
+ public:
+  CountingLayer(const SkRect& bounds, int* paint_count)
+      : bounds_(bounds), paint_count_(paint_count) {}
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    set_paint_bounds(bounds_);
+  }
+
+  void Paint(PaintContext& context) const override { (*paint_count_)++; }
+
+ private:
+  SkRect bounds_;
+  int* paint_count_;
+};
+
+// Prerolls and paints |root| onto a 100x100 canvas. Like a surface does, the
+// root surface transformation is only applied to the leaf nodes canvas.
+void PrerollAndPaint(
+    Layer* root,
+    const SkMatrix& root_surface_transformation = SkMatrix::I()) {
+  const Stopwatch unused_stopwatch;
+  TextureRegistry unused_texture_registry;
+  MutatorsStack unused_stack;
+  PrerollContext preroll_context{
+      nullptr,                   // raster_cache (don't consult the cache)
+      nullptr,                   // gr_context  (used for the raster cache)
+      nullptr,                   // external view embedder
+      unused_stack,              // mutator stack
+      nullptr,                   // SkColorSpace* dst_color_space
+      SkRect::MakeWH(100, 100),  // SkRect cull_rect
+      unused_stopwatch,          // frame time (dont care)
+      unused_stopwatch,          // engine time (dont care)
+      unused_texture_registry,   // texture registry (not supported)
+      false,                     // checkerboard_offscreen_layers
+  };
+  root->Preroll(&preroll_context, root_surface_transformation);
+
+  SkCanvas canvas(100, 100);
+  canvas.setMatrix(root_surface_transformation);
+  SkNWayCanvas internal_nodes_canvas(100, 100);
+  internal_nodes_canvas.addCanvas(&canvas);
+  Layer::PaintContext paint_context = {
+      &internal_nodes_canvas,   // internal_nodes_canvas
+      &canvas,                  // leaf_nodes_canvas
+      nullptr,                  // gr_context
+      nullptr,                  // view_embedder
+      unused_stopwatch,         // frame time (dont care)
+      unused_stopwatch,         // engine time (dont care)
+      unused_texture_registry,  // texture registry (not supported)
+      nullptr,                  // raster cache
+      false                     // checkerboard offscreen layers
+  };
+  if (root->needs_painting()) {
+    root->Paint(paint_context);
+  }
+}
+
+}  // namespace
+
+TEST(ContainerLayer, ChildrenOutsideOfTheCanvasAreNotPainted) {
+  int visible_count = 0;
+  int culled_count = 0;
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  root->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(10, 10, 10, 10),
+                                            &visible_count));
+  root->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(200, 10, 10, 10),
+                                            &culled_count));
+  root->Add(std::make_shared<CountingLayer>(
+      SkRect::MakeXYWH(10, -100, 10, 10), &culled_count));
+
+  PrerollAndPaint(root.get());
+
+  ASSERT_EQ(visible_count, 1);
+  ASSERT_EQ(culled_count, 0);
+}
+
+TEST(ContainerLayer, ChildrenMovedOutsideByTransformAreNotPainted) {
+  int visible_count = 0;
+  int culled_count = 0;
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  auto scrolled = std::make_shared<TransformLayer>(SkMatrix::MakeTrans(0, -50));
+  // Scrolled to y = 10.
+  scrolled->Add(std::make_shared<CountingLayer>(
+      SkRect::MakeXYWH(0, 60, 10, 10), &visible_count));
+  // Scrolled to y = -30.
+  scrolled->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(0, 20, 10, 10),
+                                                &culled_count));
+  root->Add(scrolled);
+
+  PrerollAndPaint(root.get());
+
+  ASSERT_EQ(visible_count, 1);
+  ASSERT_EQ(culled_count, 0);
+}
+
+TEST(ContainerLayer, ChildrenOutsideOfClipRectAreNotPainted) {
+  int visible_count = 0;
+  int culled_count = 0;
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  auto clip = std::make_shared<ClipRectLayer>(SkRect::MakeWH(50, 50),
+                                              Clip::hardEdge);
+  clip->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(10, 10, 10, 10),
+                                            &visible_count));
+  clip->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(60, 60, 10, 10),
+                                            &culled_count));
+  root->Add(clip);
+
+  PrerollAndPaint(root.get());
+
+  ASSERT_EQ(visible_count, 1);
+  ASSERT_EQ(culled_count, 0);
+}
+
+TEST(ContainerLayer, ChildrenOfOffsetOpacityLayerAreCulled) {
+  int visible_count = 0;
+  int culled_count = 0;
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  auto opacity = std::make_shared<OpacityLayer>(128, SkPoint::Make(80, 0));
+  // Offset to x = 90.
+  opacity->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(10, 0, 5, 5),
+                                               &visible_count));
+  // Offset to x = 120.
+  opacity->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(40, 0, 5, 5),
+                                               &culled_count));
+  root->Add(opacity);
+
+  PrerollAndPaint(root.get());
+
+  ASSERT_EQ(visible_count, 1);
+  ASSERT_EQ(culled_count, 0);
+}
+
+TEST(ContainerLayer, ChildrenOutsideOfClippingPhysicalShapeAreNotPainted) {
+  int visible_count = 0;
+  int culled_count = 0;
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  SkPath path;
+  path.addRect(SkRect::MakeWH(50, 50));
+  auto shape = std::make_shared<PhysicalShapeLayer>(
+      SK_ColorRED, SK_ColorBLACK, 1.0f, 1.0f, 0.0f, path, Clip::hardEdge);
+  shape->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(10, 10, 10, 10),
+                                             &visible_count));
+  shape->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(60, 10, 10, 10),
+                                             &culled_count));
+  root->Add(shape);
+
+  PrerollAndPaint(root.get());
+
+  ASSERT_EQ(visible_count, 1);
+  ASSERT_EQ(culled_count, 0);
+}
+
+TEST(ContainerLayer, ChildrenAreCulledInTheRootSurfaceTransformation) {
+  int visible_count = 0;
+  int culled_count = 0;
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  // Scaled to x = 75.
+  root->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(150, 10, 10, 10),
+                                            &visible_count));
+  // Scaled to x = 125.
+  root->Add(std::make_shared<CountingLayer>(SkRect::MakeXYWH(250, 10, 10, 10),
+                                            &culled_count));
+
+  PrerollAndPaint(root.get(), SkMatrix::MakeScale(0.5f));
+
+  ASSERT_EQ(visible_count, 1);
+  ASSERT_EQ(culled_count, 0);
+}
+
+}  // namespace flutter
@@ -28,6 +28,14 @@ uint64_t Layer::NextUniqueID() {
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+std::shared_ptr<Layer> Layer::Clone() const {
+  return nullptr;
+}
+
+uint64_t Layer::damage_signature() const {
+  return FrameDamage::Hash(FrameDamage::Seed("Layer"), unique_id_);
+}
+
 #if defined(OS_FUCHSIA)
 void Layer::UpdateScene(SceneUpdateContext& context) {}
 #endif  // defined(OS_FUCHSIA)
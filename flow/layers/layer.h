@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/frame_damage.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
@@ -58,6 +59,14 @@ struct PrerollContext {
   TextureRegistry& texture_registry;
   const bool checkerboard_offscreen_layers;
   float total_elevation = 0.0f;
+  // When set, every prerolled layer records what it paints so that the
+  // damaged area of the frame can be computed. (See also FrameDamage.)
+  FrameDamage* frame_damage = nullptr;
+  // Set by layers that cannot be painted into separate regions of the frame
+  // concurrently, either because they read back what was painted below them
+  // or because they paint objects that are only usable on the GPU thread.
+  // (See also CompositorContext::SetConcurrentPaintTaskRunner.)
+  bool requires_serial_paint = false;
 };
 
 // Represents a single composited layer. Created on the UI thread but then
@@ -120,6 +129,12 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // Returns an individually owned copy of this layer and its children, made
+  // from the arguments the layer was constructed with. Returns null if the
+  // layer cannot be copied. Used to promote retained layers out of the
+  // LayerArena they were made in. (See also SceneBuilder::addRetained.)
+  virtual std::shared_ptr<Layer> Clone() const;
+
 #if defined(OS_FUCHSIA)
   // Updates the system composited scene.
   virtual void UpdateScene(SceneUpdateContext& context);
@@ -146,6 +161,15 @@ class Layer {
 
   uint64_t unique_id() const { return unique_id_; }
 
+  // Identifies what this layer itself paints, excluding its children and its
+  // position on the surface. Two layers with the same signature painted at the
+  // same bounds produce the same pixels. Used for damage tracking.
+  //
+  // The default is based on the unique id, which only matches across frames
+  // for retained layers. Return FrameDamage::kVolatileSignature for layers
+  // whose output may change while the layer itself does not.
+  virtual uint64_t damage_signature() const;
+
  private:
   ContainerLayer* parent_;
   bool needs_system_composite_;
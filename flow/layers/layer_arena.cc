@@ -0,0 +1,50 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <algorithm>
+
+namespace flutter {
+
+std::shared_ptr<LayerArena> LayerArena::Create() {
+  return std::shared_ptr<LayerArena>(new LayerArena());
+}
+
+LayerArena::LayerArena() = default;
+
+LayerArena::~LayerArena() {
+  TRACE_EVENT0("flutter", "LayerArena::~LayerArena");
+  // Children are made after their parents, so they are destroyed first.
+  for (auto layer = layers_.rbegin(); layer != layers_.rend(); ++layer) {
+    (*layer)->~Layer();
+  }
+}
+
+size_t LayerArena::GetAllocatedBytes() const {
+  size_t bytes = 0;
+  for (const auto& block : blocks_) {
+    bytes += block.size;
+  }
+  return bytes;
+}
+
+void* LayerArena::Allocate(size_t size) {
+  constexpr size_t alignment = alignof(std::max_align_t);
+  size = (size + alignment - 1) & ~(alignment - 1);
+
+  if (blocks_.empty() || blocks_.back().size - block_offset_ < size) {
+    const size_t block_size = std::max(kBlockSize, size);
+    // The memory is not zeroed as layers are constructed into it.
+    blocks_.push_back(
+        {std::unique_ptr<uint8_t[]>(new uint8_t[block_size]), block_size});
+    block_offset_ = 0;
+  }
+
+  void* memory = blocks_.back().memory.get() + block_offset_;
+  block_offset_ += size;
+  return memory;
+}
+
+}  // namespace flutter
@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Owns the layers of a layer tree built in one frame.
+///
+/// Layers are placed in large blocks of memory instead of being allocated one
+/// by one, and are all destroyed together with the arena. A container refers
+/// to children in the same arena via `ContainerLayer::AddUnowned`, which does
+/// not involve reference counting.
+///
+/// Layers that are referenced from outside of the arena, such as the root of
+/// the layer tree or layers the framework may retain for a later frame, are
+/// shared with |Share|. The returned pointer keeps the whole arena alive.
+/// Layers that actually end up in a later frame are promoted out of the arena
+/// by copying them with |Layer::Clone|, so that they don't keep the layers of
+/// their own frame alive.
+///
+/// Arenas are not thread safe. Layers are made on the UI thread, while the
+/// arena may be destroyed on any thread once it is no longer shared.
+///
+class LayerArena : public std::enable_shared_from_this<LayerArena> {
+ public:
+  static std::shared_ptr<LayerArena> Create();
+
+  ~LayerArena();
+
+  template <typename T, typename... Args>
+  T* Make(Args&&... args) {
+    static_assert(std::is_base_of<Layer, T>::value,
+                  "Only layers can be placed in a layer arena.");
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned layers are not supported.");
+    T* layer = new (Allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    layers_.push_back(layer);
+    return layer;
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a pointer to a layer made by this arena that keeps
+  ///             the arena alive for as long as the pointer is.
+  ///
+  template <typename T>
+  std::shared_ptr<T> Share(T* layer) {
+    return std::shared_ptr<T>(shared_from_this(), layer);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether |layer| was shared by this arena.
+  ///
+  template <typename T>
+  bool IsShared(const std::shared_ptr<T>& layer) const {
+    auto self = weak_from_this();
+    return !layer.owner_before(self) && !self.owner_before(layer);
+  }
+
+  size_t GetLayerCount() const { return layers_.size(); }
+
+  size_t GetAllocatedBytes() const;
+
+ private:
+  // Most layer trees fit in a single block.
+  static constexpr size_t kBlockSize = 16 * 1024;
+
+  struct Block {
+    std::unique_ptr<uint8_t[]> memory;
+    size_t size;
+  };
+
+  std::vector<Block> blocks_;
+  size_t block_offset_ = 0;
+  std::vector<Layer*> layers_;
+
+  LayerArena();
+
+  void* Allocate(size_t size);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
@@ -0,0 +1,119 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <vector>
+
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/platform_view_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// A container that records its destruction.
+class TrackedLayer : public ContainerLayer {
+ public:
+  TrackedLayer(int id, std::vector<int>* destroyed)
+      : id_(id), destroyed_(destroyed) {}
+
+  ~TrackedLayer() override { destroyed_->push_back(id_); }
+
+ private:
+  int id_;
+  std::vector<int>* destroyed_;
+};
+
+}  // namespace
+
+TEST(LayerArena, DestroysChildrenBeforeParents) {
+  std::vector<int> destroyed;
+  {
+    auto arena = LayerArena::Create();
+    auto* root = arena->Make<TrackedLayer>(0, &destroyed);
+    auto* child = arena->Make<TrackedLayer>(1, &destroyed);
+    root->AddUnowned(child);
+    child->AddUnowned(arena->Make<TrackedLayer>(2, &destroyed));
+    ASSERT_EQ(arena->GetLayerCount(), 3u);
+    ASSERT_EQ(root->layers()[0].get(), child);
+    ASSERT_EQ(child->parent(), root);
+    ASSERT_TRUE(destroyed.empty());
+  }
+  ASSERT_EQ(destroyed, (std::vector<int>{2, 1, 0}));
+}
+
+TEST(LayerArena, SharedLayersKeepTheArenaAlive) {
+  std::vector<int> destroyed;
+  std::shared_ptr<ContainerLayer> shared;
+  {
+    auto arena = LayerArena::Create();
+    shared = arena->Share<ContainerLayer>(
+        arena->Make<TrackedLayer>(0, &destroyed));
+    ASSERT_TRUE(arena->IsShared(shared));
+  }
+  ASSERT_TRUE(destroyed.empty());
+  shared.reset();
+  ASSERT_EQ(destroyed, (std::vector<int>{0}));
+}
+
+TEST(LayerArena, LayersOfOtherArenasAreNotShared) {
+  std::vector<int> destroyed;
+  auto arena = LayerArena::Create();
+  auto other_arena = LayerArena::Create();
+  auto layer =
+      other_arena->Share(other_arena->Make<TrackedLayer>(0, &destroyed));
+  ASSERT_FALSE(arena->IsShared(layer));
+  ASSERT_FALSE(arena->IsShared(std::make_shared<ContainerLayer>()));
+}
+
+TEST(LayerArena, ClonedLayersOutliveTheArena) {
+  std::shared_ptr<Layer> clone;
+  {
+    auto arena = LayerArena::Create();
+    auto* root = arena->Make<TransformLayer>(SkMatrix::MakeTrans(1, 2));
+    auto* clip =
+        arena->Make<ClipRectLayer>(SkRect::MakeWH(10, 10), Clip::hardEdge);
+    root->AddUnowned(clip);
+    clip->AddUnowned(arena->Make<PlatformViewLayer>(
+        SkPoint::Make(0, 0), SkSize::Make(5, 5), 1));
+    clone = root->Clone();
+    ASSERT_TRUE(clone);
+    ASSERT_NE(clone.get(), root);
+    ASSERT_FALSE(arena->IsShared(clone));
+  }
+
+  auto* root_clone = static_cast<ContainerLayer*>(clone.get());
+  ASSERT_EQ(root_clone->layers().size(), 1u);
+  auto* clip_clone =
+      static_cast<ContainerLayer*>(root_clone->layers()[0].get());
+  ASSERT_EQ(clip_clone->parent(), root_clone);
+  ASSERT_EQ(clip_clone->layers().size(), 1u);
+  // Every copy is individually owned.
+  ASSERT_EQ(root_clone->layers()[0].use_count(), 1);
+  ASSERT_EQ(clip_clone->layers()[0].use_count(), 1);
+}
+
+TEST(LayerArena, LayersWithUncopyableChildrenAreNotCloned) {
+  std::vector<int> destroyed;
+  auto arena = LayerArena::Create();
+  auto* root = arena->Make<TransformLayer>(SkMatrix::I());
+  root->AddUnowned(arena->Make<TrackedLayer>(0, &destroyed));
+  ASSERT_EQ(root->Clone(), nullptr);
+}
+
+TEST(LayerArena, GrowsToFitAllLayers) {
+  std::vector<int> destroyed;
+  auto arena = LayerArena::Create();
+  const size_t layer_count = 1000;
+  for (size_t i = 0; i < layer_count; i++) {
+    arena->Make<TrackedLayer>(i, &destroyed);
+  }
+  ASSERT_GE(arena->GetAllocatedBytes(), layer_count * sizeof(TrackedLayer));
+}
+
+}  // namespace flutter
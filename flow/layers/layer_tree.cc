@@ -4,9 +4,18 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "flutter/flow/layers/layer.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkPixmap.h"
 #include "third_party/skia/include/utils/SkNWayCanvas.h"
 
 namespace flutter {
@@ -15,13 +24,16 @@ LayerTree::LayerTree()
     : frame_size_{},
       rasterizer_tracing_threshold_(0),
       checkerboard_raster_cache_images_(false),
-      checkerboard_offscreen_layers_(false) {}
+      checkerboard_offscreen_layers_(false),
+      requires_serial_paint_(false) {}
 
 LayerTree::~LayerTree() = default;
 
-void LayerTree::RecordBuildTime(fml::TimePoint start) {
+void LayerTree::RecordBuildTime(fml::TimePoint start,
+                                fml::TimePoint target_time) {
   build_start_ = start;
   build_finish_ = fml::TimePoint::Now();
+  target_time_ = target_time;
 }
 
 void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
@@ -43,8 +55,16 @@ void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       frame.context().ui_time(),
       frame.context().texture_registry(),
       checkerboard_offscreen_layers_};
+  context.frame_damage = frame.frame_damage();
 
   root_layer_->Preroll(&context, frame.root_surface_transformation());
+  requires_serial_paint_ = context.requires_serial_paint;
+
+  if (context.frame_damage) {
+    context.frame_damage->AddLayer(root_layer_->damage_signature(),
+                                   frame.root_surface_transformation(),
+                                   root_layer_->paint_bounds());
+  }
 }
 
 #if defined(OS_FUCHSIA)
@@ -75,6 +95,10 @@ void LayerTree::UpdateScene(SceneUpdateContext& context,
 void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
                       bool ignore_raster_cache) const {
   TRACE_EVENT0("flutter", "LayerTree::Paint");
+  if (PaintConcurrently(frame, ignore_raster_cache)) {
+    return;
+  }
+
   SkISize canvas_size = frame.canvas()->getBaseLayerSize();
   SkNWayCanvas internal_nodes_canvas(canvas_size.width(), canvas_size.height());
   internal_nodes_canvas.addCanvas(frame.canvas());
@@ -100,6 +124,120 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
     root_layer_->Paint(context);
 }
 
+// Bands smaller than this are not worth the cost of painting the layer tree
+// once more.
+static constexpr int kMinPaintBandHeight = 64;
+
+bool LayerTree::PaintConcurrently(CompositorContext::ScopedFrame& frame,
+                                  bool ignore_raster_cache) const {
+  const auto& task_runner = frame.context().concurrent_paint_task_runner();
+  if (!task_runner || requires_serial_paint_ || frame.gr_context() ||
+      frame.view_embedder() || !root_layer_->needs_painting()) {
+    return false;
+  }
+
+  const RasterCache* raster_cache =
+      ignore_raster_cache ? nullptr : &frame.context().raster_cache();
+  // Paint times measured for parts of a layer are meaningless to the
+  // adaptive raster cache, and recording them is not thread safe.
+  if (raster_cache && raster_cache->is_adaptive()) {
+    return false;
+  }
+
+  // Each band is painted directly into its rows of the backing store.
+  SkCanvas* canvas = frame.canvas();
+  SkPixmap pixels;
+  if (!canvas->peekPixels(&pixels) || !canvas->isClipRect()) {
+    return false;
+  }
+
+  const size_t band_count =
+      std::min<size_t>(frame.context().max_paint_band_count(),
+                       pixels.height() / kMinPaintBandHeight);
+  if (band_count < 2) {
+    return false;
+  }
+
+  TRACE_EVENT1("flutter", "LayerTree::PaintConcurrently", "BandCount",
+               std::to_string(band_count).c_str());
+
+  const SkMatrix matrix = canvas->getTotalMatrix();
+  const SkIRect clip = canvas->getDeviceClipBounds();
+  const int band_height =
+      (pixels.height() + static_cast<int>(band_count) - 1) / band_count;
+
+  auto paint_band = [&](size_t index) {
+    TRACE_EVENT0("flutter", "LayerTree::PaintBand");
+    const int top = static_cast<int>(index) * band_height;
+    const SkIRect band = SkIRect::MakeLTRB(
+        0, top, pixels.width(), std::min(top + band_height, pixels.height()));
+    SkIRect band_clip = band;
+    SkPixmap band_pixels;
+    if (!band_clip.intersect(clip) ||
+        !pixels.extractSubset(&band_pixels, band)) {
+      return;
+    }
+
+    auto band_canvas = SkCanvas::MakeRasterDirect(
+        band_pixels.info(), band_pixels.writable_addr(),
+        band_pixels.rowBytes());
+    if (!band_canvas) {
+      return;
+    }
+
+    // The band's position, clip and the root matrix are applied through the
+    // internal nodes canvas so that it shares the state of the band canvas.
+    SkNWayCanvas internal_nodes_canvas(pixels.width(), pixels.height());
+    internal_nodes_canvas.addCanvas(band_canvas.get());
+    internal_nodes_canvas.translate(0, -top);
+    internal_nodes_canvas.clipRect(SkRect::Make(band_clip));
+    internal_nodes_canvas.concat(matrix);
+    Layer::PaintContext context = {
+        (SkCanvas*)&internal_nodes_canvas,
+        band_canvas.get(),
+        nullptr,
+        nullptr,
+        frame.context().raster_time(),
+        frame.context().ui_time(),
+        frame.context().texture_registry(),
+        raster_cache,
+        checkerboard_offscreen_layers_};
+    root_layer_->Paint(context);
+  };
+
+  // Bands are claimed by whichever thread gets to them first, including the
+  // calling thread. This keeps the frame from stalling when the workers are
+  // busy. The state is shared with the tasks as they may only start running
+  // after all bands were painted.
+  struct Bands {
+    explicit Bands(size_t count) : count(count), latch(count) {}
+
+    const size_t count;
+    std::atomic<size_t> next{0};
+    fml::CountDownLatch latch;
+    std::function<void(size_t)> paint;
+
+    void PaintUnclaimed() {
+      for (size_t index = next++; index < count; index = next++) {
+        paint(index);
+        latch.CountDown();
+      }
+    }
+  };
+  auto bands = std::make_shared<Bands>(band_count);
+  bands->paint = paint_band;
+
+  std::vector<fml::closure> tasks;
+  for (size_t i = 1; i < band_count; i++) {
+    tasks.push_back([bands]() { bands->PaintUnclaimed(); });
+  }
+  task_runner->PostTasks(std::move(tasks), fml::ConcurrentTaskPriority::kHigh);
+
+  bands->PaintUnclaimed();
+  bands->latch.Wait();
+  return true;
+}
+
 sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
   TRACE_EVENT0("flutter", "LayerTree::Flatten");
 
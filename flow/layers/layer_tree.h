@@ -47,10 +47,13 @@ class LayerTree {
 
   void set_frame_size(const SkISize& frame_size) { frame_size_ = frame_size; }
 
-  void RecordBuildTime(fml::TimePoint begin_start);
+  void RecordBuildTime(fml::TimePoint begin_start, fml::TimePoint target_time);
   fml::TimePoint build_start() const { return build_start_; }
   fml::TimePoint build_finish() const { return build_finish_; }
   fml::TimeDelta build_time() const { return build_finish_ - build_start_; }
+  // The time by which the vsync that started this frame expected it to be
+  // presented.
+  fml::TimePoint target_time() const { return target_time_; }
 
   // The number of frame intervals missed after which the compositor must
   // trace the rasterized picture to a trace file. Specify 0 to disable all
@@ -76,9 +79,19 @@ class LayerTree {
   std::shared_ptr<Layer> root_layer_;
   fml::TimePoint build_start_;
   fml::TimePoint build_finish_;
+  fml::TimePoint target_time_;
   uint32_t rasterizer_tracing_threshold_;
   bool checkerboard_raster_cache_images_;
   bool checkerboard_offscreen_layers_;
+  // Whether the last preroll found layers that must not be painted
+  // concurrently. (See also PrerollContext::requires_serial_paint.)
+  bool requires_serial_paint_;
+
+  // Paints the tree in horizontal bands on the concurrent paint task runner
+  // of the compositor context. Returns false without painting anything if the
+  // frame cannot be painted concurrently.
+  bool PaintConcurrently(CompositorContext::ScopedFrame& frame,
+                         bool ignore_raster_cache) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(LayerTree);
 };
@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_tree.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+namespace {
+
+// A leaf layer that draws an anti-aliased circle and counts how many times it
+// was painted.
+class CircleLayer : public Layer {
+ public:
+  CircleLayer(const SkRect& bounds,
+              SkColor color,
+              bool requires_serial_paint,
+              std::atomic<int>* paint_count)
+      : bounds_(bounds),
+        color_(color),
+        requires_serial_paint_(requires_serial_paint),
+        paint_count_(paint_count) {}
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    if (requires_serial_paint_) {
+      context->requires_serial_paint = true;
+    }
+    set_paint_bounds(bounds_);
+  }
+
+  void Paint(PaintContext& context) const override {
+    (*paint_count_)++;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(color_);
+    context.leaf_nodes_canvas->drawOval(bounds_, paint);
+  }
+
+ private:
+  SkRect bounds_;
+  SkColor color_;
+  bool requires_serial_paint_;
+  std::atomic<int>* paint_count_;
+};
+
+std::unique_ptr<LayerTree> MakeLayerTree(bool requires_serial_paint,
+                                         std::atomic<int>* paint_count) {
+  auto root = std::make_shared<TransformLayer>(SkMatrix::MakeScale(1.5f));
+  root->Add(std::make_shared<CircleLayer>(SkRect::MakeXYWH(10, 10, 300, 200),
+                                          SK_ColorRED, false, paint_count));
+  root->Add(std::make_shared<CircleLayer>(SkRect::MakeXYWH(90, 60, 150, 250),
+                                          SK_ColorBLUE, requires_serial_paint,
+                                          paint_count));
+  auto layer_tree = std::make_unique<LayerTree>();
+  layer_tree->set_root_layer(root);
+  layer_tree->set_frame_size(SkISize::Make(500, 500));
+  return layer_tree;
+}
+
+sk_sp<SkSurface> Raster(CompositorContext& compositor_context,
+                        LayerTree& layer_tree) {
+  auto surface = SkSurface::MakeRasterN32Premul(500, 500);
+  const SkMatrix root_surface_transformation = SkMatrix::I();
+  auto frame = compositor_context.AcquireFrame(
+      nullptr, surface->getCanvas(), nullptr, root_surface_transformation,
+      false);
+  frame->Raster(layer_tree, true);
+  return surface;
+}
+
+bool HaveSamePixels(SkSurface* lhs, SkSurface* rhs) {
+  SkPixmap lhs_pixels;
+  SkPixmap rhs_pixels;
+  if (!lhs->peekPixels(&lhs_pixels) || !rhs->peekPixels(&rhs_pixels)) {
+    return false;
+  }
+  for (int y = 0; y < lhs_pixels.height(); y++) {
+    if (memcmp(lhs_pixels.addr(0, y), rhs_pixels.addr(0, y),
+               lhs_pixels.info().minRowBytes()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(LayerTree, ConcurrentPaintMatchesSerialPaint) {
+  std::atomic<int> paint_count{0};
+  auto layer_tree = MakeLayerTree(false, &paint_count);
+
+  CompositorContext serial_context;
+  auto serial_surface = Raster(serial_context, *layer_tree);
+  ASSERT_EQ(paint_count, 2);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  CompositorContext concurrent_context;
+  concurrent_context.SetConcurrentPaintTaskRunner(loop->GetTaskRunner(), 8);
+  paint_count = 0;
+  auto concurrent_surface = Raster(concurrent_context, *layer_tree);
+
+  // Every band paints the layers that intersect it.
+  ASSERT_GT(paint_count, 2);
+  ASSERT_TRUE(HaveSamePixels(serial_surface.get(), concurrent_surface.get()));
+}
+
+TEST(LayerTree, ConcurrentPaintPaintsLayersInLaterBands) {
+  std::atomic<int> paint_count{0};
+  auto root = std::make_shared<TransformLayer>(SkMatrix::I());
+  root->Add(std::make_shared<CircleLayer>(SkRect::MakeXYWH(10, 440, 100, 50),
+                                          SK_ColorRED, false, &paint_count));
+  LayerTree layer_tree;
+  layer_tree.set_root_layer(root);
+  layer_tree.set_frame_size(SkISize::Make(500, 500));
+
+  CompositorContext serial_context;
+  auto serial_surface = Raster(serial_context, layer_tree);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  CompositorContext concurrent_context;
+  concurrent_context.SetConcurrentPaintTaskRunner(loop->GetTaskRunner(), 8);
+  paint_count = 0;
+  auto concurrent_surface = Raster(concurrent_context, layer_tree);
+
+  // Only the last band intersects the layer.
+  ASSERT_EQ(paint_count, 1);
+  SkPixmap pixels;
+  ASSERT_TRUE(concurrent_surface->peekPixels(&pixels));
+  ASSERT_EQ(pixels.getColor(60, 465), SK_ColorRED);
+  ASSERT_TRUE(HaveSamePixels(serial_surface.get(), concurrent_surface.get()));
+}
+
+TEST(LayerTree, LayersCanRequireSerialPaint) {
+  std::atomic<int> paint_count{0};
+  auto layer_tree = MakeLayerTree(true, &paint_count);
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  CompositorContext compositor_context;
+  compositor_context.SetConcurrentPaintTaskRunner(loop->GetTaskRunner(), 8);
+  Raster(compositor_context, *layer_tree);
+  ASSERT_EQ(paint_count, 2);
+}
+
+}  // namespace flutter
@@ -5,6 +5,7 @@
 #include "flutter/flow/layers/opacity_layer.h"
 
 #include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/time/time_point.h"
 
 namespace flutter {
 
@@ -13,6 +14,11 @@ OpacityLayer::OpacityLayer(int alpha, const SkPoint& offset)
 
 OpacityLayer::~OpacityLayer() = default;
 
+std::shared_ptr<Layer> OpacityLayer::Clone() const {
+  auto clone = std::make_shared<OpacityLayer>(alpha_, offset_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void OpacityLayer::EnsureSingleChild() {
   FML_DCHECK(layers().size() > 0);  // OpacityLayer should never be a leaf
 
@@ -35,12 +41,17 @@ void OpacityLayer::EnsureSingleChild() {
 
 void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   EnsureSingleChild();
+  // Paint translates by |offset_| in the local space, before |matrix|.
   SkMatrix child_matrix = matrix;
-  child_matrix.postTranslate(offset_.fX, offset_.fY);
+  child_matrix.preTranslate(offset_.fX, offset_.fY);
   context->mutators_stack.PushTransform(
       SkMatrix::MakeTrans(offset_.fX, offset_.fY));
   context->mutators_stack.PushOpacity(alpha_);
+  // The children are painted in a coordinate space offset by |offset_|.
+  SkRect previous_cull_rect = context->cull_rect;
+  context->cull_rect.offset(-offset_.fX, -offset_.fY);
   ContainerLayer::Preroll(context, child_matrix);
+  context->cull_rect = previous_cull_rect;
   context->mutators_stack.Pop();
   context->mutators_stack.Pop();
   set_paint_bounds(paint_bounds().makeOffset(offset_.fX, offset_.fY));
@@ -79,12 +90,23 @@ void OpacityLayer::Paint(PaintContext& context) const {
   // traversal. To make sure we paint on the right canvas, when the embedded
   // platform views preview is enabled (context.view_embedded is not null) we
   // don't use the cache.
-  if (context.view_embedder == nullptr && context.raster_cache) {
-    const SkMatrix& ctm = context.leaf_nodes_canvas->getTotalMatrix();
-    RasterCacheResult child_cache =
-        context.raster_cache->Get(layers()[0].get(), ctm);
+  const RasterCache* cache =
+      context.view_embedder == nullptr ? context.raster_cache : nullptr;
+  Layer* child = layers()[0].get();
+  // Copied as painting may push onto the save stack of the canvas.
+  const SkMatrix ctm = context.leaf_nodes_canvas->getTotalMatrix();
+  const bool measure = cache && cache->is_adaptive();
+  const fml::TimePoint start =
+      measure ? fml::TimePoint::Now() : fml::TimePoint();
+
+  if (cache) {
+    RasterCacheResult child_cache = cache->Get(child, ctm);
     if (child_cache.is_valid()) {
       child_cache.draw(*context.leaf_nodes_canvas, &paint);
+      if (measure) {
+        cache->RecordPaintTime(child, ctm, true,
+                               fml::TimePoint::Now() - start);
+      }
       return;
     }
   }
@@ -103,9 +125,21 @@ void OpacityLayer::Paint(PaintContext& context) const {
       .makeOffset(-offset_.fX, -offset_.fY)
       .roundOut(&saveLayerBounds);
 
-  Layer::AutoSaveLayer save_layer =
-      Layer::AutoSaveLayer::Create(context, saveLayerBounds, &paint);
-  PaintChildren(context);
+  {
+    Layer::AutoSaveLayer save_layer =
+        Layer::AutoSaveLayer::Create(context, saveLayerBounds, &paint);
+    PaintChildren(context);
+  }
+
+  if (measure) {
+    cache->RecordPaintTime(child, ctm, false, fml::TimePoint::Now() - start);
+  }
+}
+
+uint64_t OpacityLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("OpacityLayer");
+  signature = FrameDamage::Hash(signature, alpha_);
+  return FrameDamage::Hash(signature, offset_);
 }
 
 }  // namespace flutter
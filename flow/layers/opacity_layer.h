@@ -32,12 +32,9 @@ class OpacityLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
-  // TODO(chinmaygarde): Once SCN-139 is addressed, introduce a new node in the
-  // session scene hierarchy.
+  std::shared_ptr<Layer> Clone() const override;
 
- private:
-  int alpha_;
-  SkPoint offset_;
+  uint64_t damage_signature() const override;
 
   // Restructure (if necessary) OpacityLayer to have only one child.
   //
@@ -47,8 +44,19 @@ class OpacityLayer : public ContainerLayer {
   // If there are multiple children, this creates a new identity TransformLayer,
   // sets all children to be the TransformLayer's children, and sets that
   // TransformLayer as the single child of this OpacityLayer.
+  //
+  // Called by |Preroll|. Builders of retained layers call it as soon as the
+  // children are complete so that the layer isn't modified on the GPU thread
+  // while it may be copied on the UI thread. (See also |Layer::Clone|.)
   void EnsureSingleChild();
 
+  // TODO(chinmaygarde): Once SCN-139 is addressed, introduce a new node in the
+  // session scene hierarchy.
+
+ private:
+  int alpha_;
+  SkPoint offset_;
+
   FML_DISALLOW_COPY_AND_ASSIGN(OpacityLayer);
 };
 
@@ -70,6 +70,20 @@ PerformanceOverlayLayer::PerformanceOverlayLayer(uint64_t options,
   }
 }
 
+std::shared_ptr<Layer> PerformanceOverlayLayer::Clone() const {
+  auto clone = std::make_shared<PerformanceOverlayLayer>(
+      options_, font_path_.empty() ? nullptr : font_path_.c_str());
+  // The bounds are set by whoever made the layer rather than in |Preroll|.
+  clone->set_paint_bounds(paint_bounds());
+  return clone;
+}
+
+void PerformanceOverlayLayer::Preroll(PrerollContext* context,
+                                      const SkMatrix& matrix) {
+  // The statistics cache their visualizations while painting.
+  context->requires_serial_paint = true;
+}
+
 void PerformanceOverlayLayer::Paint(PaintContext& context) const {
   const int padding = 8;
 
@@ -94,4 +108,8 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
                      options_ & kDisplayEngineStatistics, "UI", font_path_);
 }
 
+uint64_t PerformanceOverlayLayer::damage_signature() const {
+  return FrameDamage::kVolatileSignature;
+}
+
 }  // namespace flutter
@@ -50,12 +50,26 @@ PhysicalShapeLayer::PhysicalShapeLayer(SkColor color,
 
 PhysicalShapeLayer::~PhysicalShapeLayer() = default;
 
+std::shared_ptr<Layer> PhysicalShapeLayer::Clone() const {
+  auto clone = std::make_shared<PhysicalShapeLayer>(
+      color_, shadow_color_, device_pixel_ratio_, viewport_depth_, elevation_,
+      path_, clip_behavior_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void PhysicalShapeLayer::Preroll(PrerollContext* context,
                                  const SkMatrix& matrix) {
   context->total_elevation += elevation_;
   total_elevation_ = context->total_elevation;
-  SkRect child_paint_bounds;
-  PrerollChildren(context, matrix, &child_paint_bounds);
+  SkRect child_paint_bounds = SkRect::MakeEmpty();
+  SkRect previous_cull_rect = context->cull_rect;
+  // Children are clipped to the shape unless clipping is disabled, so the
+  // ones outside of it are culled just like for the clip layers.
+  if (clip_behavior_ == Clip::none ||
+      context->cull_rect.intersect(path_.getBounds())) {
+    PrerollChildren(context, matrix, &child_paint_bounds);
+  }
+  context->cull_rect = previous_cull_rect;
   context->total_elevation -= elevation_;
 
   if (elevation_ == 0) {
@@ -214,4 +228,14 @@ void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
       dpr * kLightRadius, ambientColor, spotColor, flags);
 }
 
+uint64_t PhysicalShapeLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("PhysicalShapeLayer");
+  signature = FrameDamage::Hash(signature, color_);
+  signature = FrameDamage::Hash(signature, shadow_color_);
+  signature = FrameDamage::Hash(signature, device_pixel_ratio_);
+  signature = FrameDamage::Hash(signature, elevation_);
+  signature = FrameDamage::HashPath(signature, path_);
+  return FrameDamage::Hash(signature, clip_behavior_);
+}
+
 }  // namespace flutter
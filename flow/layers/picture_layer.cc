@@ -5,6 +5,7 @@
 #include "flutter/flow/layers/picture_layer.h"
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 
 namespace flutter {
 
@@ -19,10 +20,20 @@ PictureLayer::PictureLayer(const SkPoint& offset,
 
 PictureLayer::~PictureLayer() = default;
 
+std::shared_ptr<Layer> PictureLayer::Clone() const {
+  return std::make_shared<PictureLayer>(offset_, picture_.Clone(),
+                                        is_complex_, will_change_);
+}
+
 void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkPicture* sk_picture = picture();
 
-  if (auto* cache = context->raster_cache) {
+  SkRect bounds = sk_picture->cullRect().makeOffset(offset_.x(), offset_.y());
+
+  // Pictures outside of the cull rect are not painted, so there is no point
+  // in rasterizing them into the cache.
+  auto* cache = context->raster_cache;
+  if (cache && SkRect::Intersects(context->cull_rect, bounds)) {
     SkMatrix ctm = matrix;
     ctm.postTranslate(offset_.x(), offset_.y());
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
@@ -32,7 +43,6 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
                    context->dst_color_space, is_complex_, will_change_);
   }
 
-  SkRect bounds = sk_picture->cullRect().makeOffset(offset_.x(), offset_.y());
   set_paint_bounds(bounds);
 }
 
@@ -48,15 +58,35 @@ void PictureLayer::Paint(PaintContext& context) const {
       context.leaf_nodes_canvas->getTotalMatrix()));
 #endif
 
-  if (context.raster_cache) {
-    const SkMatrix& ctm = context.leaf_nodes_canvas->getTotalMatrix();
-    RasterCacheResult result = context.raster_cache->Get(*picture(), ctm);
+  const RasterCache* cache = context.raster_cache;
+  // Copied as painting may push onto the save stack of the canvas.
+  const SkMatrix ctm = context.leaf_nodes_canvas->getTotalMatrix();
+  const bool measure = cache && cache->is_adaptive();
+  const fml::TimePoint start =
+      measure ? fml::TimePoint::Now() : fml::TimePoint();
+
+  if (cache) {
+    RasterCacheResult result = cache->Get(*picture(), ctm);
     if (result.is_valid()) {
       result.draw(*context.leaf_nodes_canvas);
+      if (measure) {
+        cache->RecordPaintTime(*picture(), ctm, true,
+                               fml::TimePoint::Now() - start);
+      }
       return;
     }
   }
   context.leaf_nodes_canvas->drawPicture(picture());
+  if (measure) {
+    cache->RecordPaintTime(*picture(), ctm, false,
+                           fml::TimePoint::Now() - start);
+  }
+}
+
+uint64_t PictureLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("PictureLayer");
+  signature = FrameDamage::Hash(signature, picture()->uniqueID());
+  return FrameDamage::Hash(signature, offset_);
 }
 
 }  // namespace flutter
@@ -27,6 +27,10 @@ class PictureLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  std::shared_ptr<Layer> Clone() const override;
+
+  uint64_t damage_signature() const override;
+
  private:
   SkPoint offset_;
   // Even though pictures themselves are not GPU resources, they may reference
@@ -13,6 +13,10 @@ PlatformViewLayer::PlatformViewLayer(const SkPoint& offset,
 
 PlatformViewLayer::~PlatformViewLayer() = default;
 
+std::shared_ptr<Layer> PlatformViewLayer::Clone() const {
+  return std::make_shared<PlatformViewLayer>(offset_, size_, view_id_);
+}
+
 void PlatformViewLayer::Preroll(PrerollContext* context,
                                 const SkMatrix& matrix) {
   set_paint_bounds(SkRect::MakeXYWH(offset_.x(), offset_.y(), size_.width(),
@@ -42,4 +46,8 @@ void PlatformViewLayer::Paint(PaintContext& context) const {
   SkCanvas* canvas = context.view_embedder->CompositeEmbeddedView(view_id_);
   context.leaf_nodes_canvas = canvas;
 }
+uint64_t PlatformViewLayer::damage_signature() const {
+  return FrameDamage::kVolatileSignature;
+}
+
 }  // namespace flutter
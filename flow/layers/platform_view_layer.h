@@ -19,6 +19,10 @@ class PlatformViewLayer : public Layer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  std::shared_ptr<Layer> Clone() const override;
+
+  uint64_t damage_signature() const override;
+
  private:
   SkPoint offset_;
   SkSize size_;
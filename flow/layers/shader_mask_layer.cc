@@ -13,6 +13,12 @@ ShaderMaskLayer::ShaderMaskLayer(sk_sp<SkShader> shader,
 
 ShaderMaskLayer::~ShaderMaskLayer() = default;
 
+std::shared_ptr<Layer> ShaderMaskLayer::Clone() const {
+  auto clone =
+      std::make_shared<ShaderMaskLayer>(shader_, mask_rect_, blend_mode_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void ShaderMaskLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ShaderMaskLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -29,4 +35,11 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+uint64_t ShaderMaskLayer::damage_signature() const {
+  uint64_t signature = FrameDamage::Seed("ShaderMaskLayer");
+  signature = FrameDamage::HashFlattenable(signature, shader_.get());
+  signature = FrameDamage::Hash(signature, mask_rect_);
+  return FrameDamage::Hash(signature, blend_mode_);
+}
+
 }  // namespace flutter
@@ -16,7 +16,13 @@ TextureLayer::TextureLayer(const SkPoint& offset,
 
 TextureLayer::~TextureLayer() = default;
 
+std::shared_ptr<Layer> TextureLayer::Clone() const {
+  return std::make_shared<TextureLayer>(offset_, size_, texture_id_, freeze_);
+}
+
 void TextureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  // Textures may be backed by objects bound to the GPU thread.
+  context->requires_serial_paint = true;
   set_paint_bounds(SkRect::MakeXYWH(offset_.x(), offset_.y(), size_.width(),
                                     size_.height()));
 }
@@ -31,4 +37,9 @@ void TextureLayer::Paint(PaintContext& context) const {
                  context.gr_context);
 }
 
+uint64_t TextureLayer::damage_signature() const {
+  // External textures may be updated without a new layer tree.
+  return FrameDamage::kVolatileSignature;
+}
+
 }  // namespace flutter
@@ -26,6 +26,11 @@ TransformLayer::TransformLayer(const SkMatrix& transform)
 
 TransformLayer::~TransformLayer() = default;
 
+std::shared_ptr<Layer> TransformLayer::Clone() const {
+  auto clone = std::make_shared<TransformLayer>(transform_);
+  return CloneChildren(clone.get()) ? clone : nullptr;
+}
+
 void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkMatrix child_matrix;
   child_matrix.setConcat(matrix, transform_);
@@ -71,4 +76,9 @@ void TransformLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+uint64_t TransformLayer::damage_signature() const {
+  return FrameDamage::HashMatrix(FrameDamage::Seed("TransformLayer"),
+                                 transform_);
+}
+
 }  // namespace flutter
@@ -4,11 +4,13 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -37,9 +39,12 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 }
 
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_cache_limit_per_frame)
+                         size_t picture_cache_limit_per_frame,
+                         size_t max_bytes)
     : access_threshold_(access_threshold),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
+      max_bytes_(max_bytes),
+      concurrent_state_(std::make_shared<ConcurrentRasterizationState>()),
       checkerboard_images_(false),
       weak_factory_(this) {}
 
@@ -148,14 +153,91 @@ static inline size_t ClampSize(size_t value, size_t min, size_t max) {
   return value;
 }
 
+void RasterCache::TouchEntry(Entry& entry) {
+  if (entry.used_this_frame) {
+    return;
+  }
+  entry.used_this_frame = true;
+  entry.last_used_frame = current_frame_;
+  if (entry.frames_used < kMaxFramesUsedWeight) {
+    entry.frames_used++;
+  }
+}
+
+void RasterCache::RasterTime::AddSample(fml::TimeDelta sample) {
+  // Recent samples weigh more so that entries adapt to changes in their
+  // surroundings, such as other layers competing for the GPU.
+  average = samples == 0 ? sample : average + (sample - average) / 4;
+  samples++;
+}
+
+bool RasterCache::HasPictureRasterizationBudget() const {
+  if (concurrent_task_runner_) {
+    // Dispatching a rasterization takes no time on this thread, so it cannot
+    // be charged against the time budget. The number of rasterizations that
+    // are dispatched per frame and that are in flight is bounded instead.
+    return picture_cached_this_frame_ < picture_cache_limit_per_frame_ &&
+           GetPendingRasterizationCount() < picture_cache_limit_per_frame_;
+  }
+  if (picture_rasterization_budget_per_frame_ > fml::TimeDelta::Zero()) {
+    return picture_rasterization_time_this_frame_ <
+           picture_rasterization_budget_per_frame_;
+  }
+  return picture_cached_this_frame_ < picture_cache_limit_per_frame_;
+}
+
+bool RasterCache::ShouldPromote(const Entry& entry) const {
+  if (entry.paint_time.samples == 0 ||
+      current_frame_ < entry.demoted_until_frame) {
+    return false;
+  }
+
+  // Entries that were never drawn from the cache are assumed to draw as fast
+  // as the average cached image.
+  const RasterTime& cached_paint_time = entry.cached_paint_time.samples > 0
+                                            ? entry.cached_paint_time
+                                            : cached_paint_time_;
+  const fml::TimeDelta saving_per_frame =
+      entry.paint_time.average - cached_paint_time.average;
+  if (saving_per_frame <= fml::TimeDelta::Zero()) {
+    return false;
+  }
+
+  // Rasterizing an entry for the first time costs about as much as painting
+  // it directly, plus the cost of the offscreen surface.
+  const fml::TimeDelta rasterize_time = entry.rasterize_time.samples > 0
+                                            ? entry.rasterize_time.average
+                                            : entry.paint_time.average;
+
+  // An entry is expected to stay on screen for about as many frames as it
+  // already has been.
+  return saving_per_frame * entry.frames_used > rasterize_time;
+}
+
+void RasterCache::TraceDecision(const char* name, const Entry& entry) {
+  FML_TRACE_EVENT(
+      "flutter", name,                                                   //
+      "PaintMicros", entry.paint_time.average.ToMicroseconds(),          //
+      "CachedPaintMicros",                                               //
+      entry.cached_paint_time.average.ToMicroseconds(),                  //
+      "RasterizeMicros", entry.rasterize_time.average.ToMicroseconds(),  //
+      "FramesUsed", entry.frames_used,                                   //
+      "DemotionCount", entry.demotion_count                              //
+  );
+}
+
 void RasterCache::Prepare(PrerollContext* context,
                           Layer* layer,
                           const SkMatrix& ctm) {
   LayerRasterCacheKey cache_key(layer->unique_id(), ctm);
   Entry& entry = layer_cache_[cache_key];
   entry.access_count = ClampSize(entry.access_count + 1, 0, access_threshold_);
-  entry.used_this_frame = true;
+  TouchEntry(entry);
   if (!entry.image.is_valid()) {
+    if (adaptive_ && !ShouldPromote(entry)) {
+      return;
+    }
+    const fml::TimePoint start = fml::TimePoint::Now();
     entry.image = Rasterize(context->gr_context, ctm, context->dst_color_space,
                             checkerboard_images_, layer->paint_bounds(),
                             [layer, context](SkCanvas* canvas) {
@@ -177,6 +259,10 @@ void RasterCache::Prepare(PrerollContext* context,
                                 layer->Paint(paintContext);
                               }
                             });
+    entry.rasterize_time.AddSample(fml::TimePoint::Now() - start);
+    if (adaptive_) {
+      TraceDecision("RasterCachePromoteLayer", entry);
+    }
   }
 }
 
@@ -186,12 +272,21 @@ bool RasterCache::Prepare(GrContext* context,
                           SkColorSpace* dst_color_space,
                           bool is_complex,
                           bool will_change) {
-  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
-    return false;
-  }
-  if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
-    // We only deal with pictures that are worthy of rasterization.
-    return false;
+  if (adaptive_) {
+    // The picture is measured even when the rasterization limits for this
+    // frame are reached, so these are only checked before rasterizing it.
+    if (will_change || !CanRasterizePicture(picture) ||
+        access_threshold_ == 0) {
+      return false;
+    }
+  } else {
+    if (!HasPictureRasterizationBudget()) {
+      return false;
+    }
+    if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
+      // We only deal with pictures that are worthy of rasterization.
+      return false;
+    }
   }
 
   // Decompose the matrix (once) for all subsequent operations. We want to make
@@ -207,21 +302,108 @@ bool RasterCache::Prepare(GrContext* context,
 
   Entry& entry = picture_cache_[cache_key];
   entry.access_count = ClampSize(entry.access_count + 1, 0, access_threshold_);
-  entry.used_this_frame = true;
-
-  if (entry.access_count < access_threshold_ || access_threshold_ == 0) {
+  TouchEntry(entry);
+
+  if (adaptive_) {
+    if (entry.image.is_valid()) {
+      return true;
+    }
+    if (entry.rasterization_pending || !ShouldPromote(entry) ||
+        !HasPictureRasterizationBudget()) {
+      return false;
+    }
+  } else if (entry.access_count < access_threshold_ ||
+             access_threshold_ == 0) {
     // Frame threshold has not yet been reached.
     return false;
+  } else if (current_frame_ < entry.demoted_until_frame) {
+    // The picture could not be rasterized recently.
+    return false;
   }
 
   if (!entry.image.is_valid()) {
+    if (adaptive_) {
+      TraceDecision("RasterCachePromotePicture", entry);
+    }
+    if (concurrent_task_runner_) {
+      if (!entry.rasterization_pending) {
+        entry.rasterization_pending = true;
+        RasterizePictureConcurrently(cache_key, picture, transformation_matrix,
+                                     dst_color_space);
+        picture_cached_this_frame_++;
+      }
+      // The picture is drawn directly till the result is adopted.
+      return false;
+    }
+    const fml::TimePoint start = fml::TimePoint::Now();
     entry.image = RasterizePicture(picture, context, transformation_matrix,
                                    dst_color_space, checkerboard_images_);
+    const fml::TimeDelta rasterize_time = fml::TimePoint::Now() - start;
+    entry.rasterize_time.AddSample(rasterize_time);
+    picture_rasterization_time_this_frame_ =
+        picture_rasterization_time_this_frame_ + rasterize_time;
   }
   picture_cached_this_frame_++;
   return true;
 }
 
+void RasterCache::RasterizePictureConcurrently(
+    const PictureRasterCacheKey& cache_key,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space) {
+  size_t generation = 0;
+  {
+    std::scoped_lock lock(concurrent_state_->mutex);
+    generation = concurrent_state_->generation;
+    concurrent_state_->pending_count++;
+  }
+
+  // Pictures are immutable and may be played back on any thread. The task
+  // holds references to everything it needs so that it does not depend on the
+  // lifetime of the cache or the layer tree.
+  concurrent_task_runner_->PostTask(
+      [state = concurrent_state_, cache_key, generation,
+       picture = sk_ref_sp(picture), matrix = transformation_matrix,
+       color_space = sk_ref_sp(dst_color_space),
+       checkerboard = checkerboard_images_]() {
+        TRACE_EVENT0("flutter", "RasterCacheConcurrentPopulate");
+        RasterCacheResult result = RasterizePicture(
+            picture.get(), nullptr, matrix, color_space.get(), checkerboard);
+        std::scoped_lock lock(state->mutex);
+        if (state->generation != generation) {
+          return;
+        }
+        state->pending_count--;
+        // Failures are reported too so that the entry stops waiting.
+        state->completed[cache_key] = std::move(result);
+      });
+}
+
+void RasterCache::AdoptConcurrentRasterizations() {
+  PictureRasterCacheKey::Map<RasterCacheResult> completed;
+  {
+    std::scoped_lock lock(concurrent_state_->mutex);
+    std::swap(completed, concurrent_state_->completed);
+  }
+
+  for (auto& item : completed) {
+    auto it = picture_cache_.find(item.first);
+    if (it == picture_cache_.end()) {
+      // The entry was swept while the picture was being rasterized.
+      continue;
+    }
+    Entry& entry = it->second;
+    entry.rasterization_pending = false;
+    if (!item.second.is_valid()) {
+      TraceDecision("RasterCacheRasterizationFailed", entry);
+      BackOff(entry);
+      continue;
+    }
+    entry.image = std::move(item.second);
+  }
+}
+
 RasterCacheResult RasterCache::Get(const SkPicture& picture,
                                    const SkMatrix& ctm) const {
   PictureRasterCacheKey cache_key(picture.uniqueID(), ctm);
@@ -235,18 +417,174 @@ RasterCacheResult RasterCache::Get(Layer* layer, const SkMatrix& ctm) const {
   return it == layer_cache_.end() ? RasterCacheResult() : it->second.image;
 }
 
+void RasterCache::RecordPaintTime(const SkPicture& picture,
+                                  const SkMatrix& ctm,
+                                  bool cached,
+                                  fml::TimeDelta time) const {
+  if (!adaptive_) {
+    return;
+  }
+  PictureRasterCacheKey cache_key(picture.uniqueID(), ctm);
+  auto it = picture_cache_.find(cache_key);
+  AddPaintTimeSample(it == picture_cache_.end() ? nullptr : &it->second,
+                     cached, time);
+}
+
+void RasterCache::RecordPaintTime(Layer* layer,
+                                  const SkMatrix& ctm,
+                                  bool cached,
+                                  fml::TimeDelta time) const {
+  if (!adaptive_) {
+    return;
+  }
+  LayerRasterCacheKey cache_key(layer->unique_id(), ctm);
+  auto it = layer_cache_.find(cache_key);
+  AddPaintTimeSample(it == layer_cache_.end() ? nullptr : &it->second, cached,
+                     time);
+}
+
+void RasterCache::AddPaintTimeSample(const Entry* entry,
+                                     bool cached,
+                                     fml::TimeDelta time) const {
+  if (entry == nullptr || !entry->used_this_frame) {
+    return;
+  }
+  if (cached) {
+    entry->cached_paint_time.AddSample(time);
+    cached_paint_time_.AddSample(time);
+  } else {
+    entry->paint_time.AddSample(time);
+  }
+}
+
+template <class Cache>
+void RasterCache::CollectEvictionCandidates(Cache& cache,
+                                            std::vector<Entry*>& candidates) {
+  for (auto& item : cache) {
+    Entry& entry = item.second;
+    if (!entry.used_this_frame && entry.image.is_valid()) {
+      candidates.push_back(&entry);
+    }
+  }
+}
+
+void RasterCache::EvictToBudget() {
+  size_t resident_bytes = GetResidentBytes();
+  if (resident_bytes <= max_bytes_) {
+    return;
+  }
+
+  std::vector<Entry*> candidates;
+  CollectEvictionCandidates(picture_cache_, candidates);
+  CollectEvictionCandidates(layer_cache_, candidates);
+
+  // The age of an entry is scaled down by the number of frames it was used in
+  // so that a single frame of absence does not evict a frequently used entry
+  // ahead of one that was only ever seen briefly.
+  const size_t current_frame = current_frame_;
+  auto weighted_age = [current_frame](const Entry* entry) {
+    const double age = current_frame - entry->last_used_frame;
+    return age / (entry->frames_used + 1);
+  };
+  std::sort(candidates.begin(), candidates.end(),
+            [&weighted_age](const Entry* lhs, const Entry* rhs) {
+              return weighted_age(lhs) > weighted_age(rhs);
+            });
+
+  for (Entry* entry : candidates) {
+    if (resident_bytes <= max_bytes_) {
+      break;
+    }
+    resident_bytes -= entry->image.image_bytes();
+    // Dropping the image makes the entry eligible for removal in the
+    // following sweep.
+    entry->image = RasterCacheResult();
+    entry->access_count = 0;
+  }
+}
+
+template <class Cache>
+void RasterCache::DemoteSlowEntries(Cache& cache, const char* kind) {
+  for (auto& item : cache) {
+    Entry& entry = item.second;
+    if (!entry.image.is_valid() || entry.cached_paint_time.samples == 0 ||
+        entry.paint_time.samples == 0 ||
+        entry.cached_paint_time.average < entry.paint_time.average) {
+      continue;
+    }
+    TraceDecision(kind, entry);
+    BackOff(entry);
+  }
+}
+
+void RasterCache::BackOff(Entry& entry) {
+  // Entries whose cached image keeps losing are reconsidered less often.
+  const size_t backoff = std::min(
+      kDemotionBackoffFrames << std::min<size_t>(entry.demotion_count, 8),
+      kMaxDemotionBackoffFrames);
+  entry.demotion_count++;
+  entry.demoted_until_frame = current_frame_ + backoff;
+  entry.image = RasterCacheResult();
+  entry.access_count = 0;
+}
+
 void RasterCache::SweepAfterFrame() {
-  using PictureCache = PictureRasterCacheKey::Map<Entry>;
-  using LayerCache = LayerRasterCacheKey::Map<Entry>;
-  SweepOneCacheAfterFrame<PictureCache, PictureCache::iterator>(picture_cache_);
-  SweepOneCacheAfterFrame<LayerCache, LayerCache::iterator>(layer_cache_);
+  AdoptConcurrentRasterizations();
+  if (adaptive_) {
+    DemoteSlowEntries(picture_cache_, "RasterCacheDemotePicture");
+    DemoteSlowEntries(layer_cache_, "RasterCacheDemoteLayer");
+  }
+  EvictToBudget();
+  SweepOneCacheAfterFrame(picture_cache_);
+  SweepOneCacheAfterFrame(layer_cache_);
   picture_cached_this_frame_ = 0;
+  picture_rasterization_time_this_frame_ = fml::TimeDelta::Zero();
+  current_frame_++;
   TraceStatsToTimeline();
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
   layer_cache_.clear();
+
+  std::scoped_lock lock(concurrent_state_->mutex);
+  concurrent_state_->generation++;
+  concurrent_state_->pending_count = 0;
+  concurrent_state_->completed.clear();
+}
+
+size_t RasterCache::GetResidentBytes() const {
+  size_t bytes = 0;
+  for (const auto& item : picture_cache_) {
+    bytes += item.second.image.image_bytes();
+  }
+  for (const auto& item : layer_cache_) {
+    bytes += item.second.image.image_bytes();
+  }
+  return bytes;
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+}
+
+void RasterCache::SetConcurrentTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  concurrent_task_runner_ = std::move(task_runner);
+}
+
+void RasterCache::SetAdaptive(bool adaptive) {
+  adaptive_ = adaptive;
+}
+
+void RasterCache::SetPictureRasterizationBudgetPerFrame(
+    fml::TimeDelta budget) {
+  picture_rasterization_budget_per_frame_ = budget;
+}
+
+size_t RasterCache::GetPendingRasterizationCount() const {
+  std::scoped_lock lock(concurrent_state_->mutex);
+  return concurrent_state_->pending_count;
 }
 
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
@@ -270,23 +608,22 @@ void RasterCache::TraceStatsToTimeline() const {
   size_t picture_cache_bytes = 0;
 
   for (const auto& item : layer_cache_) {
-    const auto dimensions = item.second.image.image_dimensions();
     layer_cache_count++;
-    layer_cache_bytes += dimensions.width() * dimensions.height() * 4;
+    layer_cache_bytes += item.second.image.image_bytes();
   }
 
   for (const auto& item : picture_cache_) {
-    const auto dimensions = item.second.image.image_dimensions();
     picture_cache_count++;
-    picture_cache_bytes += dimensions.width() * dimensions.height() * 4;
+    picture_cache_bytes += item.second.image.image_bytes();
   }
 
   FML_TRACE_COUNTER("flutter", "RasterCache",
-                    reinterpret_cast<int64_t>(this),             //
-                    "LayerCount", layer_cache_count,             //
-                    "LayerMBytes", layer_cache_bytes * 1e-6,     //
-                    "PictureCount", picture_cache_count,         //
-                    "PictureMBytes", picture_cache_bytes * 1e-6  //
+                    reinterpret_cast<int64_t>(this),              //
+                    "LayerCount", layer_cache_count,              //
+                    "LayerMBytes", layer_cache_bytes * 1e-6,      //
+                    "PictureCount", picture_cache_count,          //
+                    "PictureMBytes", picture_cache_bytes * 1e-6,  //
+                    "BudgetMBytes", max_bytes_ * 1e-6             //
   );
 
 #endif  // FLUTTER_RUNTIME_MODE != FLUTTER_RUNTIME_MODE_RELEASE
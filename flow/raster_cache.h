@@ -6,12 +6,16 @@
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache_key.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -37,6 +41,12 @@ class RasterCacheResult {
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
 
+  // The number of bytes held by the cached image, assuming 4 bytes per pixel.
+  size_t image_bytes() const {
+    const SkISize dimensions = image_dimensions();
+    return static_cast<size_t>(dimensions.width()) * dimensions.height() * 4;
+  }
+
  private:
   sk_sp<SkImage> image_;
   SkRect logical_rect_;
@@ -52,9 +62,16 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // The default number of bytes that rasterized entries may occupy before the
+  // least valuable entries that were not used in the current frame are
+  // evicted. Entries used in the current frame are never evicted, so the
+  // resident size may temporarily exceed this budget.
+  static constexpr size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
   explicit RasterCache(
       size_t access_threshold = 3,
-      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
+      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame,
+      size_t max_bytes = kDefaultMaxBytes);
 
   ~RasterCache();
 
@@ -81,6 +98,11 @@ class RasterCache {
   // 3. The picture is accessed too few times
   // 4. There are too many pictures to be cached in the current frame.
   //    (See also kDefaultPictureCacheLimitPerFrame.)
+  // 5. The picture is being rasterized on a worker and the result has not
+  //    been adopted yet. (See also SetConcurrentTaskRunner.)
+  // 6. In adaptive mode, the measured paint time of the picture does not
+  //    justify rasterizing it. (See also SetAdaptive.)
+  // 7. A worker recently failed to rasterize the picture.
   bool Prepare(GrContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -94,26 +116,130 @@ class RasterCache {
 
   RasterCacheResult Get(Layer* layer, const SkMatrix& ctm) const;
 
+  // Records how long it took to paint the picture or layer for |ctm|, either
+  // directly or from its cached image as indicated by |cached|. For layers,
+  // the time includes applying the effect of the parent that caches |layer|,
+  // such as its opacity.
+  // Measurements are only kept for entries that were prepared this frame and
+  // are ignored unless the cache is adaptive.
+  void RecordPaintTime(const SkPicture& picture,
+                       const SkMatrix& ctm,
+                       bool cached,
+                       fml::TimeDelta time) const;
+
+  void RecordPaintTime(Layer* layer,
+                       const SkMatrix& ctm,
+                       bool cached,
+                       fml::TimeDelta time) const;
+
+  // Ends the current frame. Entries that were not used in this frame are kept
+  // as long as the rasterized entries fit in the byte budget. When they do
+  // not, unused entries are evicted in least-recently-used order, with entries
+  // that were used over many frames surviving longer than ones used briefly.
   void SweepAfterFrame();
 
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  // The number of bytes currently held by rasterized picture and layer
+  // entries.
+  size_t GetResidentBytes() const;
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  void SetMaxBytes(size_t max_bytes);
+
+  // When a task runner is set, pictures that pass the caching heuristics are
+  // rasterized into CPU backed images on that runner instead of on the calling
+  // thread. Results are adopted in |SweepAfterFrame| and become available to
+  // the following frame. Until then, the picture is drawn directly. Layers
+  // are always rasterized synchronously. Pass nullptr to go back to
+  // synchronous rasterization.
+  void SetConcurrentTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
+  // When non-zero, the number of pictures rasterized synchronously in one
+  // frame is bounded by the time spent rasterizing them instead of by
+  // |picture_cache_limit_per_frame|. Rasterizations dispatched to the
+  // concurrent task runner are always bounded by
+  // |picture_cache_limit_per_frame|, both per frame and in flight.
+  void SetPictureRasterizationBudgetPerFrame(fml::TimeDelta budget);
+
+  // When adaptive, pictures and layers are cached based on their measured
+  // paint times instead of on the |is_complex| hint, the complexity of the
+  // picture and the access threshold. An entry is rasterized once the time it
+  // is expected to save over the frames it has been used in exceeds the time
+  // it takes to rasterize it. Cached images that turn out to be no faster to
+  // draw than their contents are dropped, and the entry is not considered
+  // again for an exponentially growing number of frames. Decisions are
+  // reported to the timeline. The |will_change| hint and the rasterization
+  // limits per frame are still respected.
+  void SetAdaptive(bool adaptive);
+
+  bool is_adaptive() const { return adaptive_; }
+
+  // The number of picture rasterizations dispatched to the concurrent task
+  // runner whose results have not been adopted yet.
+  size_t GetPendingRasterizationCount() const;
+
  private:
+  // Frame usage counts beyond this stop increasing the eviction weight of an
+  // entry so that long lived entries can still age out eventually.
+  static constexpr size_t kMaxFramesUsedWeight = 16;
+
+  // The number of frames an entry is not considered for caching after it was
+  // first demoted. Doubles with every further demotion up to
+  // |kMaxDemotionBackoffFrames|.
+  static constexpr size_t kDemotionBackoffFrames = 8;
+  static constexpr size_t kMaxDemotionBackoffFrames = 256;
+
+  // An exponentially weighted moving average of raster times.
+  struct RasterTime {
+    fml::TimeDelta average;
+    size_t samples = 0;
+
+    void AddSample(fml::TimeDelta sample);
+  };
+
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    size_t frames_used = 0;
+    size_t last_used_frame = 0;
+    bool rasterization_pending = false;
     RasterCacheResult image;
+
+    // Adaptive caching state. Paint times are recorded during the paint
+    // traversal, which only has const access to the cache.
+    mutable RasterTime paint_time;
+    mutable RasterTime cached_paint_time;
+    RasterTime rasterize_time;
+    size_t demotion_count = 0;
+    size_t demoted_until_frame = 0;
   };
 
-  template <class Cache, class Iterator>
+  // State shared with rasterization tasks running on the concurrent task
+  // runner. Outlives the cache if tasks are still in flight when the cache is
+  // collected.
+  struct ConcurrentRasterizationState {
+    std::mutex mutex;
+    // Bumped when the cache is cleared so that stale results are discarded.
+    size_t generation = 0;
+    size_t pending_count = 0;
+    // Results are invalid for pictures that could not be rasterized.
+    PictureRasterCacheKey::Map<RasterCacheResult> completed;
+  };
+
+  template <class Cache>
   static void SweepOneCacheAfterFrame(Cache& cache) {
-    std::vector<Iterator> dead;
+    std::vector<typename Cache::iterator> dead;
 
     for (auto it = cache.begin(); it != cache.end(); ++it) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
+      // Entries without an image only exist to count accesses towards the
+      // threshold. Those are only useful while accessed on consecutive frames.
+      if (!entry.used_this_frame && !entry.image.is_valid()) {
         dead.push_back(it);
       }
       entry.used_this_frame = false;
@@ -124,12 +250,53 @@ class RasterCache {
     }
   }
 
+  template <class Cache>
+  void CollectEvictionCandidates(Cache& cache, std::vector<Entry*>& candidates);
+
+  void EvictToBudget();
+
+  void TouchEntry(Entry& entry);
+
+  bool HasPictureRasterizationBudget() const;
+
+  bool ShouldPromote(const Entry& entry) const;
+
+  template <class Cache>
+  void DemoteSlowEntries(Cache& cache, const char* kind);
+
+  // Drops the image of |entry| and keeps it from being rasterized again for a
+  // number of frames that grows with every call.
+  void BackOff(Entry& entry);
+
+  static void TraceDecision(const char* name, const Entry& entry);
+
+  void AddPaintTimeSample(const Entry* entry,
+                          bool cached,
+                          fml::TimeDelta time) const;
+
+  void RasterizePictureConcurrently(const PictureRasterCacheKey& cache_key,
+                                    SkPicture* picture,
+                                    const SkMatrix& transformation_matrix,
+                                    SkColorSpace* dst_color_space);
+
+  void AdoptConcurrentRasterizations();
+
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
+  size_t max_bytes_;
   size_t picture_cached_this_frame_ = 0;
+  fml::TimeDelta picture_rasterization_budget_per_frame_;
+  fml::TimeDelta picture_rasterization_time_this_frame_;
+  size_t current_frame_ = 0;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  std::shared_ptr<ConcurrentRasterizationState> concurrent_state_;
   PictureRasterCacheKey::Map<Entry> picture_cache_;
   LayerRasterCacheKey::Map<Entry> layer_cache_;
   bool checkerboard_images_;
+  bool adaptive_ = false;
+  // The average time it took to draw any cached image. Used to estimate the
+  // savings of entries that were never drawn from the cache.
+  mutable RasterTime cached_paint_time_;
   fml::WeakPtrFactory<RasterCache> weak_factory_;
 
   void TraceStatsToTimeline() const;
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/raster_cache.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -66,7 +67,7 @@ TEST(RasterCache, ThresholdIsRespectedWhenZero) {
   cache.SweepAfterFrame();
 }
 
-TEST(RasterCache, SweepsRemoveUnusedFrames) {
+TEST(RasterCache, SweepsRetainUnusedEntriesWithinBudget) {
   size_t threshold = 3;
   flutter::RasterCache cache(threshold);
 
@@ -74,8 +75,6 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
 
   auto picture = GetSamplePicture();
 
-  sk_sp<SkImage> image;
-
   sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
   ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
                              false));  // 1
@@ -90,6 +89,345 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
                             false));  // 4
   cache.SweepAfterFrame();
   cache.SweepAfterFrame();  // Extra frame without a preroll image access.
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));  // 5
+}
+
+TEST(RasterCache, SweepsRemoveUnusedEntriesWithoutImages) {
+  size_t threshold = 3;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));  // 1
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));  // 2
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Extra frame without a preroll image access.
   ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
-                             false));  // 5
+                             false));  // 1 again
+}
+
+TEST(RasterCache, ResidentBytesAreReported) {
+  flutter::RasterCache cache(1);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_EQ(cache.GetResidentBytes(), 0u);
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetResidentBytes(), 150u * 100u * 4u);
+  cache.Clear();
+  ASSERT_EQ(cache.GetResidentBytes(), 0u);
+}
+
+TEST(RasterCache, SweepsEvictLeastRecentlyUsedEntriesOverBudget) {
+  const size_t picture_bytes = 150 * 100 * 4;
+  flutter::RasterCache cache(1, 3, 2 * picture_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  auto picture3 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetResidentBytes(), 2 * picture_bytes);
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture3.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+
+  // The picture that was used least recently makes room for the new one.
+  ASSERT_EQ(cache.GetResidentBytes(), 2 * picture_bytes);
+  ASSERT_FALSE(cache.Get(*picture1, matrix).is_valid());
+  ASSERT_TRUE(cache.Get(*picture2, matrix).is_valid());
+  ASSERT_TRUE(cache.Get(*picture3, matrix).is_valid());
+}
+
+TEST(RasterCache, SweepsPreferEvictingRarelyUsedEntries) {
+  const size_t picture_bytes = 150 * 100 * 4;
+  flutter::RasterCache cache(1, 3, 2 * picture_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto frequent = GetSamplePicture();
+  auto rare = GetSamplePicture();
+  auto incoming = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  for (int i = 0; i < 8; i++) {
+    ASSERT_TRUE(
+        cache.Prepare(NULL, frequent.get(), matrix, srgb.get(), true, false));
+    cache.SweepAfterFrame();
+  }
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Prepare(NULL, rare.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();
+
+  // |frequent| was used longer ago than |rare| but over many more frames.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, incoming.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Get(*frequent, matrix).is_valid());
+  ASSERT_FALSE(cache.Get(*rare, matrix).is_valid());
+  ASSERT_TRUE(cache.Get(*incoming, matrix).is_valid());
+}
+
+TEST(RasterCache, ConcurrentRasterizationIsAdoptedAfterFrame) {
+  flutter::RasterCache cache(1);
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  cache.SetConcurrentTaskRunner(loop->GetTaskRunner());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // The picture is dispatched to the workers and drawn directly this frame.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+
+  // Collecting the loop waits for the pending rasterization to finish.
+  loop.reset();
+  ASSERT_EQ(cache.GetPendingRasterizationCount(), 0u);
+
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+}
+
+TEST(RasterCache, ConcurrentRasterizationIsDiscardedOnClear) {
+  flutter::RasterCache cache(1);
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  cache.SetConcurrentTaskRunner(loop->GetTaskRunner());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  cache.Clear();
+  loop.reset();
+
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_EQ(cache.GetResidentBytes(), 0u);
+}
+
+TEST(RasterCache, FailedConcurrentRasterizationIsRetriedAfterBackoff) {
+  flutter::RasterCache cache(1, 1);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  // No raster surface can be allocated for a picture this large.
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(1 << 16, 1 << 16));
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeWH(1 << 16, 1 << 16),
+                                          SkPaint());
+  auto huge_picture = recorder.finishRecordingAsPicture();
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  cache.SetConcurrentTaskRunner(loop->GetTaskRunner());
+  ASSERT_FALSE(cache.Prepare(NULL, huge_picture.get(), matrix, srgb.get(),
+                             true, false));
+  loop.reset();
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetPendingRasterizationCount(), 0u);
+  ASSERT_FALSE(cache.Get(*huge_picture, matrix).is_valid());
+
+  // The failed picture backs off and leaves the budget to other pictures.
+  loop = fml::ConcurrentMessageLoop::Create();
+  cache.SetConcurrentTaskRunner(loop->GetTaskRunner());
+  ASSERT_FALSE(cache.Prepare(NULL, huge_picture.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  loop.reset();
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Get(*picture1, matrix).is_valid());
+
+  for (size_t frame = 2; frame < 8; frame++) {
+    ASSERT_FALSE(cache.Prepare(NULL, huge_picture.get(), matrix, srgb.get(),
+                               true, false));
+    cache.SweepAfterFrame();
+  }
+
+  // Once the backoff has elapsed, the failed picture is dispatched again and
+  // uses up the budget of the frame.
+  loop = fml::ConcurrentMessageLoop::Create();
+  cache.SetConcurrentTaskRunner(loop->GetTaskRunner());
+  ASSERT_FALSE(cache.Prepare(NULL, huge_picture.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  loop.reset();
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Get(*picture2, matrix).is_valid());
+}
+
+TEST(RasterCache, RasterizationTimeBudgetReplacesCountLimit) {
+  flutter::RasterCache cache(1);
+  cache.SetPictureRasterizationBudgetPerFrame(
+      fml::TimeDelta::FromMicroseconds(1));
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  // The first rasterization used up the budget for this frame.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+}
+
+TEST(RasterCache, ConcurrentRasterizationsAreBoundedWithTimeBudget) {
+  flutter::RasterCache cache(1, 2);
+  cache.SetPictureRasterizationBudgetPerFrame(fml::TimeDelta::FromSeconds(1));
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  cache.SetConcurrentTaskRunner(loop->GetTaskRunner());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  auto picture3 = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // Dispatches take no time on this thread, yet only two are dispatched.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture3.get(), matrix, srgb.get(), true, false));
+  loop.reset();
+
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Get(*picture1, matrix).is_valid());
+  ASSERT_TRUE(cache.Get(*picture2, matrix).is_valid());
+  ASSERT_FALSE(cache.Get(*picture3, matrix).is_valid());
+}
+
+TEST(RasterCache, AdaptiveCacheWaitsForPaintTimeMeasurements) {
+  flutter::RasterCache cache(1);
+  cache.SetAdaptive(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // The simple picture is not considered complex but measured to be slow.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+  cache.RecordPaintTime(*picture, matrix, false,
+                        fml::TimeDelta::FromMilliseconds(2));
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+
+  // The saving over the two frames the picture was used in now exceeds the
+  // estimated cost of rasterizing it.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+}
+
+TEST(RasterCache, AdaptiveCacheRespectsWillChange) {
+  flutter::RasterCache cache(1);
+  cache.SetAdaptive(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, true));
+    cache.RecordPaintTime(*picture, matrix, false,
+                          fml::TimeDelta::FromMilliseconds(2));
+    cache.SweepAfterFrame();
+  }
+}
+
+TEST(RasterCache, AdaptiveCacheDemotesEntriesThatDoNotSaveTime) {
+  flutter::RasterCache cache(1);
+  cache.SetAdaptive(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+  cache.RecordPaintTime(*picture, matrix, false,
+                        fml::TimeDelta::FromMilliseconds(1));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+
+  // Drawing the cached image turned out to be slower than drawing the picture.
+  cache.RecordPaintTime(*picture, matrix, true,
+                        fml::TimeDelta::FromMilliseconds(2));
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_EQ(cache.GetResidentBytes(), 0u);
+
+  // The entry is not promoted again while its cached image is known to be
+  // slower, even though its direct paint time keeps being measured.
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+    cache.RecordPaintTime(*picture, matrix, false,
+                          fml::TimeDelta::FromMilliseconds(1));
+    cache.SweepAfterFrame();
+  }
+}
+
+TEST(RasterCache, AdaptiveCacheIgnoresMeasurementsOfUnpreparedEntries) {
+  flutter::RasterCache cache(1);
+  cache.SetAdaptive(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  cache.RecordPaintTime(*picture, matrix, false,
+                        fml::TimeDelta::FromMilliseconds(2));
+  cache.SweepAfterFrame();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
 }
@@ -68,6 +68,12 @@ class SkiaGPUObject {
 
   sk_sp<SkiaObjectType> get() const { return object_; }
 
+  // Returns another reference to the same object that is released through
+  // the same queue.
+  SkiaGPUObject Clone() const {
+    return object_ ? SkiaGPUObject(object_, queue_) : SkiaGPUObject();
+  }
+
   void reset() {
     if (object_) {
       queue_->Unref(object_.release());
@@ -42,4 +42,45 @@ std::pair<bool, std::string> Base32Encode(std::string_view input) {
   return {true, output};
 }
 
+static int DecodeCharacter(char character) {
+  if (character >= 'A' && character <= 'Z') {
+    return character - 'A';
+  }
+  if (character >= '2' && character <= '7') {
+    return character - '2' + 26;
+  }
+  return -1;
+}
+
+std::pair<bool, std::string> Base32Decode(std::string_view input) {
+  std::string output;
+  output.reserve(input.size() * 5 / 8);
+
+  uint32_t bit_stream = 0;
+  int bit_count = 0;
+
+  for (char character : input) {
+    const int value = DecodeCharacter(character);
+    if (value < 0) {
+      return {false, ""};
+    }
+
+    bit_stream = (bit_stream << 5) | value;
+    bit_count += 5;
+
+    if (bit_count >= 8) {
+      bit_count -= 8;
+      output.push_back(static_cast<char>(bit_stream >> bit_count));
+      bit_stream &= (1u << bit_count) - 1;
+    }
+  }
+
+  // The encoder pads the last character with less than 5 zero bits.
+  if (bit_count >= 5 || bit_stream != 0) {
+    return {false, ""};
+  }
+
+  return {true, output};
+}
+
 }  // namespace fml
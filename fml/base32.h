@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_BASE32_H_
 #define FLUTTER_FML_BASE32_H_
 
+#include <string>
 #include <string_view>
 #include <utility>
 
@@ -12,6 +13,10 @@ namespace fml {
 
 std::pair<bool, std::string> Base32Encode(std::string_view input);
 
+// Reverses |Base32Encode|. Fails on characters outside of the encoding
+// alphabet and on inputs that |Base32Encode| could not have produced.
+std::pair<bool, std::string> Base32Decode(std::string_view input);
+
 }  // namespace fml
 
 #endif  // FLUTTER_FML_BASE32_H_
@@ -36,3 +36,46 @@ TEST(Base32Test, CanEncode) {
     ASSERT_EQ(result.second, "NBSWYTDP");
   }
 }
+
+TEST(Base32Test, CanDecode) {
+  {
+    auto result = fml::Base32Decode("NBSWY3DP");
+    ASSERT_TRUE(result.first);
+    ASSERT_EQ(result.second, "hello");
+  }
+
+  {
+    auto result = fml::Base32Decode("GE");
+    ASSERT_TRUE(result.first);
+    ASSERT_EQ(result.second, "1");
+  }
+
+  {
+    auto result = fml::Base32Decode("");
+    ASSERT_TRUE(result.first);
+    ASSERT_EQ(result.second, "");
+  }
+}
+
+TEST(Base32Test, DecodeReversesEncode) {
+  std::string input;
+  for (int i = 0; i < 256; i++) {
+    input.push_back(static_cast<char>(i));
+    auto encoded = fml::Base32Encode(input);
+    ASSERT_TRUE(encoded.first);
+    auto decoded = fml::Base32Decode(encoded.second);
+    ASSERT_TRUE(decoded.first);
+    ASSERT_EQ(decoded.second, input);
+  }
+}
+
+TEST(Base32Test, DecodeRejectsInvalidInput) {
+  // Not in the alphabet.
+  ASSERT_FALSE(fml::Base32Decode("nbswy3dp").first);
+  ASSERT_FALSE(fml::Base32Decode("NBSWY3D=").first);
+  ASSERT_FALSE(fml::Base32Decode("shader.pack").first);
+  // A dangling character that encodes no full byte.
+  ASSERT_FALSE(fml::Base32Decode("G").first);
+  // Non-zero padding bits.
+  ASSERT_FALSE(fml::Base32Decode("GF").first);
+}
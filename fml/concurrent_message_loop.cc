@@ -7,10 +7,25 @@
 #include <algorithm>
 
 #include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+namespace {
+
+// Identifies the concurrent message loop worker running on the current
+// thread so that tasks posted from it can go to its own queue.
+struct ConcurrentWorkerIdentity {
+  const ConcurrentMessageLoop* loop;
+  size_t index;
+};
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<ConcurrentWorkerIdentity>
+    tls_concurrent_worker;
+
+}  // namespace
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,11 +34,16 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  // All queues must exist before the first worker starts stealing from them.
+  for (size_t i = 0; i < worker_count_; ++i) {
+    queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.flutter.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      tls_concurrent_worker.reset(new ConcurrentWorkerIdentity{this, i});
+      WorkerMain(i);
     });
   }
 }
@@ -33,6 +53,9 @@ ConcurrentMessageLoop::~ConcurrentMessageLoop() {
   for (auto& worker : workers_) {
     worker.join();
   }
+  // A task may have been queued concurrently with termination after the
+  // workers decided to exit. Don't just drop it on the floor.
+  DrainOnCurrentThread();
 }
 
 size_t ConcurrentMessageLoop::GetWorkerCount() const {
@@ -43,62 +66,161 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(fml::closure task) {
+void ConcurrentMessageLoop::PostTask(fml::closure task,
+                                     ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
+  std::vector<fml::closure> tasks;
+  tasks.emplace_back(std::move(task));
+  PostTasks(std::move(tasks), priority);
+}
+
+void ConcurrentMessageLoop::PostTasks(std::vector<fml::closure> tasks,
+                                      ConcurrentTaskPriority priority) {
+  tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                             [](const fml::closure& task) { return !task; }),
+              tasks.end());
+  if (tasks.empty()) {
+    return;
+  }
 
   // Don't just drop tasks on the floor in case of shutdown.
-  if (shutdown_) {
+  if (!EnqueueTasks(tasks, priority)) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
-    task();
+    for (const auto& task : tasks) {
+      task();
+    }
     return;
   }
 
-  tasks_.push(task);
+  WakeWorkers(tasks.size());
+}
+
+size_t ConcurrentMessageLoop::GetQueueIndexForPost() {
+  auto* worker = tls_concurrent_worker.get();
+  if (worker != nullptr && worker->loop == this) {
+    return worker->index;
+  }
+  return next_queue_.fetch_add(1, std::memory_order_relaxed) % worker_count_;
+}
+
+bool ConcurrentMessageLoop::EnqueueTasks(std::vector<fml::closure>& tasks,
+                                         ConcurrentTaskPriority priority) {
+  if (shutdown_) {
+    return false;
+  }
 
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  const size_t priority_index = static_cast<size_t>(priority);
+  FML_DCHECK(priority_index < kPriorityCount);
 
-  tasks_condition_.notify_one();
+  // Spread batches over as many queues as there are tasks so that every
+  // worker woken up below finds something in its own queue. The other workers
+  // will steal from this one if the batch was posted from a worker.
+  const size_t first_queue = GetQueueIndexForPost();
+  const size_t queue_count = std::min(tasks.size(), worker_count_);
+  for (size_t offset = 0; offset < queue_count; ++offset) {
+    auto& queue = *queues_[(first_queue + offset) % worker_count_];
+    std::scoped_lock lock(queue.mutex);
+    size_t pushed = 0;
+    for (size_t i = offset; i < tasks.size(); i += queue_count) {
+      queue.tasks[priority_index].push_back(tasks[i]);
+      ++pushed;
+    }
+    // Counted under the queue lock so the count never drops below the number
+    // of tasks that are actually in the queues.
+    pending_tasks_ += pushed;
+  }
+  return true;
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock,
-                          [&]() { return tasks_.size() > 0 || shutdown_; });
+void ConcurrentMessageLoop::WakeWorkers(size_t count) {
+  const size_t sleeping = sleeping_workers_;
+  if (sleeping == 0) {
+    // Every worker is busy and will check the queues before it goes to sleep.
+    return;
+  }
 
-    if (tasks_.size() == 0) {
-      // This can only be caused by shutdown.
-      FML_DCHECK(shutdown_);
-      break;
+  // A worker that is about to sleep checks |pending_tasks_| while holding the
+  // mutex. Acquiring it here ensures that the notification below can't land
+  // between that check and the wait.
+  { std::scoped_lock lock(wake_mutex_); }
+
+  TRACE_EVENT0("flutter", "ConcurrentMessageLoop::WakeWorkers");
+  if (count >= sleeping) {
+    wake_condition_.notify_all();
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      wake_condition_.notify_one();
     }
+  }
+}
 
-    auto task = tasks_.front();
-    tasks_.pop();
+fml::closure ConcurrentMessageLoop::TakeTask(size_t worker_index) {
+  for (size_t priority = kPriorityCount; priority-- > 0;) {
+    // Own queue first, oldest task first.
+    {
+      auto& queue = *queues_[worker_index];
+      std::scoped_lock lock(queue.mutex);
+      auto& tasks = queue.tasks[priority];
+      if (!tasks.empty()) {
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        --pending_tasks_;
+        return task;
+      }
+    }
 
-    // Don't hold onto the mutex while the task is being executed as it could
-    // itself try to post another tasks to this message loop.
-    lock.unlock();
+    // Steal from the opposite end of a sibling's queue so that the owner and
+    // the thief don't fight over the same tasks.
+    for (size_t i = 1; i < worker_count_; ++i) {
+      auto& queue = *queues_[(worker_index + i) % worker_count_];
+      std::scoped_lock lock(queue.mutex);
+      auto& tasks = queue.tasks[priority];
+      if (!tasks.empty()) {
+        auto task = std::move(tasks.back());
+        tasks.pop_back();
+        --pending_tasks_;
+        return task;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  while (true) {
+    if (auto task = TakeTask(worker_index)) {
+      TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
+      task();
+      continue;
+    }
+
+    std::unique_lock lock(wake_mutex_);
+    ++sleeping_workers_;
+    wake_condition_.wait(lock,
+                         [&]() { return pending_tasks_ > 0 || shutdown_; });
+    --sleeping_workers_;
+
+    if (pending_tasks_ == 0 && shutdown_) {
+      break;
+    }
+  }
+}
 
-    TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the one tasks we woke up for.
+void ConcurrentMessageLoop::DrainOnCurrentThread() {
+  while (auto task = TakeTask(0)) {
     task();
   }
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
+  std::scoped_lock lock(wake_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  wake_condition_.notify_all();
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -107,13 +229,14 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
-void ConcurrentTaskRunner::PostTask(fml::closure task) {
+void ConcurrentTaskRunner::PostTask(fml::closure task,
+                                    ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority);
     return;
   }
 
@@ -123,4 +246,21 @@ void ConcurrentTaskRunner::PostTask(fml::closure task) {
   task();
 }
 
+void ConcurrentTaskRunner::PostTasks(std::vector<fml::closure> tasks,
+                                     ConcurrentTaskPriority priority) {
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTasks(std::move(tasks), priority);
+    return;
+  }
+
+  FML_DLOG(WARNING)
+      << "Tried to post to a concurrent message loop that has already died. "
+         "Executing the tasks on the callers thread.";
+  for (const auto& task : tasks) {
+    if (task) {
+      task();
+    }
+  }
+}
+
 }  // namespace fml
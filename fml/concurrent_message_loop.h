@@ -5,9 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -17,6 +21,23 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+// The priority of a task posted to a |ConcurrentMessageLoop|. Workers always
+// drain high priority tasks (from their own queue and then from the queues of
+// their siblings) before looking at normal priority ones. There are no
+// ordering guarantees between tasks of the same priority.
+enum class ConcurrentTaskPriority {
+  kNormal,
+  kHigh,
+};
+
+// A pool of worker threads that execute the tasks posted to it in no
+// particular order.
+//
+// Each worker owns a queue of tasks. Tasks posted from a worker are placed in
+// that worker's own queue; tasks posted from other threads are distributed
+// over the worker queues round-robin. A worker that runs out of tasks steals
+// from the queues of its siblings before going to sleep. This keeps workers
+// from contending on a single lock when tasks arrive in bursts.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -34,18 +55,56 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount = 2;
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<fml::closure> tasks[kPriorityCount] FML_GUARDED_BY(mutex);
+  };
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  bool shutdown_ = false;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  // Used to pick the queue for tasks posted from threads that are not
+  // workers of this loop.
+  std::atomic<size_t> next_queue_{0};
+  // The number of tasks in all worker queues that have not been picked up by
+  // a worker yet.
+  std::atomic<size_t> pending_tasks_{0};
+  // The number of workers that have found no work and are (about to be)
+  // waiting on |wake_condition_|. Posting only pays for a notification if
+  // there is someone to wake up.
+  std::atomic<size_t> sleeping_workers_{0};
+  std::atomic<bool> shutdown_{false};
+  std::mutex wake_mutex_;
+  std::condition_variable wake_condition_;
 
   ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
+
+  void PostTask(fml::closure task, ConcurrentTaskPriority priority);
+
+  void PostTasks(std::vector<fml::closure> tasks,
+                 ConcurrentTaskPriority priority);
 
-  void PostTask(fml::closure task);
+  // Returns the queue new tasks from the current thread should be placed in.
+  size_t GetQueueIndexForPost();
+
+  // Pushes the tasks without waking any workers. Returns false if the loop is
+  // shutting down, in which case the tasks are left untouched.
+  bool EnqueueTasks(std::vector<fml::closure>& tasks,
+                    ConcurrentTaskPriority priority);
+
+  // Wakes up to |count| sleeping workers.
+  void WakeWorkers(size_t count);
+
+  // Takes a task from the queue of the given worker, or steals one from
+  // another worker. Returns a null closure if all queues are empty.
+  fml::closure TakeTask(size_t worker_index);
+
+  // Runs tasks left behind in the queues once all workers have exited.
+  void DrainOnCurrentThread();
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -56,7 +115,16 @@ class ConcurrentTaskRunner {
 
   ~ConcurrentTaskRunner();
 
-  void PostTask(fml::closure task);
+  void PostTask(
+      fml::closure task,
+      ConcurrentTaskPriority priority = ConcurrentTaskPriority::kNormal);
+
+  // Posts all the given tasks at once. This is cheaper than posting them one
+  // at a time because the workers are woken up with a single notification
+  // per worker rather than one per task.
+  void PostTasks(
+      std::vector<fml::closure> tasks,
+      ConcurrentTaskPriority priority = ConcurrentTaskPriority::kNormal);
 
  private:
   friend ConcurrentMessageLoop;
@@ -0,0 +1,198 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+// A pool of workers sharing a single locked queue. This is how
+// |ConcurrentMessageLoop| used to be implemented and is kept here as the
+// baseline the work-stealing loop is measured against.
+class SingleQueueLoop {
+ public:
+  explicit SingleQueueLoop(size_t worker_count) {
+    for (size_t i = 0; i < worker_count; ++i) {
+      workers_.emplace_back([this]() { WorkerMain(); });
+    }
+  }
+
+  ~SingleQueueLoop() {
+    {
+      std::scoped_lock lock(mutex_);
+      shutdown_ = true;
+    }
+    condition_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void PostTask(fml::closure task) {
+    {
+      std::scoped_lock lock(mutex_);
+      tasks_.push(std::move(task));
+    }
+    condition_.notify_one();
+  }
+
+  void PostTasks(std::vector<fml::closure> tasks) {
+    for (auto& task : tasks) {
+      PostTask(std::move(task));
+    }
+  }
+
+ private:
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::queue<fml::closure> tasks_;
+  bool shutdown_ = false;
+
+  void WorkerMain() {
+    while (true) {
+      std::unique_lock lock(mutex_);
+      condition_.wait(lock, [&]() { return !tasks_.empty() || shutdown_; });
+      if (tasks_.empty()) {
+        return;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop();
+      lock.unlock();
+      task();
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SingleQueueLoop);
+};
+
+class WorkStealingLoop {
+ public:
+  explicit WorkStealingLoop(size_t worker_count)
+      : loop_(ConcurrentMessageLoop::Create(worker_count)),
+        task_runner_(loop_->GetTaskRunner()) {}
+
+  void PostTask(fml::closure task) { task_runner_->PostTask(std::move(task)); }
+
+  void PostTasks(std::vector<fml::closure> tasks) {
+    task_runner_->PostTasks(std::move(tasks));
+  }
+
+ private:
+  std::shared_ptr<ConcurrentMessageLoop> loop_;
+  std::shared_ptr<ConcurrentTaskRunner> task_runner_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WorkStealingLoop);
+};
+
+// Simulates a small unit of work such as a chunk of an image decode.
+static void SpinFor(fml::TimeDelta duration) {
+  const auto end = fml::TimePoint::Now() + duration;
+  while (fml::TimePoint::Now() < end) {
+  }
+}
+
+static double Percentile(std::vector<double>& sorted, double percentile) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const size_t index = std::min(
+      sorted.size() - 1, static_cast<size_t>(percentile * sorted.size()));
+  return sorted[index];
+}
+
+// Posts bursts of small tasks from several producer threads at once and
+// reports the throughput as well as the median and tail latency between a
+// task being posted and it starting to run.
+//
+// state.range(0): The number of workers.
+// state.range(1): 1 if bursts are posted as a single batch.
+template <class Loop>
+static void BM_ConcurrentLoopBurst(benchmark::State& state) {
+  const size_t worker_count = state.range(0);
+  const bool batched = state.range(1) != 0;
+  const size_t producer_count = 4;
+  const size_t tasks_per_producer = 256;
+  const size_t task_count = producer_count * tasks_per_producer;
+  const auto work = fml::TimeDelta::FromMicroseconds(2);
+
+  Loop loop(worker_count);
+  std::vector<double> latencies(task_count);
+  double p50_total = 0.0;
+  double p99_total = 0.0;
+
+  while (state.KeepRunning()) {
+    CountDownLatch done(task_count);
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producer_count; ++p) {
+      producers.emplace_back([&, p]() {
+        std::vector<fml::closure> tasks;
+        for (size_t i = 0; i < tasks_per_producer; ++i) {
+          const size_t index = p * tasks_per_producer + i;
+          const auto posted = fml::TimePoint::Now();
+          fml::closure task = [&, index, posted]() {
+            latencies[index] =
+                (fml::TimePoint::Now() - posted).ToMicrosecondsF();
+            SpinFor(work);
+            done.CountDown();
+          };
+          if (batched) {
+            tasks.emplace_back(std::move(task));
+          } else {
+            loop.PostTask(std::move(task));
+          }
+        }
+        if (batched) {
+          loop.PostTasks(std::move(tasks));
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    done.Wait();
+
+    state.PauseTiming();
+    std::sort(latencies.begin(), latencies.end());
+    p50_total += Percentile(latencies, 0.5);
+    p99_total += Percentile(latencies, 0.99);
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * task_count);
+  if (state.iterations() > 0) {
+    state.counters["p50_latency_us"] = p50_total / state.iterations();
+    state.counters["p99_latency_us"] = p99_total / state.iterations();
+  }
+}
+
+static void WorkerCountArguments(benchmark::internal::Benchmark* b) {
+  for (int batched = 0; batched <= 1; ++batched) {
+    for (int workers = 1; workers <= 16; workers *= 2) {
+      b->Args({workers, batched});
+    }
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopBurst, SingleQueueLoop)
+    ->Apply(WorkerCountArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_ConcurrentLoopBurst, WorkStealingLoop)
+    ->Apply(WorkerCountArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace fml
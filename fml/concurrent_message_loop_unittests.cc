@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(ConcurrentMessageLoopTest, CanRunAllPostedTasks) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = 1000;
+  CountDownLatch latch(task_count);
+  std::atomic<size_t> ran{0};
+  for (size_t i = 0; i < task_count; i++) {
+    task_runner->PostTask([&]() {
+      ran++;
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+  ASSERT_EQ(ran, task_count);
+}
+
+TEST(ConcurrentMessageLoopTest, CanRunBatchesOfTasks) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = 100;
+  CountDownLatch latch(task_count);
+  std::vector<fml::closure> tasks;
+  for (size_t i = 0; i < task_count; i++) {
+    tasks.emplace_back([&latch]() { latch.CountDown(); });
+  }
+  // Null tasks in a batch are ignored.
+  tasks.emplace_back(nullptr);
+  task_runner->PostTasks(std::move(tasks));
+  latch.Wait();
+}
+
+TEST(ConcurrentMessageLoopTest, TasksPostedFromWorkersAreRun) {
+  auto loop = ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t task_count = 100;
+  CountDownLatch latch(task_count);
+  // All tasks land in the queue of a single worker. The others have to steal
+  // them.
+  task_runner->PostTask([&]() {
+    for (size_t i = 0; i < task_count; i++) {
+      task_runner->PostTask([&latch]() { latch.CountDown(); });
+    }
+  });
+  latch.Wait();
+}
+
+TEST(ConcurrentMessageLoopTest, HighPriorityTasksRunFirst) {
+  auto loop = ConcurrentMessageLoop::Create(1);
+  auto task_runner = loop->GetTaskRunner();
+
+  AutoResetWaitableEvent started;
+  AutoResetWaitableEvent release;
+  task_runner->PostTask([&]() {
+    started.Signal();
+    release.Wait();
+  });
+  started.Wait();
+
+  std::mutex order_mutex;
+  std::vector<int> order;
+  CountDownLatch latch(3);
+  auto record = [&](int value) {
+    return [&, value]() {
+      {
+        std::scoped_lock lock(order_mutex);
+        order.push_back(value);
+      }
+      latch.CountDown();
+    };
+  };
+  task_runner->PostTask(record(1), ConcurrentTaskPriority::kNormal);
+  task_runner->PostTask(record(2), ConcurrentTaskPriority::kHigh);
+  task_runner->PostTask(record(3), ConcurrentTaskPriority::kNormal);
+  release.Signal();
+  latch.Wait();
+
+  ASSERT_EQ(order, (std::vector<int>{2, 1, 3}));
+}
+
+TEST(ConcurrentMessageLoopTest, TasksPostedAfterTerminateRunOnCaller) {
+  auto loop = ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  loop->Terminate();
+  bool ran = false;
+  task_runner->PostTask([&ran]() { ran = true; });
+  ASSERT_TRUE(ran);
+}
+
+TEST(ConcurrentMessageLoopTest, TasksPostedAfterLoopDiesRunOnCaller) {
+  auto loop = ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  loop.reset();
+  size_t ran = 0;
+  std::vector<fml::closure> tasks;
+  tasks.emplace_back([&ran]() { ran++; });
+  tasks.emplace_back([&ran]() { ran++; });
+  task_runner->PostTasks(std::move(tasks));
+  ASSERT_EQ(ran, 2u);
+}
+
+TEST(ConcurrentMessageLoopTest, PendingTasksRunBeforeDestruction) {
+  const size_t task_count = 100;
+  std::atomic<size_t> ran{0};
+  {
+    auto loop = ConcurrentMessageLoop::Create(2);
+    auto task_runner = loop->GetTaskRunner();
+    for (size_t i = 0; i < task_count; i++) {
+      task_runner->PostTask([&ran]() { ran++; });
+    }
+  }
+  ASSERT_EQ(ran, task_count);
+}
+
+}  // namespace testing
+}  // namespace fml
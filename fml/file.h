@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_FILE_H_
 #define FLUTTER_FML_FILE_H_
 
+#include <functional>
 #include <initializer_list>
 #include <string>
 #include <vector>
@@ -73,6 +74,16 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
                      const char* file_name,
                      const Mapping& mapping);
 
+/// Signature of a callback invoked for each entry of a directory. Returning
+/// false stops the iteration.
+using FileVisitor = std::function<bool(const fml::UniqueFD& directory,
+                                       const std::string& filename)>;
+
+/// Calls |visitor| for each entry of |directory| (excluding "." and ".."),
+/// without recursing into subdirectories. Returns false if the directory
+/// could not be read.
+bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor);
+
 class ScopedTemporaryDirectory {
  public:
   ScopedTemporaryDirectory();
@@ -81,6 +92,8 @@ class ScopedTemporaryDirectory {
 
   const UniqueFD& fd() { return dir_fd_; }
 
+  const std::string& path() const { return path_; }
+
  private:
   std::string path_;
   UniqueFD dir_fd_;
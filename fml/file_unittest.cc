@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -155,3 +156,36 @@ TEST(FileTest, AtomicWriteTest) {
   // Cleanup.
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "precious_data"));
 }
+
+TEST(FileTest, VisitFilesListsDirectoryEntries) {
+  fml::ScopedTemporaryDirectory dir;
+
+  const std::string contents = "contents";
+  auto data = std::make_unique<fml::DataMapping>(
+      std::vector<uint8_t>{contents.begin(), contents.end()});
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "a", *data));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "b", *data));
+
+  std::vector<std::string> names;
+  ASSERT_TRUE(fml::VisitFiles(
+      dir.fd(), [&names](const fml::UniqueFD& directory,
+                         const std::string& filename) {
+        names.push_back(filename);
+        return true;
+      }));
+  std::sort(names.begin(), names.end());
+  ASSERT_EQ(names, (std::vector<std::string>{"a", "b"}));
+
+  // Visiting can stop early and is repeatable.
+  size_t visited = 0;
+  ASSERT_TRUE(fml::VisitFiles(
+      dir.fd(), [&visited](const fml::UniqueFD& directory,
+                           const std::string& filename) {
+        visited++;
+        return false;
+      }));
+  ASSERT_EQ(visited, 1u);
+
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "a"));
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "b"));
+}
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/immediate_task_queue.h"
+
+#include <algorithm>
+
+namespace fml {
+
+static size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+ImmediateTaskQueue::ImmediateTaskQueue(size_t capacity)
+    : capacity_(RoundUpToPowerOfTwo(std::max<size_t>(capacity, 2))),
+      mask_(capacity_ - 1),
+      cells_(new Cell[capacity_]),
+      push_position_(0) {
+  for (size_t i = 0; i < capacity_; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+ImmediateTaskQueue::~ImmediateTaskQueue() = default;
+
+size_t ImmediateTaskQueue::GetCapacity() const {
+  return capacity_;
+}
+
+bool ImmediateTaskQueue::TryPush(size_t order,
+                                 fml::closure& task,
+                                 fml::TimePoint target_time) {
+  size_t position = push_position_.load(std::memory_order_relaxed);
+  Cell* cell = nullptr;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto difference = static_cast<intptr_t>(sequence) -
+                            static_cast<intptr_t>(position);
+    if (difference == 0) {
+      // The cell is free. Claim it.
+      if (push_position_.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The cell still holds the task pushed one lap ago. The ring is full.
+      return false;
+    } else {
+      // Another producer claimed this position first.
+      position = push_position_.load(std::memory_order_relaxed);
+    }
+  }
+
+  cell->order = order;
+  cell->task = std::move(task);
+  cell->target_time = target_time;
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+size_t ImmediateTaskQueue::DrainInto(DelayedTaskQueue& queue) {
+  size_t drained = 0;
+  while (true) {
+    Cell& cell = cells_[drain_position_ & mask_];
+    if (cell.sequence.load(std::memory_order_acquire) != drain_position_ + 1) {
+      // Either empty or the producer has claimed but not filled this cell
+      // yet. It will be picked up on the next drain.
+      break;
+    }
+    queue.push({cell.order, std::move(cell.task), cell.target_time});
+    cell.task = nullptr;
+    // Make the cell available to producers on the next lap.
+    cell.sequence.store(drain_position_ + capacity_, std::memory_order_release);
+    ++drain_position_;
+    ++drained;
+  }
+  return drained;
+}
+
+bool ImmediateTaskQueue::IsEmpty() const {
+  const Cell& cell = cells_[drain_position_ & mask_];
+  return cell.sequence.load(std::memory_order_acquire) != drain_position_ + 1;
+}
+
+}  // namespace fml
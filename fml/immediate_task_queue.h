@@ -0,0 +1,72 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_IMMEDIATE_TASK_QUEUE_H_
+#define FLUTTER_FML_IMMEDIATE_TASK_QUEUE_H_
+
+#include <atomic>
+#include <memory>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/delayed_task.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+
+// A bounded, lock-free, multi-producer single-consumer ring of tasks. Any
+// number of threads may push concurrently but only one thread at a time may
+// drain it.
+//
+// This is used by |MessageLoopTaskQueues| to accept tasks that are due
+// immediately without taking the task queue lock. The owner moves them into
+// its |DelayedTaskQueue| whenever it needs to look at the pending tasks.
+class ImmediateTaskQueue {
+ public:
+  static constexpr size_t kDefaultCapacity = 128;
+
+  // |capacity| is rounded up to the next power of two.
+  explicit ImmediateTaskQueue(size_t capacity = kDefaultCapacity);
+
+  ~ImmediateTaskQueue();
+
+  size_t GetCapacity() const;
+
+  // Thread safe. Returns false if the ring is full. |task| is only moved from
+  // if the push succeeds so that the caller can fall back to another queue.
+  bool TryPush(size_t order, fml::closure& task, fml::TimePoint target_time);
+
+  // Moves all the tasks that have been completely pushed so far into
+  // |queue|. Returns the number of tasks moved. Must not be called
+  // concurrently with itself or |IsEmpty|.
+  size_t DrainInto(DelayedTaskQueue& queue);
+
+  // Whether the next task to drain has not been pushed yet. Must not be called
+  // concurrently with |DrainInto|.
+  bool IsEmpty() const;
+
+ private:
+  struct Cell {
+    // The push or drain position this cell is ready for. A cell at index |i|
+    // may be pushed to at position |p| if |sequence == p| and drained at
+    // position |p| if |sequence == p + 1|.
+    std::atomic<size_t> sequence;
+    size_t order = 0;
+    fml::closure task;
+    fml::TimePoint target_time;
+  };
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+  std::atomic<size_t> push_position_;
+  // Only accessed by the consumer.
+  size_t drain_position_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImmediateTaskQueue);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_IMMEDIATE_TASK_QUEUE_H_
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/immediate_task_queue.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace testing {
+
+TEST(ImmediateTaskQueueTest, CapacityIsRoundedUpToPowerOfTwo) {
+  ImmediateTaskQueue queue(100);
+  ASSERT_EQ(queue.GetCapacity(), 128u);
+}
+
+TEST(ImmediateTaskQueueTest, DrainsTasksInPushOrder) {
+  ImmediateTaskQueue queue(4);
+  const auto now = fml::TimePoint::Now();
+  std::vector<int> ran;
+  for (int i = 0; i < 3; i++) {
+    fml::closure task = [&ran, i]() { ran.push_back(i); };
+    ASSERT_TRUE(queue.TryPush(i, task, now));
+    ASSERT_FALSE(task);
+  }
+  ASSERT_FALSE(queue.IsEmpty());
+
+  DelayedTaskQueue delayed_tasks;
+  ASSERT_EQ(queue.DrainInto(delayed_tasks), 3u);
+  ASSERT_TRUE(queue.IsEmpty());
+  while (!delayed_tasks.empty()) {
+    delayed_tasks.top().GetTask()();
+    delayed_tasks.pop();
+  }
+  ASSERT_EQ(ran, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(ImmediateTaskQueueTest, FullQueueLeavesTaskWithCaller) {
+  ImmediateTaskQueue queue(2);
+  const auto now = fml::TimePoint::Now();
+  fml::closure task = [] {};
+  ASSERT_TRUE(queue.TryPush(0, task, now));
+  task = [] {};
+  ASSERT_TRUE(queue.TryPush(1, task, now));
+  task = [] {};
+  ASSERT_FALSE(queue.TryPush(2, task, now));
+  ASSERT_TRUE(task);
+
+  // Draining makes room for the next lap.
+  DelayedTaskQueue delayed_tasks;
+  ASSERT_EQ(queue.DrainInto(delayed_tasks), 2u);
+  ASSERT_TRUE(queue.TryPush(2, task, now));
+}
+
+TEST(ImmediateTaskQueueTest, ConcurrentProducersDontLoseTasks) {
+  ImmediateTaskQueue queue(64);
+  const size_t producer_count = 4;
+  const size_t tasks_per_producer = 1000;
+  std::atomic<size_t> ran{0};
+  std::atomic<size_t> done_producers{0};
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < producer_count; p++) {
+    producers.emplace_back([&, p]() {
+      for (size_t i = 0; i < tasks_per_producer; i++) {
+        fml::closure task = [&ran]() { ran++; };
+        while (!queue.TryPush(p * tasks_per_producer + i, task,
+                              fml::TimePoint::Now())) {
+          std::this_thread::yield();
+        }
+      }
+      done_producers++;
+    });
+  }
+
+  DelayedTaskQueue delayed_tasks;
+  while (true) {
+    const bool producers_done = done_producers == producer_count;
+    queue.DrainInto(delayed_tasks);
+    while (!delayed_tasks.empty()) {
+      delayed_tasks.top().GetTask()();
+      delayed_tasks.pop();
+    }
+    if (producers_done) {
+      break;
+    }
+    std::this_thread::yield();
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ASSERT_EQ(ran, producer_count * tasks_per_producer);
+}
+
+}  // namespace testing
+}  // namespace fml
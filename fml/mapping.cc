@@ -79,6 +79,12 @@ const uint8_t* DataMapping::GetMapping() const {
 
 // NonOwnedMapping
 
+NonOwnedMapping::~NonOwnedMapping() {
+  if (release_proc_) {
+    release_proc_(data_, size_);
+  }
+}
+
 size_t NonOwnedMapping::GetSize() const {
   return size_;
 }
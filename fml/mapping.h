@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FML_MAPPING_H_
 #define FLUTTER_FML_MAPPING_H_
 
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <string>
@@ -99,8 +100,16 @@ class DataMapping final : public Mapping {
 
 class NonOwnedMapping final : public Mapping {
  public:
-  NonOwnedMapping(const uint8_t* data, size_t size)
-      : data_(data), size_(size) {}
+  using ReleaseProc = std::function<void(const uint8_t* data, size_t size)>;
+
+  // |release_proc|, if any, is called with the data when the mapping is
+  // collected. This lets a mapping take over memory it did not allocate.
+  NonOwnedMapping(const uint8_t* data,
+                  size_t size,
+                  ReleaseProc release_proc = nullptr)
+      : data_(data), size_(size), release_proc_(std::move(release_proc)) {}
+
+  ~NonOwnedMapping() override;
 
   // |Mapping|
   size_t GetSize() const override;
@@ -111,6 +120,7 @@ class NonOwnedMapping final : public Mapping {
  private:
   const uint8_t* const data_;
   const size_t size_;
+  const ReleaseProc release_proc_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(NonOwnedMapping);
 };
@@ -21,7 +21,7 @@ class MessageLoopTaskQueues::MergedQueuesRunner {
         task_queues_(task_queues),
         type_(type) {
     task_queues_.GetMutex(owner, type).lock();
-    subsumed_ = task_queues_.owner_to_subsumed_[owner];
+    subsumed_ = task_queues_.GetEntry(owner).owner_to_subsumed;
     if (isMerged(subsumed_)) {
       task_queues_.GetMutex(subsumed_, type).lock();
     }
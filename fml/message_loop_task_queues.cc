@@ -16,6 +16,13 @@ const TaskQueueId MessageLoopTaskQueues::_kUnmerged =
     TaskQueueId(TaskQueueId::kUnmerged);
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::instance_;
 
+MessageLoopTaskQueues::TaskQueueEntry::TaskQueueEntry()
+    : owner_to_subsumed(_kUnmerged),
+      subsumed_to_owner(TaskQueueId::kUnmerged),
+      immediate_tasks_wake_pending(false) {}
+
+MessageLoopTaskQueues::TaskQueueEntry::~TaskQueueEntry() = default;
+
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
   std::scoped_lock creation(creation_mutex_);
   if (!instance_) {
@@ -29,16 +36,19 @@ TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
 
-  observers_mutexes_.push_back(std::make_unique<std::mutex>());
-  delayed_tasks_mutexes_.push_back(std::make_unique<std::mutex>());
-  wakeable_mutexes_.push_back(std::make_unique<std::mutex>());
-
-  task_observers_.push_back(TaskObservers());
-  delayed_tasks_.push_back(DelayedTaskQueue());
-  wakeables_.push_back(NULL);
-
-  owner_to_subsumed_.push_back(_kUnmerged);
-  subsumed_to_owner_.push_back(_kUnmerged);
+  size_t index = loop_id;
+  size_t segment = 0;
+  size_t segment_size = kFirstSegmentSize;
+  while (index >= segment_size) {
+    index -= segment_size;
+    segment_size *= 2;
+    ++segment;
+  }
+  FML_CHECK(segment < kSegmentCount);
+  if (!segments_[segment]) {
+    segments_[segment].reset(new std::unique_ptr<TaskQueueEntry>[segment_size]);
+  }
+  segments_[segment][index] = std::make_unique<TaskQueueEntry>();
 
   return loop_id;
 }
@@ -48,27 +58,68 @@ MessageLoopTaskQueues::MessageLoopTaskQueues()
 
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
+MessageLoopTaskQueues::TaskQueueEntry& MessageLoopTaskQueues::GetEntry(
+    TaskQueueId queue_id) const {
+  size_t index = queue_id;
+  size_t segment = 0;
+  size_t segment_size = kFirstSegmentSize;
+  while (index >= segment_size) {
+    index -= segment_size;
+    segment_size *= 2;
+    ++segment;
+  }
+  FML_DCHECK(segment < kSegmentCount && segments_[segment] &&
+             segments_[segment][index]);
+  return *segments_[segment][index];
+}
+
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
   MergedQueuesRunner merged_tasks = MergedQueuesRunner(*this, queue_id);
-  merged_tasks.InvokeMerged(
-      [&](TaskQueueId queue_id) { delayed_tasks_[queue_id] = {}; });
+  merged_tasks.InvokeMerged([&](TaskQueueId queue_id) {
+    FlushImmediateTasksUnlocked(queue_id);
+    GetEntry(queue_id).delayed_tasks = {};
+  });
 }
 
 void MessageLoopTaskQueues::RegisterTask(TaskQueueId queue_id,
                                          fml::closure task,
                                          fml::TimePoint target_time) {
-  std::scoped_lock lock(GetMutex(queue_id, MutexType::kTasks));
+  TaskQueueEntry& entry = GetEntry(queue_id);
   size_t order = order_++;
-  delayed_tasks_[queue_id].push({order, std::move(task), target_time});
+
+  // Fast path for tasks that are due right away. These don't need to be
+  // sorted against the other pending tasks until the loop looks at them.
+  if (target_time <= fml::TimePoint::Now() &&
+      entry.immediate_tasks.TryPush(order, task, target_time)) {
+    // Only the first immediate task since the last flush wakes up the loop.
+    // The loop will flush all the ones pushed after it when it runs.
+    if (!entry.immediate_tasks_wake_pending.exchange(true)) {
+      TaskQueueId loop_to_wake = queue_id;
+      const size_t owner = entry.subsumed_to_owner;
+      if (owner != TaskQueueId::kUnmerged) {
+        loop_to_wake = TaskQueueId(owner);
+      }
+      WakeUp(loop_to_wake, target_time);
+    }
+    return;
+  }
+
+  std::scoped_lock lock(entry.tasks_mutex);
+  // Keep the immediate tasks ahead of this one when they are sorted.
+  FlushImmediateTasksUnlocked(queue_id);
+  entry.delayed_tasks.push({order, std::move(task), target_time});
   TaskQueueId loop_to_wake = queue_id;
-  if (subsumed_to_owner_[queue_id] != _kUnmerged) {
-    loop_to_wake = subsumed_to_owner_[queue_id];
+  if (entry.subsumed_to_owner != TaskQueueId::kUnmerged) {
+    loop_to_wake = TaskQueueId(entry.subsumed_to_owner);
   }
-  WakeUp(loop_to_wake, delayed_tasks_[queue_id].top().GetTargetTime());
+  WakeUpUnlocked(loop_to_wake, entry.delayed_tasks.top().GetTargetTime(),
+                 queue_id);
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) {
   MergedQueuesRunner merged_tasks = MergedQueuesRunner(*this, queue_id);
+  merged_tasks.InvokeMerged(
+      [&](TaskQueueId queue) { FlushImmediateTasksUnlocked(queue); });
   return HasPendingTasksUnlocked(queue_id);
 }
 
@@ -77,6 +128,8 @@ void MessageLoopTaskQueues::GetTasksToRunNow(
     FlushType type,
     std::vector<fml::closure>& invocations) {
   MergedQueuesRunner merged_tasks = MergedQueuesRunner(*this, queue_id);
+  merged_tasks.InvokeMerged(
+      [&](TaskQueueId queue) { FlushImmediateTasksUnlocked(queue); });
 
   if (!HasPendingTasksUnlocked(queue_id)) {
     return;
@@ -91,48 +144,82 @@ void MessageLoopTaskQueues::GetTasksToRunNow(
       break;
     }
     invocations.emplace_back(std::move(top.GetTask()));
-    delayed_tasks_[top_queue].pop();
+    GetEntry(top_queue).delayed_tasks.pop();
     if (type == FlushType::kSingle) {
       break;
     }
   }
 
   if (!HasPendingTasksUnlocked(queue_id)) {
-    WakeUp(queue_id, fml::TimePoint::Max());
+    WakeUpUnlocked(queue_id, fml::TimePoint::Max(), queue_id);
   } else {
-    WakeUp(queue_id, GetNextWakeTimeUnlocked(queue_id));
+    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id), queue_id);
   }
 }
 
 void MessageLoopTaskQueues::WakeUp(TaskQueueId queue_id, fml::TimePoint time) {
-  std::scoped_lock lock(GetMutex(queue_id, MutexType::kWakeables));
-  if (wakeables_[queue_id]) {
-    wakeables_[queue_id]->WakeUp(time);
+  TaskQueueEntry& entry = GetEntry(queue_id);
+  std::scoped_lock lock(entry.wakeable_mutex);
+  if (entry.wakeable) {
+    entry.wakeable->WakeUp(time);
+  }
+}
+
+void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId loop_id,
+                                           fml::TimePoint time,
+                                           TaskQueueId queue_id) {
+  WakeUp(loop_id, time);
+
+  // An immediate task may have been pushed without the tasks mutex since the
+  // queues were last flushed. The wake up for it could have been replaced by
+  // the one above, so wake the loop up again right away. It will flush and
+  // pick the task up.
+  const TaskQueueEntry& entry = GetEntry(queue_id);
+  bool immediate_tasks_pending = entry.immediate_tasks_wake_pending;
+  if (entry.owner_to_subsumed != _kUnmerged) {
+    immediate_tasks_pending |=
+        GetEntry(entry.owner_to_subsumed).immediate_tasks_wake_pending;
+  }
+  if (immediate_tasks_pending && time > fml::TimePoint::Now()) {
+    WakeUp(loop_id, fml::TimePoint::Now());
   }
 }
 
+void MessageLoopTaskQueues::FlushImmediateTasksUnlocked(TaskQueueId queue_id) {
+  TaskQueueEntry& entry = GetEntry(queue_id);
+  // Cleared before draining so that a task pushed concurrently either gets
+  // drained here or sets the flag again and wakes up the loop itself.
+  entry.immediate_tasks_wake_pending = false;
+  entry.immediate_tasks.DrainInto(entry.delayed_tasks);
+}
+
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) {
   MergedQueuesRunner merged_tasks = MergedQueuesRunner(*this, queue_id);
-  if (subsumed_to_owner_[queue_id] != _kUnmerged) {
+  merged_tasks.InvokeMerged(
+      [&](TaskQueueId queue) { FlushImmediateTasksUnlocked(queue); });
+  if (GetEntry(queue_id).subsumed_to_owner != TaskQueueId::kUnmerged) {
     return 0;
   }
   size_t total_tasks = 0;
-  merged_tasks.InvokeMerged(
-      [&](TaskQueueId queue) { total_tasks += delayed_tasks_[queue].size(); });
+  merged_tasks.InvokeMerged([&](TaskQueueId queue) {
+    total_tasks += GetEntry(queue).delayed_tasks.size();
+  });
   return total_tasks;
 }
 
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             fml::closure callback) {
-  std::scoped_lock lock(GetMutex(queue_id, MutexType::kObservers));
-  task_observers_[queue_id][key] = std::move(callback);
+  TaskQueueEntry& entry = GetEntry(queue_id);
+  std::scoped_lock lock(entry.observers_mutex);
+  entry.task_observers[key] = std::move(callback);
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::scoped_lock lock(GetMutex(queue_id, MutexType::kObservers));
-  task_observers_[queue_id].erase(key);
+  TaskQueueEntry& entry = GetEntry(queue_id);
+  std::scoped_lock lock(entry.observers_mutex);
+  entry.task_observers.erase(key);
 }
 
 void MessageLoopTaskQueues::NotifyObservers(TaskQueueId queue_id) {
@@ -140,7 +227,7 @@ void MessageLoopTaskQueues::NotifyObservers(TaskQueueId queue_id) {
       MergedQueuesRunner(*this, queue_id, MutexType::kObservers);
 
   merged_observers.InvokeMerged([&](TaskQueueId queue) {
-    for (const auto& observer : task_observers_[queue]) {
+    for (const auto& observer : GetEntry(queue).task_observers) {
       observer.second();
     }
   });
@@ -159,15 +246,21 @@ void MessageLoopTaskQueues::Swap(TaskQueueId primary, TaskQueueId secondary)
 
   std::scoped_lock lock(o1, o2, t1, t2);
 
-  std::swap(task_observers_[primary], task_observers_[secondary]);
-  std::swap(delayed_tasks_[primary], delayed_tasks_[secondary]);
+  FlushImmediateTasksUnlocked(primary);
+  FlushImmediateTasksUnlocked(secondary);
+
+  TaskQueueEntry& primary_entry = GetEntry(primary);
+  TaskQueueEntry& secondary_entry = GetEntry(secondary);
+  std::swap(primary_entry.task_observers, secondary_entry.task_observers);
+  std::swap(primary_entry.delayed_tasks, secondary_entry.delayed_tasks);
 }
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::scoped_lock lock(GetMutex(queue_id, MutexType::kWakeables));
-  FML_CHECK(!wakeables_[queue_id]) << "Wakeable can only be set once.";
-  wakeables_[queue_id] = wakeable;
+  TaskQueueEntry& entry = GetEntry(queue_id);
+  std::scoped_lock lock(entry.wakeable_mutex);
+  FML_CHECK(!entry.wakeable) << "Wakeable can only be set once.";
+  entry.wakeable = wakeable;
 }
 
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
@@ -185,13 +278,17 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
     return true;
   }
 
-  if (owner_to_subsumed_[owner] == subsumed) {
+  TaskQueueEntry& owner_entry = GetEntry(owner);
+  TaskQueueEntry& subsumed_entry = GetEntry(subsumed);
+
+  if (owner_entry.owner_to_subsumed == subsumed) {
     return true;
   }
 
   std::vector<TaskQueueId> owner_subsumed_keys = {
-      owner_to_subsumed_[owner], owner_to_subsumed_[subsumed],
-      subsumed_to_owner_[owner], subsumed_to_owner_[subsumed]};
+      owner_entry.owner_to_subsumed, subsumed_entry.owner_to_subsumed,
+      TaskQueueId(owner_entry.subsumed_to_owner),
+      TaskQueueId(subsumed_entry.subsumed_to_owner)};
 
   for (auto key : owner_subsumed_keys) {
     if (key != _kUnmerged) {
@@ -199,11 +296,16 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
     }
   }
 
-  owner_to_subsumed_[owner] = subsumed;
-  subsumed_to_owner_[subsumed] = owner;
+  owner_entry.owner_to_subsumed = subsumed;
+  subsumed_entry.subsumed_to_owner = owner;
+
+  // Flush only after the new owner is visible so that immediate tasks pushed
+  // to the subsumed queue from now on wake up the owner.
+  FlushImmediateTasksUnlocked(owner);
+  FlushImmediateTasksUnlocked(subsumed);
 
   if (HasPendingTasksUnlocked(owner)) {
-    WakeUp(owner, GetNextWakeTimeUnlocked(owner));
+    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner), owner);
   }
 
   return true;
@@ -215,20 +317,25 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
   MergedQueuesRunner merged_tasks =
       MergedQueuesRunner(*this, owner, MutexType::kTasks);
 
-  const TaskQueueId subsumed = owner_to_subsumed_[owner];
+  TaskQueueEntry& owner_entry = GetEntry(owner);
+  const TaskQueueId subsumed = owner_entry.owner_to_subsumed;
   if (subsumed == _kUnmerged) {
     return false;
   }
 
-  subsumed_to_owner_[subsumed] = _kUnmerged;
-  owner_to_subsumed_[owner] = _kUnmerged;
+  GetEntry(subsumed).subsumed_to_owner = TaskQueueId::kUnmerged;
+  owner_entry.owner_to_subsumed = _kUnmerged;
+
+  // See |Merge|.
+  FlushImmediateTasksUnlocked(owner);
+  FlushImmediateTasksUnlocked(subsumed);
 
   if (HasPendingTasksUnlocked(owner)) {
-    WakeUp(owner, GetNextWakeTimeUnlocked(owner));
+    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner), owner);
   }
 
   if (HasPendingTasksUnlocked(subsumed)) {
-    WakeUp(subsumed, GetNextWakeTimeUnlocked(subsumed));
+    WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed), subsumed);
   }
 
   return true;
@@ -236,26 +343,27 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner, TaskQueueId subsumed) {
   MergedQueuesRunner merged_observers = MergedQueuesRunner(*this, owner);
-  return subsumed == owner_to_subsumed_[owner] || owner == subsumed;
+  return subsumed == GetEntry(owner).owner_to_subsumed || owner == subsumed;
 }
 
 // Subsumed queues will never have pending tasks.
 // Owning queues will consider both their and their subsumed tasks.
 bool MessageLoopTaskQueues::HasPendingTasksUnlocked(TaskQueueId queue_id) {
-  if (subsumed_to_owner_[queue_id] != _kUnmerged) {
+  const TaskQueueEntry& entry = GetEntry(queue_id);
+  if (entry.subsumed_to_owner != TaskQueueId::kUnmerged) {
     return false;
   }
 
-  if (!delayed_tasks_[queue_id].empty()) {
+  if (!entry.delayed_tasks.empty()) {
     return true;
   }
 
-  const TaskQueueId subsumed = owner_to_subsumed_[queue_id];
+  const TaskQueueId subsumed = entry.owner_to_subsumed;
   if (subsumed == _kUnmerged) {
     // this is not an owner and queue is empty.
     return false;
   } else {
-    return !delayed_tasks_[subsumed].empty();
+    return !GetEntry(subsumed).delayed_tasks.empty();
   }
 }
 
@@ -269,17 +377,19 @@ const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
     TaskQueueId owner,
     TaskQueueId& top_queue_id) {
   FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const TaskQueueId subsumed = owner_to_subsumed_[owner];
+  const TaskQueueEntry& owner_entry = GetEntry(owner);
+  const TaskQueueId subsumed = owner_entry.owner_to_subsumed;
   if (subsumed == _kUnmerged) {
     top_queue_id = owner;
-    return delayed_tasks_[owner].top();
+    return owner_entry.delayed_tasks.top();
   }
   // we are owning another task queue
-  const bool subsumed_has_task = !delayed_tasks_[subsumed].empty();
-  const bool owner_has_task = !delayed_tasks_[owner].empty();
+  const TaskQueueEntry& subsumed_entry = GetEntry(subsumed);
+  const bool subsumed_has_task = !subsumed_entry.delayed_tasks.empty();
+  const bool owner_has_task = !owner_entry.delayed_tasks.empty();
   if (owner_has_task && subsumed_has_task) {
-    const auto owner_task = delayed_tasks_[owner].top();
-    const auto subsumed_task = delayed_tasks_[subsumed].top();
+    const auto owner_task = owner_entry.delayed_tasks.top();
+    const auto subsumed_task = subsumed_entry.delayed_tasks.top();
     if (owner_task > subsumed_task) {
       top_queue_id = subsumed;
     } else {
@@ -290,18 +400,18 @@ const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
   } else {
     top_queue_id = subsumed;
   }
-  return delayed_tasks_[top_queue_id].top();
+  return GetEntry(top_queue_id).delayed_tasks.top();
 }
 
 std::mutex& MessageLoopTaskQueues::GetMutex(TaskQueueId queue_id,
                                             MutexType type) {
-  std::scoped_lock lock(queue_meta_mutex_);
+  TaskQueueEntry& entry = GetEntry(queue_id);
   if (type == MutexType::kTasks) {
-    return *delayed_tasks_mutexes_[queue_id];
+    return entry.tasks_mutex;
   } else if (type == MutexType::kObservers) {
-    return *observers_mutexes_[queue_id];
+    return entry.observers_mutex;
   } else {
-    return *wakeable_mutexes_[queue_id];
+    return entry.wakeable_mutex;
   }
 }
 
@@ -5,12 +5,15 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/delayed_task.h"
+#include "flutter/fml/immediate_task_queue.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/synchronization/thread_annotations.h"
@@ -109,15 +112,69 @@ class MessageLoopTaskQueues
     kWakeables,
   };
 
-  using Mutexes = std::vector<std::unique_ptr<std::mutex>>;
   using TaskObservers = std::map<intptr_t, fml::closure>;
 
+  // The state of a single task queue. Each queue has its own locks so that
+  // loops never contend with each other.
+  struct TaskQueueEntry {
+    TaskQueueEntry();
+
+    ~TaskQueueEntry();
+
+    std::mutex tasks_mutex;
+    std::mutex observers_mutex;
+    std::mutex wakeable_mutex;
+
+    // Guarded by |wakeable_mutex|.
+    Wakeable* wakeable = nullptr;
+
+    // Guarded by |observers_mutex|.
+    TaskObservers task_observers;
+
+    // Guarded by |tasks_mutex|.
+    DelayedTaskQueue delayed_tasks;
+    TaskQueueId owner_to_subsumed;
+
+    // Written with |tasks_mutex| held. Also read without it to find the loop
+    // to wake up for immediate tasks.
+    std::atomic<size_t> subsumed_to_owner;
+
+    // Tasks that are due right away are pushed here without taking
+    // |tasks_mutex| and moved into |delayed_tasks| (with the mutex held)
+    // before the pending tasks are looked at.
+    ImmediateTaskQueue immediate_tasks;
+
+    // Set by the first immediate task pushed since |immediate_tasks| was last
+    // flushed. Only that task has to wake up the loop.
+    std::atomic<bool> immediate_tasks_wake_pending;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(TaskQueueEntry);
+  };
+
+  // Entries are stored in segments that double in size so that an entry never
+  // moves once created. This lets |GetEntry| look entries up without taking
+  // |queue_meta_mutex_|.
+  static constexpr size_t kFirstSegmentSize = 64;
+  static constexpr size_t kSegmentCount = 32;
+
   MessageLoopTaskQueues();
 
   ~MessageLoopTaskQueues();
 
+  TaskQueueEntry& GetEntry(TaskQueueId queue_id) const;
+
   void WakeUp(TaskQueueId queue_id, fml::TimePoint time);
 
+  // Wakes up |loop_id| at |time|. Must be called with the tasks mutex of
+  // |queue_id| (and of the queue it subsumes, if any) held.
+  void WakeUpUnlocked(TaskQueueId loop_id,
+                      fml::TimePoint time,
+                      TaskQueueId queue_id);
+
+  // Moves the immediate tasks of |queue_id| into its delayed task queue. Must
+  // be called with the tasks mutex of |queue_id| held.
+  void FlushImmediateTasksUnlocked(TaskQueueId queue_id);
+
   bool HasPendingTasksUnlocked(TaskQueueId queue_id);
 
   const DelayedTask& PeekNextTaskUnlocked(TaskQueueId queue_id,
@@ -135,19 +192,12 @@ class MessageLoopTaskQueues
 
   size_t task_queue_id_counter_ FML_GUARDED_BY(queue_meta_mutex_);
 
-  Mutexes observers_mutexes_ FML_GUARDED_BY(queue_meta_mutex_);
-  Mutexes delayed_tasks_mutexes_ FML_GUARDED_BY(queue_meta_mutex_);
-  Mutexes wakeable_mutexes_ FML_GUARDED_BY(queue_meta_mutex_);
-
-  // These are guarded by their corresponding `Mutexes`
-  std::vector<Wakeable*> wakeables_;
-  std::vector<TaskObservers> task_observers_;
-  std::vector<DelayedTaskQueue> delayed_tasks_;
+  // Segment |i| holds |kFirstSegmentSize << i| entries. Segments are only
+  // added with |queue_meta_mutex_| held. Reading them does not need the mutex
+  // as an entry is always created before its queue id is handed out.
+  std::unique_ptr<std::unique_ptr<TaskQueueEntry>[]> segments_[kSegmentCount];
 
   static const TaskQueueId _kUnmerged;
-  // These are guarded by delayed_tasks_mutexes_
-  std::vector<TaskQueueId> owner_to_subsumed_;
-  std::vector<TaskQueueId> subsumed_to_owner_;
 
   std::atomic_int order_;
 
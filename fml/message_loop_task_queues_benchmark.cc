@@ -57,5 +57,67 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Several producers post to a single task queue while its loop keeps
+// draining it, as happens when many threads post to the platform or UI task
+// runners.
+//
+// state.range(0): The number of producer threads.
+// state.range(1): 1 if the tasks are delayed and have to go through the
+//                 delayed task heap, 0 if they are due immediately.
+static void BM_MultiProducerRegisterTasks(benchmark::State& state) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  const auto queue_id = task_queue->CreateTaskQueue();
+  const size_t num_producers = state.range(0);
+  const bool delayed = state.range(1) != 0;
+  const size_t num_tasks_per_producer = 1000;
+  const size_t num_tasks = num_producers * num_tasks_per_producer;
+
+  while (state.KeepRunning()) {
+    const fml::TimePoint target_time =
+        delayed ? fml::TimePoint::Now() + fml::TimeDelta::FromMicroseconds(1)
+                : fml::TimePoint::Now();
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < num_producers; i++) {
+      producers.emplace_back([&task_queue, queue_id, target_time]() {
+        for (size_t j = 0; j < num_tasks_per_producer; j++) {
+          task_queue->RegisterTask(
+              queue_id, [] {}, target_time);
+        }
+      });
+    }
+
+    size_t num_run = 0;
+    std::vector<fml::closure> invocations;
+    while (num_run < num_tasks) {
+      task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll,
+                                   invocations);
+      for (auto& invocation : invocations) {
+        invocation();
+      }
+      num_run += invocations.size();
+      invocations.clear();
+    }
+
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_tasks);
+}
+
+static void ProducerCountArguments(benchmark::internal::Benchmark* b) {
+  for (int delayed = 0; delayed <= 1; ++delayed) {
+    for (int producers = 1; producers <= 8; producers *= 2) {
+      b->Args({producers, delayed});
+    }
+  }
+}
+
+BENCHMARK(BM_MultiProducerRegisterTasks)
+    ->Apply(ProducerCountArguments)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace benchmarking
 }  // namespace fml
@@ -4,6 +4,10 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -136,3 +140,83 @@ TEST(MessageLoopTaskQueue, WokenUpWithNewerTime) {
 
   latch.Wait();
 }
+
+TEST(MessageLoopTaskQueue, PreserveOrderingBeyondImmediateTaskCapacity) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  const int num_tasks = fml::ImmediateTaskQueue::kDefaultCapacity * 3;
+
+  std::vector<int> ran;
+  const auto now = fml::TimePoint::Now();
+  for (int i = 0; i < num_tasks; i++) {
+    task_queue->RegisterTask(
+        queue_id, [&ran, i]() { ran.push_back(i); }, now);
+  }
+  ASSERT_EQ(task_queue->GetNumPendingTasks(queue_id),
+            static_cast<size_t>(num_tasks));
+
+  std::vector<fml::closure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  for (auto& invocation : invocations) {
+    invocation();
+  }
+  ASSERT_EQ(ran.size(), static_cast<size_t>(num_tasks));
+  for (int i = 0; i < num_tasks; i++) {
+    ASSERT_EQ(ran[i], i);
+  }
+}
+
+TEST(MessageLoopTaskQueue, ImmediateTasksWakeUpOncePerFlush) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  int num_wakes = 0;
+  task_queue->SetWakeable(
+      queue_id, new TestWakeable(
+                    [&num_wakes](fml::TimePoint wake_time) { ++num_wakes; }));
+
+  task_queue->RegisterTask(
+      queue_id, []() {}, fml::TimePoint::Now());
+  task_queue->RegisterTask(
+      queue_id, []() {}, fml::TimePoint::Now());
+  ASSERT_EQ(num_wakes, 1);
+
+  // Once the loop has looked at the tasks the next one wakes it up again.
+  std::vector<fml::closure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  ASSERT_EQ(invocations.size(), 2u);
+  const int wakes_after_flush = num_wakes;
+  task_queue->RegisterTask(
+      queue_id, []() {}, fml::TimePoint::Now());
+  ASSERT_EQ(num_wakes, wakes_after_flush + 1);
+}
+
+TEST(MessageLoopTaskQueue, ConcurrentProducersAllTasksRun) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  const size_t num_producers = 4;
+  const size_t num_tasks_per_producer = 500;
+
+  std::atomic<size_t> ran{0};
+  fml::CountDownLatch producers_done(num_producers);
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < num_producers; i++) {
+    producers.emplace_back([&]() {
+      for (size_t j = 0; j < num_tasks_per_producer; j++) {
+        task_queue->RegisterTask(
+            queue_id, [&ran]() { ran++; }, fml::TimePoint::Now());
+      }
+      producers_done.CountDown();
+    });
+  }
+  producers_done.Wait();
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  std::vector<fml::closure> invocations;
+  task_queue->GetTasksToRunNow(queue_id, fml::FlushType::kAll, invocations);
+  for (auto& invocation : invocations) {
+    invocation();
+  }
+  ASSERT_EQ(ran, num_producers * num_tasks_per_producer);
+}
@@ -4,6 +4,7 @@
 
 #include "flutter/fml/file.h"
 
+#include <dirent.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -210,4 +211,34 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
                     base_directory.get(), file_name) == 0;
 }
 
+bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor) {
+  // |fdopendir| takes ownership of the descriptor it is given, so hand it a
+  // duplicate.
+  const int duplicate = FML_HANDLE_EINTR(::dup(directory.get()));
+  if (duplicate < 0) {
+    return false;
+  }
+
+  DIR* dir = ::fdopendir(duplicate);
+  if (dir == nullptr) {
+    ::close(duplicate);
+    return false;
+  }
+
+  // The duplicate shares its read position with |directory|.
+  ::rewinddir(dir);
+  while (dirent* entry = ::readdir(dir)) {
+    std::string filename = entry->d_name;
+    if (filename == "." || filename == "..") {
+      continue;
+    }
+    if (!visitor(directory, filename)) {
+      break;
+    }
+  }
+
+  ::closedir(dir);
+  return true;
+}
+
 }  // namespace fml
@@ -393,4 +393,28 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
   return true;
 }
 
+bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor) {
+  std::string search_pattern = GetFullHandlePath(directory) + "\\*";
+  WIN32_FIND_DATA find_file_data;
+  HANDLE find_handle = ::FindFirstFile(
+      StringToWideString(search_pattern).c_str(), &find_file_data);
+
+  if (find_handle == INVALID_HANDLE_VALUE) {
+    FML_DLOG(ERROR) << "Can't open the directory. Error: "
+                    << GetLastErrorMessage();
+    return false;
+  }
+
+  do {
+    std::string filename = WideStringToString(find_file_data.cFileName);
+    if (filename != "." && filename != "..") {
+      if (!visitor(directory, filename)) {
+        break;
+      }
+    }
+  } while (::FindNextFile(find_handle, &find_file_data));
+  ::FindClose(find_handle);
+  return true;
+}
+
 }  // namespace fml
@@ -106,7 +106,8 @@ class HtmlImage implements ui.Image {
 
   @override
   Future<ByteData> toByteData(
-      {ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba}) {
+      {ui.ImageByteFormat format = ui.ImageByteFormat.rawRgba,
+      int quality = 100}) {
     return futurize((Callback<ByteData> callback) {
       return _toByteData(format.index, (Uint8List encoded) {
         callback(encoded?.buffer?.asByteData());
@@ -1502,10 +1502,14 @@ abstract class Image {
   /// The [format] argument specifies the format in which the bytes will be
   /// returned.
   ///
+  /// The [quality] argument, between 0 and 100, trades the size of the bytes
+  /// for their fidelity when the format is [ImageByteFormat.jpeg] or
+  /// [ImageByteFormat.webp]. It is ignored for other formats.
+  ///
   /// Returns a future that completes with the binary image data or an error
   /// if encoding fails.
   Future<ByteData> toByteData(
-      {ImageByteFormat format = ImageByteFormat.rawRgba});
+      {ImageByteFormat format = ImageByteFormat.rawRgba, int quality = 100});
 
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
@@ -1745,6 +1749,35 @@ enum ImageByteFormat {
   ///  * <https://en.wikipedia.org/wiki/Portable_Network_Graphics>, the Wikipedia page on PNG.
   ///  * <https://tools.ietf.org/rfc/rfc2083.txt>, the PNG standard.
   png,
+
+  /// JPEG format.
+  ///
+  /// A lossy compression format that is well suited for photographs.
+  /// Transparency is not supported. The amount of compression is controlled
+  /// by the `quality` argument of [Image.toByteData].
+  ///
+  /// JPEG images normally use the `.jpg` file extension and the `image/jpeg`
+  /// MIME type.
+  ///
+  /// See also:
+  ///
+  ///  * <https://en.wikipedia.org/wiki/JPEG>, the Wikipedia page on JPEG.
+  jpeg,
+
+  /// WebP format.
+  ///
+  /// A lossy compression format that supports transparency and typically
+  /// produces smaller files than JPEG for the same quality. The amount of
+  /// compression is controlled by the `quality` argument of
+  /// [Image.toByteData].
+  ///
+  /// WebP images normally use the `.webp` file extension and the `image/webp`
+  /// MIME type.
+  ///
+  /// See also:
+  ///
+  ///  * <https://en.wikipedia.org/wiki/WebP>, the Wikipedia page on WebP.
+  webp,
 }
 
 /// The format of pixel data given to [decodeImageFromPixels].
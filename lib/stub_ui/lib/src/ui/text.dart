@@ -1083,6 +1083,39 @@ abstract class Paragraph {
   /// The [ParagraphConstraints] control how wide the text is allowed to be.
   void layout(ParagraphConstraints constraints);
 
+  /// Lays out each of the `paragraphs` with the constraints at the same index
+  /// in `constraints`, and returns their metrics.
+  ///
+  /// This has the same effect as calling [layout] on each paragraph, but
+  /// crosses into the engine only once, which makes a difference when many
+  /// short paragraphs are laid out, such as the cells of a table. The engine
+  /// shares the shaping of paragraphs that have the same text and may lay out
+  /// the paragraphs concurrently.
+  ///
+  /// The returned list holds eight values for each paragraph, in order: its
+  /// [width], [height], [longestLine], [minIntrinsicWidth],
+  /// [maxIntrinsicWidth], [alphabeticBaseline], [ideographicBaseline], and
+  /// 1.0 if it [didExceedMaxLines] or 0.0 otherwise.
+  static Float64List layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs != null);
+    assert(constraints != null);
+    assert(paragraphs.length == constraints.length);
+    final Float64List metrics = Float64List(paragraphs.length * 8);
+    for (int i = 0; i < paragraphs.length; i += 1) {
+      final Paragraph paragraph = paragraphs[i]..layout(constraints[i]);
+      final int offset = i * 8;
+      metrics[offset + 0] = paragraph.width;
+      metrics[offset + 1] = paragraph.height;
+      metrics[offset + 2] = paragraph.longestLine;
+      metrics[offset + 3] = paragraph.minIntrinsicWidth;
+      metrics[offset + 4] = paragraph.maxIntrinsicWidth;
+      metrics[offset + 5] = paragraph.alphabeticBaseline;
+      metrics[offset + 6] = paragraph.ideographicBaseline;
+      metrics[offset + 7] = paragraph.didExceedMaxLines ? 1.0 : 0.0;
+    }
+    return metrics;
+  }
+
   /// Returns a list of text boxes that enclose the given text range.
   ///
   /// The [boxHeightStyle] and [boxWidthStyle] parameters allow customization
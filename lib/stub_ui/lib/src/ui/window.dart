@@ -36,6 +36,10 @@ typedef PlatformMessageResponseCallback = void Function(ByteData data);
 typedef PlatformMessageCallback = void Function(
     String name, ByteData data, PlatformMessageResponseCallback callback);
 
+/// Signature for [Window.onPlatformMessageChunk].
+typedef PlatformMessageChunkCallback = void Function(
+    String name, int streamId, ByteData data, bool isLast);
+
 /// States that an application can be in.
 ///
 /// The values below describe notifications from the operating system.
@@ -904,6 +908,26 @@ abstract class Window {
     _onPlatformMessage = callback;
   }
 
+  /// Called whenever this window receives a chunk of a payload that a
+  /// platform-specific plugin streams to the application.
+  ///
+  /// The `name` parameter determines which plugin sent the chunk. All chunks
+  /// of a payload have the same `streamId`, and are received in the order in
+  /// which they were sent. The last chunk of a payload has a null `data`
+  /// parameter and an `isLast` parameter of true.
+  ///
+  /// Only embedders built on the embedder API can stream payloads so far. The
+  /// Android and iOS embeddings do not send chunks.
+  ///
+  /// The framework invokes this callback in the same zone in which the
+  /// callback was set.
+  PlatformMessageChunkCallback get onPlatformMessageChunk =>
+      _onPlatformMessageChunk;
+  PlatformMessageChunkCallback _onPlatformMessageChunk;
+  set onPlatformMessageChunk(PlatformMessageChunkCallback callback) {
+    _onPlatformMessageChunk = callback;
+  }
+
   /// Change the retained semantics data about this window.
   ///
   /// If [semanticsEnabled] is true, the user has requested that this funciton
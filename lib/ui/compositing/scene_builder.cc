@@ -11,6 +11,7 @@
 #include "flutter/flow/layers/color_filter_layer.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/layers/opacity_layer.h"
 #include "flutter/flow/layers/performance_overlay_layer.h"
@@ -80,24 +81,23 @@ void SceneBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
   });
 }
 
-SceneBuilder::SceneBuilder() = default;
+SceneBuilder::SceneBuilder() : arena_(flutter::LayerArena::Create()) {}
 SceneBuilder::~SceneBuilder() = default;
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushTransform(
     tonic::Float64List& matrix4) {
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
-  PushLayer(layer);
+  auto* layer = arena_->Make<flutter::TransformLayer>(sk_matrix);
+  auto engine_layer = PushLayer(layer);
   // matrix4 has to be released before we can return another Dart object
   matrix4.Release();
-  return EngineLayer::MakeRetained(layer);
+  return engine_layer;
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushOffset(double dx, double dy) {
   SkMatrix sk_matrix = SkMatrix::MakeTrans(dx, dy);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer = arena_->Make<flutter::TransformLayer>(sk_matrix);
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushClipRect(double left,
@@ -107,52 +107,46 @@ fml::RefPtr<EngineLayer> SceneBuilder::pushClipRect(double left,
                                                     int clipBehavior) {
   SkRect clipRect = SkRect::MakeLTRB(left, top, right, bottom);
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRectLayer>(clipRect, clip_behavior);
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer = arena_->Make<flutter::ClipRectLayer>(clipRect, clip_behavior);
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushClipRRect(const RRect& rrect,
                                                      int clipBehavior) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer =
+      arena_->Make<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushClipPath(const CanvasPath* path,
                                                     int clipBehavior) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   FML_DCHECK(clip_behavior != flutter::Clip::none);
-  auto layer =
-      std::make_shared<flutter::ClipPathLayer>(path->path(), clip_behavior);
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer =
+      arena_->Make<flutter::ClipPathLayer>(path->path(), clip_behavior);
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushOpacity(int alpha,
                                                    double dx,
                                                    double dy) {
-  auto layer =
-      std::make_shared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer =
+      arena_->Make<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
+  opacity_layers_.push_back(layer);
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushColorFilter(
     const ColorFilter* color_filter) {
-  auto layer =
-      std::make_shared<flutter::ColorFilterLayer>(color_filter->filter());
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer =
+      arena_->Make<flutter::ColorFilterLayer>(color_filter->filter());
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushBackdropFilter(ImageFilter* filter) {
-  auto layer = std::make_shared<flutter::BackdropFilterLayer>(filter->filter());
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  auto* layer = arena_->Make<flutter::BackdropFilterLayer>(filter->filter());
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushShaderMask(Shader* shader,
@@ -163,10 +157,9 @@ fml::RefPtr<EngineLayer> SceneBuilder::pushShaderMask(Shader* shader,
                                                       int blendMode) {
   SkRect rect = SkRect::MakeLTRB(maskRectLeft, maskRectTop, maskRectRight,
                                  maskRectBottom);
-  auto layer = std::make_shared<flutter::ShaderMaskLayer>(
+  auto* layer = arena_->Make<flutter::ShaderMaskLayer>(
       shader->shader(), rect, static_cast<SkBlendMode>(blendMode));
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  return PushLayer(layer);
 }
 
 fml::RefPtr<EngineLayer> SceneBuilder::pushPhysicalShape(const CanvasPath* path,
@@ -174,7 +167,7 @@ fml::RefPtr<EngineLayer> SceneBuilder::pushPhysicalShape(const CanvasPath* path,
                                                          int color,
                                                          int shadow_color,
                                                          int clipBehavior) {
-  auto layer = std::make_shared<flutter::PhysicalShapeLayer>(
+  auto* layer = arena_->Make<flutter::PhysicalShapeLayer>(
       static_cast<SkColor>(color), static_cast<SkColor>(shadow_color),
       static_cast<float>(UIDartState::Current()
                              ->window()
@@ -184,14 +177,24 @@ fml::RefPtr<EngineLayer> SceneBuilder::pushPhysicalShape(const CanvasPath* path,
           UIDartState::Current()->window()->viewport_metrics().physical_depth),
       static_cast<float>(elevation), path->path(),
       static_cast<flutter::Clip>(clipBehavior));
-  PushLayer(layer);
-  return EngineLayer::MakeRetained(layer);
+  return PushLayer(layer);
 }
 
 void SceneBuilder::addRetained(fml::RefPtr<EngineLayer> retainedLayer) {
   if (!current_layer_) {
     return;
   }
+  auto layer = retainedLayer->Layer();
+  if (arena_->IsShared(layer)) {
+    // The layer lives in the arena of this scene already. Sharing it within
+    // the arena would keep the arena alive forever.
+    current_layer_->AddUnowned(layer.get());
+    return;
+  }
+  // Layers of earlier scenes are copied out of their arena the first time
+  // they are retained, so that they don't keep all other layers of their
+  // scene alive. They are individually owned from then on.
+  retainedLayer->PromoteOutOfArena();
   current_layer_->Add(retainedLayer->Layer());
 }
 
@@ -212,10 +215,10 @@ void SceneBuilder::addPicture(double dx,
   SkPoint offset = SkPoint::Make(dx, dy);
   SkRect pictureRect = picture->picture()->cullRect();
   pictureRect.offset(offset.x(), offset.y());
-  auto layer = std::make_unique<flutter::PictureLayer>(
+  auto* layer = arena_->Make<flutter::PictureLayer>(
       offset, UIDartState::CreateGPUObject(picture->picture()), !!(hints & 1),
       !!(hints & 2));
-  current_layer_->Add(std::move(layer));
+  current_layer_->AddUnowned(layer);
 }
 
 void SceneBuilder::addTexture(double dx,
@@ -227,9 +230,9 @@ void SceneBuilder::addTexture(double dx,
   if (!current_layer_) {
     return;
   }
-  auto layer = std::make_unique<flutter::TextureLayer>(
+  auto* layer = arena_->Make<flutter::TextureLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), textureId, freeze);
-  current_layer_->Add(std::move(layer));
+  current_layer_->AddUnowned(layer);
 }
 
 void SceneBuilder::addPlatformView(double dx,
@@ -240,9 +243,9 @@ void SceneBuilder::addPlatformView(double dx,
   if (!current_layer_) {
     return;
   }
-  auto layer = std::make_unique<flutter::PlatformViewLayer>(
+  auto* layer = arena_->Make<flutter::PlatformViewLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), viewId);
-  current_layer_->Add(std::move(layer));
+  current_layer_->AddUnowned(layer);
 }
 
 #if defined(OS_FUCHSIA)
@@ -255,10 +258,10 @@ void SceneBuilder::addChildScene(double dx,
   if (!current_layer_) {
     return;
   }
-  auto layer = std::make_unique<flutter::ChildSceneLayer>(
+  auto* layer = arena_->Make<flutter::ChildSceneLayer>(
       sceneHost->id(), SkPoint::Make(dx, dy), SkSize::Make(width, height),
       hitTestable);
-  current_layer_->Add(std::move(layer));
+  current_layer_->AddUnowned(layer);
 }
 #endif  // defined(OS_FUCHSIA)
 
@@ -271,10 +274,10 @@ void SceneBuilder::addPerformanceOverlay(uint64_t enabledOptions,
     return;
   }
   SkRect rect = SkRect::MakeLTRB(left, top, right, bottom);
-  auto layer =
-      std::make_unique<flutter::PerformanceOverlayLayer>(enabledOptions);
+  auto* layer =
+      arena_->Make<flutter::PerformanceOverlayLayer>(enabledOptions);
   layer->set_paint_bounds(rect);
-  current_layer_->Add(std::move(layer));
+  current_layer_->AddUnowned(layer);
 }
 
 void SceneBuilder::setRasterizerTracingThreshold(uint32_t frameInterval) {
@@ -290,29 +293,41 @@ void SceneBuilder::setCheckerboardOffscreenLayers(bool checkerboard) {
 }
 
 fml::RefPtr<Scene> SceneBuilder::build() {
+  // Layers must not change once they may be retained. (See
+  // |OpacityLayer::EnsureSingleChild|.)
+  for (auto* layer : opacity_layers_) {
+    if (!layer->layers().empty()) {
+      layer->EnsureSingleChild();
+    }
+  }
+  opacity_layers_.clear();
+
+  std::shared_ptr<flutter::Layer> root_layer;
+  if (root_layer_) {
+    root_layer = arena_->Share<flutter::Layer>(root_layer_);
+    root_layer_ = nullptr;
+  }
   fml::RefPtr<Scene> scene = Scene::create(
-      std::move(root_layer_), rasterizer_tracing_threshold_,
+      std::move(root_layer), rasterizer_tracing_threshold_,
       checkerboard_raster_cache_images_, checkerboard_offscreen_layers_);
   ClearDartWrapper();
   return scene;
 }
 
-void SceneBuilder::PushLayer(std::shared_ptr<flutter::ContainerLayer> layer) {
+fml::RefPtr<EngineLayer> SceneBuilder::PushLayer(
+    flutter::ContainerLayer* layer) {
   FML_DCHECK(layer);
 
   if (!root_layer_) {
-    root_layer_ = std::move(layer);
-    current_layer_ = root_layer_.get();
-    return;
-  }
-
-  if (!current_layer_) {
-    return;
+    root_layer_ = layer;
+    current_layer_ = root_layer_;
+  } else if (current_layer_) {
+    current_layer_->AddUnowned(layer);
+    current_layer_ = layer;
   }
 
-  flutter::ContainerLayer* newLayer = layer.get();
-  current_layer_->Add(std::move(layer));
-  current_layer_ = newLayer;
+  // The framework may retain any layer it pushed for later scenes.
+  return EngineLayer::MakeRetained(arena_->Share(layer), arena_);
 }
 
 }  // namespace flutter
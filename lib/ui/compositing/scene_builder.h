@@ -9,7 +9,10 @@
 
 #include <memory>
 #include <stack>
+#include <vector>
 
+#include "flutter/flow/layers/layer_arena.h"
+#include "flutter/flow/layers/opacity_layer.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/color_filter.h"
@@ -109,14 +112,17 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
  private:
   SceneBuilder();
 
-  std::shared_ptr<flutter::ContainerLayer> root_layer_;
+  // Owns the layers of the scene being built.
+  std::shared_ptr<flutter::LayerArena> arena_;
+  flutter::ContainerLayer* root_layer_ = nullptr;
   flutter::ContainerLayer* current_layer_ = nullptr;
+  std::vector<flutter::OpacityLayer*> opacity_layers_;
 
   int rasterizer_tracing_threshold_ = 0;
   bool checkerboard_raster_cache_images_ = false;
   bool checkerboard_offscreen_layers_ = false;
 
-  void PushLayer(std::shared_ptr<flutter::ContainerLayer> layer);
+  fml::RefPtr<EngineLayer> PushLayer(flutter::ContainerLayer* layer);
 
   FML_DISALLOW_COPY_AND_ASSIGN(SceneBuilder);
 };
@@ -152,6 +152,19 @@ void _dispatchPlatformMessage(String name, ByteData data, int responseId) {
   }
 }
 
+@pragma('vm:entry-point')
+// ignore: unused_element
+void _dispatchPlatformMessageChunk(String name, int streamId, ByteData data, bool isLast) {
+  _invoke4<String, int, ByteData, bool>(
+    window.onPlatformMessageChunk,
+    window._onPlatformMessageChunkZone,
+    name,
+    streamId,
+    data,
+    isLast,
+  );
+}
+
 @pragma('vm:entry-point')
 // ignore: unused_element
 void _dispatchPointerDataPacket(ByteData packet) {
@@ -282,6 +295,22 @@ void _invoke3<A1, A2, A3>(void callback(A1 a1, A2 a2, A3 a3), Zone zone, A1 arg1
   }
 }
 
+/// Invokes [callback] inside the given [zone] passing it [arg1], [arg2], [arg3] and [arg4].
+void _invoke4<A1, A2, A3, A4>(void callback(A1 a1, A2 a2, A3 a3, A4 a4), Zone zone, A1 arg1, A2 arg2, A3 arg3, A4 arg4) {
+  if (callback == null)
+    return;
+
+  assert(zone != null);
+
+  if (identical(zone, Zone.current)) {
+    callback(arg1, arg2, arg3, arg4);
+  } else {
+    zone.runGuarded(() {
+      callback(arg1, arg2, arg3, arg4);
+    });
+  }
+}
+
 // If this value changes, update the encoding code in the following files:
 //
 //  * pointer_data.cc
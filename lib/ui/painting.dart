@@ -1496,6 +1496,35 @@ enum ImageByteFormat {
   ///  * <https://en.wikipedia.org/wiki/Portable_Network_Graphics>, the Wikipedia page on PNG.
   ///  * <https://tools.ietf.org/rfc/rfc2083.txt>, the PNG standard.
   png,
+
+  /// JPEG format.
+  ///
+  /// A lossy compression format that is well suited for photographs.
+  /// Transparency is not supported. The amount of compression is controlled
+  /// by the `quality` argument of [Image.toByteData].
+  ///
+  /// JPEG images normally use the `.jpg` file extension and the `image/jpeg`
+  /// MIME type.
+  ///
+  /// See also:
+  ///
+  ///  * <https://en.wikipedia.org/wiki/JPEG>, the Wikipedia page on JPEG.
+  jpeg,
+
+  /// WebP format.
+  ///
+  /// A lossy compression format that supports transparency and typically
+  /// produces smaller files than JPEG for the same quality. The amount of
+  /// compression is controlled by the `quality` argument of
+  /// [Image.toByteData].
+  ///
+  /// WebP images normally use the `.webp` file extension and the `image/webp`
+  /// MIME type.
+  ///
+  /// See also:
+  ///
+  ///  * <https://en.wikipedia.org/wiki/WebP>, the Wikipedia page on WebP.
+  webp,
 }
 
 /// The format of pixel data given to [decodeImageFromPixels].
@@ -1557,18 +1586,25 @@ class Image extends NativeFieldWrapperClass2 {
   /// The [format] argument specifies the format in which the bytes will be
   /// returned.
   ///
+  /// The [quality] argument, between 0 and 100, trades the size of the bytes
+  /// for their fidelity when the format is [ImageByteFormat.jpeg] or
+  /// [ImageByteFormat.webp]. It is ignored for other formats.
+  ///
+  /// The image is encoded on a background thread.
+  ///
   /// Returns a future that completes with the binary image data or an error
   /// if encoding fails.
-  Future<ByteData> toByteData({ImageByteFormat format = ImageByteFormat.rawRgba}) {
+  Future<ByteData> toByteData({ImageByteFormat format = ImageByteFormat.rawRgba, int quality = 100}) {
+    assert(quality != null && quality >= 0 && quality <= 100);
     return _futurize((_Callback<ByteData> callback) {
-      return _toByteData(format.index, (Uint8List encoded) {
+      return _toByteData(format.index, quality, (Uint8List encoded) {
         callback(encoded?.buffer?.asByteData());
       });
     });
   }
 
   /// Returns an error message on failure, null on success.
-  String _toByteData(int format, _Callback<Uint8List> callback) native 'Image_toByteData';
+  String _toByteData(int format, int quality, _Callback<Uint8List> callback) native 'Image_toByteData';
 
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
@@ -1660,17 +1696,36 @@ class Codec extends NativeFieldWrapperClass2 {
 /// while forcing the image to match the specified dimension. If both are not
 /// specified, then the image maintains its real size.
 ///
+/// The [targetSubset] argument selects the region of the image to decode, in
+/// image pixels after the orientation of the image is applied. It is rounded
+/// out to whole pixels. Only that region is decompressed if the codec
+/// supports it, and [targetWidth] and [targetHeight] then specify the size of
+/// the region in the output image. Decoding a frame fails if the region is not
+/// within the image. The region is ignored for animated images.
+///
 /// The returned future can complete with an error if the image decoding has
 /// failed.
 Future<Codec> instantiateImageCodec(Uint8List list, {
   int targetWidth,
   int targetHeight,
+  Rect targetSubset,
 }) {
   return _futurize(
-    (_Callback<Codec> callback) => _instantiateImageCodec(list, callback, null, targetWidth ?? _kDoNotResizeDimension, targetHeight ?? _kDoNotResizeDimension)
+    (_Callback<Codec> callback) => _instantiateImageCodec(list, callback, null, targetWidth ?? _kDoNotResizeDimension, targetHeight ?? _kDoNotResizeDimension, _encodeImageSubset(targetSubset))
   );
 }
 
+Int32List _encodeImageSubset(Rect subset) {
+  if (subset == null)
+    return null;
+  return Int32List.fromList(<int>[
+    subset.left.floor(),
+    subset.top.floor(),
+    subset.right.ceil(),
+    subset.bottom.ceil(),
+  ]);
+}
+
 /// Instantiates a [Codec] object for an image binary data.
 ///
 /// The [targetWidth] and [targetHeight] arguments specify the size of the output
@@ -1681,8 +1736,11 @@ Future<Codec> instantiateImageCodec(Uint8List list, {
 /// ratio will be maintained while forcing the image to match the given dimension.
 /// If both are equal to [_kDoNotResizeDimension], then the image maintains its real size.
 ///
+/// If [targetSubset] is not null, it holds the left, top, right and bottom
+/// edges of the region of the image to decode.
+///
 /// Returns an error message if the instantiation has failed, null otherwise.
-String _instantiateImageCodec(Uint8List list, _Callback<Codec> callback, _ImageInfo imageInfo, int targetWidth, int targetHeight)
+String _instantiateImageCodec(Uint8List list, _Callback<Codec> callback, _ImageInfo imageInfo, int targetWidth, int targetHeight, Int32List targetSubset)
   native 'instantiateImageCodec';
 
 /// Loads a single image frame from a byte array into an [Image] object.
@@ -1724,7 +1782,7 @@ void decodeImageFromPixels(
 ) {
   final _ImageInfo imageInfo = _ImageInfo(width, height, format.index, rowBytes);
   final Future<Codec> codecFuture = _futurize(
-    (_Callback<Codec> callback) => _instantiateImageCodec(pixels, callback, imageInfo, targetWidth ?? _kDoNotResizeDimension, targetHeight ?? _kDoNotResizeDimension)
+    (_Callback<Codec> callback) => _instantiateImageCodec(pixels, callback, imageInfo, targetWidth ?? _kDoNotResizeDimension, targetHeight ?? _kDoNotResizeDimension, null)
   );
   codecFuture.then((Codec codec) => codec.getNextFrame())
       .then((FrameInfo frameInfo) => callback(frameInfo.image));
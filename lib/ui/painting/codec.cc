@@ -198,6 +198,28 @@ static void InstantiateImageCodec(Dart_NativeArguments args) {
   const int targetHeight =
       tonic::DartConverter<int>::FromDart(Dart_GetNativeArgument(args, 4));
 
+  std::optional<SkIRect> target_subset;
+  if (!Dart_IsNull(Dart_GetNativeArgument(args, 5))) {
+    Dart_Handle exception = nullptr;
+    tonic::Int32List subset =
+        tonic::DartConverter<tonic::Int32List>::FromArguments(args, 5,
+                                                              exception);
+    if (exception) {
+      Dart_SetReturnValue(args, exception);
+      return;
+    }
+    if (subset.num_elements() != 4) {
+      Dart_SetReturnValue(args, ToDart("targetSubset must have 4 elements"));
+      return;
+    }
+    target_subset =
+        SkIRect::MakeLTRB(subset[0], subset[1], subset[2], subset[3]);
+    if (target_subset->isEmpty()) {
+      Dart_SetReturnValue(args, ToDart("targetSubset must not be empty"));
+      return;
+    }
+  }
+
   std::unique_ptr<SkCodec> codec;
   bool single_frame;
   if (image_info) {
@@ -223,6 +245,7 @@ static void InstantiateImageCodec(Dart_NativeArguments args) {
     if (targetHeight != kDoNotResizeDimension) {
       descriptor.target_height = targetHeight;
     }
+    descriptor.target_subset = target_subset;
     descriptor.data = std::move(buffer);
 
     ui_codec = fml::MakeRefCounted<SingleFrameCodec>(std::move(descriptor));
@@ -249,7 +272,7 @@ void Codec::dispose() {
 
 void Codec::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register({
-      {"instantiateImageCodec", InstantiateImageCodec, 5, true},
+      {"instantiateImageCodec", InstantiateImageCodec, 6, true},
   });
   natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
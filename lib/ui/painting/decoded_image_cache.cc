@@ -0,0 +1,143 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string_view>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+static size_t HashData(const SkData& data,
+                       const std::vector<int64_t>& parameters) {
+  size_t hash = std::hash<std::string_view>()(std::string_view(
+      reinterpret_cast<const char*>(data.data()), data.size()));
+  for (int64_t parameter : parameters) {
+    hash = hash * 31 + std::hash<int64_t>()(parameter);
+  }
+  return hash;
+}
+
+DecodedImageCache::Key::Key(sk_sp<SkData> data,
+                            std::vector<int64_t> parameters)
+    : data_(std::move(data)),
+      parameters_(std::move(parameters)),
+      hash_(HashData(*data_, parameters_)) {}
+
+DecodedImageCache::Key::Key(const Key& other) = default;
+
+DecodedImageCache::Key::~Key() = default;
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  // Compare the data as well since different data may have the same hash.
+  return hash_ == other.hash_ && parameters_ == other.parameters_ &&
+         data_->equals(other.data_.get());
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+DecodedImageCache::~DecodedImageCache() = default;
+
+DecodedImageCache::LookupResult DecodedImageCache::Lookup(
+    const Key& key,
+    SkiaGPUObject<SkImage>* image,
+    Callback pending) {
+  TRACE_EVENT0("flutter", "DecodedImageCache::Lookup");
+  std::scoped_lock lock(mutex_);
+
+  auto found = entry_index_.find(key);
+  if (found != entry_index_.end()) {
+    hit_count_++;
+    TraceCountersLocked();
+    // Move the entry to the front as it is now the most recently used one.
+    entries_.splice(entries_.begin(), entries_, found->second);
+    *image = {found->second->image.get(), found->second->queue};
+    return LookupResult::kHit;
+  }
+
+  miss_count_++;
+  TraceCountersLocked();
+  auto decode = pending_decodes_.find(key);
+  if (decode != pending_decodes_.end()) {
+    decode->second.push_back(std::move(pending));
+    return LookupResult::kPending;
+  }
+
+  pending_decodes_.emplace(key, std::vector<Callback>{});
+  return LookupResult::kMiss;
+}
+
+void DecodedImageCache::FinishDecode(const Key& key,
+                                     sk_sp<SkImage> image,
+                                     fml::RefPtr<SkiaUnrefQueue> queue) {
+  std::vector<Callback> pending;
+  {
+    std::scoped_lock lock(mutex_);
+    auto decode = pending_decodes_.find(key);
+    if (decode != pending_decodes_.end()) {
+      pending = std::move(decode->second);
+      pending_decodes_.erase(decode);
+    }
+
+    const size_t bytes =
+        image ? image->imageInfo().computeMinByteSize() + key.GetDataSize()
+              : 0;
+    if (image && bytes <= max_bytes_ &&
+        entry_index_.find(key) == entry_index_.end()) {
+      while (!entries_.empty() && cached_bytes_ + bytes > max_bytes_) {
+        cached_bytes_ -= entries_.back().bytes;
+        entry_index_.erase(entries_.back().key);
+        entries_.pop_back();
+      }
+      entries_.push_front({key, {image, queue}, queue, bytes});
+      entry_index_.emplace(key, entries_.begin());
+      cached_bytes_ += bytes;
+      TraceCountersLocked();
+    }
+  }
+
+  for (auto& callback : pending) {
+    if (image) {
+      callback({image, queue});
+    } else {
+      callback({});
+    }
+  }
+}
+
+size_t DecodedImageCache::GetCachedImageCount() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.size();
+}
+
+size_t DecodedImageCache::GetCachedBytes() const {
+  std::scoped_lock lock(mutex_);
+  return cached_bytes_;
+}
+
+size_t DecodedImageCache::GetHitCount() const {
+  std::scoped_lock lock(mutex_);
+  return hit_count_;
+}
+
+size_t DecodedImageCache::GetMissCount() const {
+  std::scoped_lock lock(mutex_);
+  return miss_count_;
+}
+
+void DecodedImageCache::TraceCountersLocked() const {
+  FML_TRACE_COUNTER("flutter", "DecodedImageCache",
+                    reinterpret_cast<int64_t>(this),   //
+                    "Hits", hit_count_,                //
+                    "Misses", miss_count_,             //
+                    "ImageCount", entries_.size(),     //
+                    "MBytes", cached_bytes_ * 1e-6,    //
+                    "BudgetMBytes", max_bytes_ * 1e-6  //
+  );
+}
+
+}  // namespace flutter
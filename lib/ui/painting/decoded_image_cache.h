@@ -0,0 +1,142 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/thread_annotations.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Keeps the images decoded by the image decoder, so that decoding the same
+/// bytes with the same parameters again does not repeat the decompression,
+/// resize and texture upload.
+///
+/// Images are keyed by a hash of their encoded or decompressed bytes and the
+/// parameters they were decoded with. The least recently used images are
+/// evicted once the cache exceeds its byte budget. Requests for an image that
+/// is still being decoded wait for that decode instead of starting another.
+///
+/// The cache may be used on any thread.
+///
+class DecodedImageCache {
+ public:
+  class Key {
+   public:
+    //--------------------------------------------------------------------------
+    /// @brief      Hashes the data. This is linear in its size, so keys should
+    ///             not be created on the UI thread.
+    ///
+    /// @param[in]  data        The bytes the image is decoded from.
+    /// @param[in]  parameters  Everything besides the data that determines
+    ///                         the decoded image, such as its target size.
+    ///
+    Key(sk_sp<SkData> data, std::vector<int64_t> parameters);
+
+    Key(const Key& other);
+
+    ~Key();
+
+    size_t GetHash() const { return hash_; }
+
+    size_t GetDataSize() const { return data_->size(); }
+
+    bool operator==(const Key& other) const;
+
+   private:
+    sk_sp<SkData> data_;
+    std::vector<int64_t> parameters_;
+    size_t hash_;
+  };
+
+  using Callback = std::function<void(SkiaGPUObject<SkImage>)>;
+
+  enum class LookupResult {
+    // The image was cached.
+    kHit,
+    // The image is being decoded. The callback is invoked with the result.
+    kPending,
+    // The caller must decode the image and report it with |FinishDecode|.
+    kMiss,
+  };
+
+  explicit DecodedImageCache(size_t max_bytes);
+
+  ~DecodedImageCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up the image for a key.
+  ///
+  /// @param[in]  key      The key of the image.
+  /// @param[out] image    Set to the image on a hit.
+  /// @param[in]  pending  Invoked with the image once it is decoded if
+  ///                      another caller is decoding it already. Discarded
+  ///                      otherwise.
+  ///
+  LookupResult Lookup(const Key& key,
+                      SkiaGPUObject<SkImage>* image,
+                      Callback pending);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Caches the image decoded after a miss and hands it to the
+  ///             callers waiting for it. A null image reports that decoding
+  ///             failed.
+  ///
+  void FinishDecode(const Key& key,
+                    sk_sp<SkImage> image,
+                    fml::RefPtr<SkiaUnrefQueue> queue);
+
+  size_t GetCachedImageCount() const;
+
+  size_t GetCachedBytes() const;
+
+  size_t GetHitCount() const;
+
+  size_t GetMissCount() const;
+
+ private:
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.GetHash(); }
+  };
+
+  struct Entry {
+    Key key;
+    SkiaGPUObject<SkImage> image;
+    fml::RefPtr<SkiaUnrefQueue> queue;
+    size_t bytes;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  const size_t max_bytes_;
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  EntryList entries_ FML_GUARDED_BY(mutex_);
+  std::unordered_map<Key, EntryList::iterator, KeyHash> entry_index_
+      FML_GUARDED_BY(mutex_);
+  std::unordered_map<Key, std::vector<Callback>, KeyHash> pending_decodes_
+      FML_GUARDED_BY(mutex_);
+  size_t cached_bytes_ FML_GUARDED_BY(mutex_) = 0;
+  size_t hit_count_ FML_GUARDED_BY(mutex_) = 0;
+  size_t miss_count_ FML_GUARDED_BY(mutex_) = 0;
+
+  void TraceCountersLocked() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
@@ -0,0 +1,123 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <vector>
+
+#include "flutter/testing/thread_test.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+using DecodedImageCacheTest = ThreadTest;
+
+static sk_sp<SkData> MakeData(uint8_t value) {
+  std::vector<uint8_t> bytes(16, value);
+  return SkData::MakeWithCopy(bytes.data(), bytes.size());
+}
+
+// A 10x10 N32 image takes 400 bytes.
+static sk_sp<SkImage> MakeImage() {
+  auto surface = SkSurface::MakeRasterN32Premul(10, 10);
+  surface->getCanvas()->clear(SK_ColorRED);
+  return surface->makeImageSnapshot();
+}
+
+TEST_F(DecodedImageCacheTest, KeysCompareDataAndParameters) {
+  DecodedImageCache::Key key(MakeData(1), {100, -1});
+  ASSERT_EQ(key, DecodedImageCache::Key(MakeData(1), {100, -1}));
+  ASSERT_EQ(key.GetHash(),
+            DecodedImageCache::Key(MakeData(1), {100, -1}).GetHash());
+  ASSERT_FALSE(key == DecodedImageCache::Key(MakeData(2), {100, -1}));
+  ASSERT_FALSE(key == DecodedImageCache::Key(MakeData(1), {-1, 100}));
+}
+
+TEST_F(DecodedImageCacheTest, MissesUntilDecodeFinishes) {
+  auto queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      GetThreadTaskRunner(), fml::TimeDelta::FromNanoseconds(0));
+  DecodedImageCache cache(10000);
+  DecodedImageCache::Key key(MakeData(1), {});
+
+  SkiaGPUObject<SkImage> image;
+  ASSERT_EQ(cache.Lookup(key, &image, nullptr),
+            DecodedImageCache::LookupResult::kMiss);
+
+  std::vector<sk_sp<SkImage>> delivered;
+  auto pending = [&](SkiaGPUObject<SkImage> image) {
+    delivered.push_back(image.get());
+  };
+  ASSERT_EQ(cache.Lookup(key, &image, pending),
+            DecodedImageCache::LookupResult::kPending);
+  ASSERT_EQ(cache.Lookup(key, &image, pending),
+            DecodedImageCache::LookupResult::kPending);
+
+  auto decoded = MakeImage();
+  cache.FinishDecode(key, decoded, queue);
+  ASSERT_EQ(delivered, (std::vector<sk_sp<SkImage>>{decoded, decoded}));
+
+  ASSERT_EQ(cache.Lookup(key, &image, nullptr),
+            DecodedImageCache::LookupResult::kHit);
+  ASSERT_EQ(image.get(), decoded);
+  ASSERT_EQ(cache.GetHitCount(), 1u);
+  ASSERT_EQ(cache.GetMissCount(), 3u);
+  ASSERT_EQ(cache.GetCachedBytes(), 400u + 16u);
+}
+
+TEST_F(DecodedImageCacheTest, FailedDecodesAreNotCached) {
+  DecodedImageCache cache(10000);
+  DecodedImageCache::Key key(MakeData(1), {});
+
+  SkiaGPUObject<SkImage> image;
+  ASSERT_EQ(cache.Lookup(key, &image, nullptr),
+            DecodedImageCache::LookupResult::kMiss);
+  bool delivered_failure = false;
+  ASSERT_EQ(cache.Lookup(key, &image,
+                         [&](SkiaGPUObject<SkImage> result) {
+                           delivered_failure = !result.get();
+                         }),
+            DecodedImageCache::LookupResult::kPending);
+  cache.FinishDecode(key, nullptr, nullptr);
+  ASSERT_TRUE(delivered_failure);
+
+  ASSERT_EQ(cache.Lookup(key, &image, nullptr),
+            DecodedImageCache::LookupResult::kMiss);
+  ASSERT_EQ(cache.GetCachedImageCount(), 0u);
+}
+
+TEST_F(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  auto queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      GetThreadTaskRunner(), fml::TimeDelta::FromNanoseconds(0));
+  // Fits two images.
+  DecodedImageCache cache(1000);
+  DecodedImageCache::Key first(MakeData(1), {});
+  DecodedImageCache::Key second(MakeData(2), {});
+  DecodedImageCache::Key third(MakeData(3), {});
+
+  SkiaGPUObject<SkImage> image;
+  for (const auto& key : {first, second}) {
+    cache.Lookup(key, &image, nullptr);
+    cache.FinishDecode(key, MakeImage(), queue);
+  }
+
+  // Makes the second image the least recently used one.
+  ASSERT_EQ(cache.Lookup(first, &image, nullptr),
+            DecodedImageCache::LookupResult::kHit);
+
+  cache.Lookup(third, &image, nullptr);
+  cache.FinishDecode(third, MakeImage(), queue);
+
+  ASSERT_EQ(cache.GetCachedImageCount(), 2u);
+  ASSERT_LE(cache.GetCachedBytes(), 1000u);
+  ASSERT_EQ(cache.Lookup(first, &image, nullptr),
+            DecodedImageCache::LookupResult::kHit);
+  ASSERT_EQ(cache.Lookup(third, &image, nullptr),
+            DecodedImageCache::LookupResult::kHit);
+  ASSERT_EQ(cache.Lookup(second, &image, nullptr),
+            DecodedImageCache::LookupResult::kMiss);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -15,18 +15,33 @@ using tonic::ToDart;
 
 namespace flutter {
 
-EngineLayer::EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer)
-    : layer_(layer) {}
+EngineLayer::EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer,
+                         std::shared_ptr<flutter::LayerArena> arena)
+    : layer_(layer), arena_(std::move(arena)) {}
 
 EngineLayer::~EngineLayer() = default;
 
 size_t EngineLayer::GetAllocationSize() {
   // Provide an approximation of the total memory impact of this object to the
-  // Dart GC.  The ContainerLayer may hold references to a tree of other layers,
-  // which in turn may contain Skia objects.
-  return 3000;
+  // Dart GC. A layer in an arena keeps all layers of its scene alive. Otherwise
+  // the ContainerLayer holds a tree of other layers, which in turn may contain
+  // Skia objects.
+  return arena_ ? arena_->GetAllocatedBytes() : 3000;
 };
 
+void EngineLayer::PromoteOutOfArena() {
+  if (!arena_) {
+    return;
+  }
+  auto clone = layer_->Clone();
+  if (!clone) {
+    return;
+  }
+  // Copies have the same type as the layer they were made from.
+  layer_ = std::static_pointer_cast<flutter::ContainerLayer>(std::move(clone));
+  arena_ = nullptr;
+}
+
 IMPLEMENT_WRAPPERTYPEINFO(ui, EngineLayer);
 
 #define FOR_EACH_BINDING(V)  // nothing to bind
@@ -8,6 +8,7 @@
 #include "flutter/lib/ui/dart_wrapper.h"
 
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 
 namespace tonic {
 class DartLibraryNatives;
@@ -25,18 +26,27 @@ class EngineLayer : public RefCountedDartWrappable<EngineLayer> {
 
   size_t GetAllocationSize() override;
 
+  // |arena| is the arena that owns |layer|, if any.
   static fml::RefPtr<EngineLayer> MakeRetained(
-      std::shared_ptr<flutter::ContainerLayer> layer) {
-    return fml::MakeRefCounted<EngineLayer>(layer);
+      std::shared_ptr<flutter::ContainerLayer> layer,
+      std::shared_ptr<flutter::LayerArena> arena = nullptr) {
+    return fml::MakeRefCounted<EngineLayer>(layer, arena);
   }
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
   std::shared_ptr<flutter::ContainerLayer> Layer() const { return layer_; }
 
+  // Replaces the layer with an individually owned copy, so that retaining it
+  // no longer keeps the arena of the scene it was built in alive. Does nothing
+  // if the layer is not owned by an arena or cannot be copied.
+  void PromoteOutOfArena();
+
  private:
-  explicit EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer);
+  EngineLayer(std::shared_ptr<flutter::ContainerLayer> layer,
+              std::shared_ptr<flutter::LayerArena> arena);
   std::shared_ptr<flutter::ContainerLayer> layer_;
+  std::shared_ptr<flutter::LayerArena> arena_;
 
   FML_FRIEND_MAKE_REF_COUNTED(EngineLayer);
 };
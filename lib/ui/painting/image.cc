@@ -32,8 +32,10 @@ CanvasImage::CanvasImage() = default;
 
 CanvasImage::~CanvasImage() = default;
 
-Dart_Handle CanvasImage::toByteData(int format, Dart_Handle callback) {
-  return EncodeImage(this, format, callback);
+Dart_Handle CanvasImage::toByteData(int format,
+                                    int quality,
+                                    Dart_Handle callback) {
+  return EncodeImage(this, format, quality, callback);
 }
 
 void CanvasImage::dispose() {
@@ -30,7 +30,7 @@ class CanvasImage final : public RefCountedDartWrappable<CanvasImage> {
 
   int height() { return image_.get()->height(); }
 
-  Dart_Handle toByteData(int format, Dart_Handle callback);
+  Dart_Handle toByteData(int format, int quality, Dart_Handle callback);
 
   void dispose();
 
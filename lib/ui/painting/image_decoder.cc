@@ -4,19 +4,30 @@
 
 #include "flutter/lib/ui/painting/image_decoder.h"
 
+#include <algorithm>
+
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/codec/SkAndroidCodec.h"
 #include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/codec/SkEncodedOrigin.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 
 ImageDecoder::ImageDecoder(
     TaskRunners runners,
     std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-    fml::WeakPtr<IOManager> io_manager)
+    fml::WeakPtr<IOManager> io_manager,
+    size_t decoded_image_cache_max_bytes)
     : runners_(std::move(runners)),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
       io_manager_(std::move(io_manager)),
+      decoded_image_cache_(decoded_image_cache_max_bytes > 0
+                               ? std::make_shared<DecodedImageCache>(
+                                     decoded_image_cache_max_bytes)
+                               : nullptr),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
@@ -112,6 +123,7 @@ static sk_sp<SkImage> ImageFromDecompressedData(
     ImageDecoder::ImageInfo info,
     std::optional<uint32_t> target_width,
     std::optional<uint32_t> target_height,
+    std::optional<SkIRect> target_subset,
     const fml::tracing::TraceFlow& flow) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
@@ -122,13 +134,25 @@ static sk_sp<SkImage> ImageFromDecompressedData(
     return nullptr;
   }
 
+  if (target_subset) {
+    // Shares the pixels of the image.
+    image = image->makeSubset(target_subset.value());
+    if (!image) {
+      FML_LOG(ERROR) << "Subset to decode was outside of the image.";
+      return nullptr;
+    }
+  }
+
   return ResizeRasterImage(std::move(image), target_width, target_height, flow);
 }
 
-static sk_sp<SkImage> ImageFromCompressedData(
+// Decodes the entire image before resizing it. Used for images the sampling
+// codec does not support.
+static sk_sp<SkImage> ImageFromCompressedDataAtFullSize(
     sk_sp<SkData> data,
     std::optional<uint32_t> target_width,
     std::optional<uint32_t> target_height,
+    std::optional<SkIRect> target_subset,
     const fml::tracing::TraceFlow& flow) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   flow.Step(__FUNCTION__);
@@ -146,9 +170,208 @@ static sk_sp<SkImage> ImageFromCompressedData(
     return nullptr;
   }
 
+  if (target_subset) {
+    decoded_image = decoded_image->makeSubset(target_subset.value());
+    if (!decoded_image) {
+      FML_LOG(ERROR) << "Subset to decode was outside of the image.";
+      return nullptr;
+    }
+  }
+
   return ResizeRasterImage(decoded_image, target_width, target_height, flow);
 }
 
+// The largest power of two sample size at which the codec still decodes at
+// least the given dimensions. Decoding at this size keeps the memory used by
+// the decode proportional to the target size instead of the image size.
+static int ComputeSampleSize(const SkAndroidCodec& codec,
+                             const SkIRect& subset,
+                             const SkISize& target_dimensions) {
+  const bool is_full_image = subset == codec.getInfo().bounds();
+  int sample_size = 1;
+  while (true) {
+    const int next_sample_size = sample_size * 2;
+    const SkISize sampled_dimensions =
+        is_full_image
+            ? codec.getSampledDimensions(next_sample_size)
+            : codec.getSampledSubsetDimensions(next_sample_size, subset);
+    if (sampled_dimensions.isEmpty() ||
+        sampled_dimensions.width() < target_dimensions.width() ||
+        sampled_dimensions.height() < target_dimensions.height() ||
+        next_sample_size > std::min(subset.width(), subset.height())) {
+      return sample_size;
+    }
+    sample_size = next_sample_size;
+  }
+}
+
+static sk_sp<SkImage> ImageFromCompressedData(
+    sk_sp<SkData> data,
+    std::optional<uint32_t> target_width,
+    std::optional<uint32_t> target_height,
+    std::optional<SkIRect> target_subset,
+    const fml::tracing::TraceFlow& flow) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  flow.Step(__FUNCTION__);
+
+  auto codec = SkAndroidCodec::MakeFromData(data);
+  if (!codec) {
+    return ImageFromCompressedDataAtFullSize(std::move(data), target_width,
+                                             target_height, target_subset,
+                                             flow);
+  }
+
+  // The codec decodes the image as encoded. Its orientation is applied after.
+  const SkEncodedOrigin origin = codec->codec()->getOrigin();
+  const SkISize encoded_dimensions = codec->getInfo().dimensions();
+  const SkMatrix orientation = SkEncodedOriginToMatrix(
+      origin, encoded_dimensions.width(), encoded_dimensions.height());
+  SkMatrix inverse_orientation;
+  if (!orientation.invert(&inverse_orientation)) {
+    return nullptr;
+  }
+
+  // The region to decode in the coordinates of the encoded image.
+  SkIRect source = codec->getInfo().bounds();
+  if (target_subset) {
+    SkRect oriented_bounds;
+    orientation.mapRect(&oriented_bounds, SkRect::Make(source));
+    if (!oriented_bounds.round().contains(target_subset.value()) ||
+        target_subset->isEmpty()) {
+      FML_LOG(ERROR) << "Subset to decode was outside of the image.";
+      return nullptr;
+    }
+    SkRect encoded_subset;
+    inverse_orientation.mapRect(&encoded_subset,
+                                SkRect::Make(target_subset.value()));
+    source = encoded_subset.round();
+  }
+
+  const bool swaps_dimensions = SkEncodedOriginSwapsWidthHeight(origin);
+  const SkISize oriented_source_dimensions =
+      swaps_dimensions ? SkISize::Make(source.height(), source.width())
+                       : source.size();
+  const SkISize resized_dimensions = GetResizedDimensions(
+      oriented_source_dimensions, target_width, target_height);
+  if (resized_dimensions.isEmpty()) {
+    FML_LOG(ERROR) << "Could not resize to empty dimensions.";
+    return nullptr;
+  }
+
+  // Codecs can only decode regions with certain alignments. Decode the
+  // smallest supported region around the source.
+  SkIRect supported_source = source;
+  if (source != codec->getInfo().bounds() &&
+      !codec->getSupportedSubset(&supported_source)) {
+    return ImageFromCompressedDataAtFullSize(std::move(data), target_width,
+                                             target_height, target_subset,
+                                             flow);
+  }
+  if (!supported_source.contains(source)) {
+    supported_source = codec->getInfo().bounds();
+  }
+
+  const int sample_size = ComputeSampleSize(
+      *codec, supported_source,
+      swaps_dimensions ? SkISize::Make(resized_dimensions.height(),
+                                       resized_dimensions.width())
+                       : resized_dimensions);
+  const SkISize sampled_dimensions =
+      supported_source == codec->getInfo().bounds()
+          ? codec->getSampledDimensions(sample_size)
+          : codec->getSampledSubsetDimensions(sample_size, supported_source);
+
+  // Like lazily decoded images, keep the color type and space of the image
+  // but premultiply its alpha.
+  SkImageInfo info = codec->getInfo().makeWH(sampled_dimensions.width(),
+                                             sampled_dimensions.height());
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(info)) {
+    FML_LOG(ERROR) << "Could not allocate bitmap to decode into.";
+    return nullptr;
+  }
+
+  SkAndroidCodec::AndroidOptions options;
+  options.fSampleSize = sample_size;
+  if (supported_source != codec->getInfo().bounds()) {
+    options.fSubset = &supported_source;
+  }
+
+  {
+    TRACE_EVENT1("flutter", "SkAndroidCodec::getAndroidPixels", "sample_size",
+                 std::to_string(sample_size).c_str());
+    switch (codec->getAndroidPixels(info, bitmap.getPixels(),
+                                    bitmap.rowBytes(), &options)) {
+      case SkCodec::kSuccess:
+      case SkCodec::kIncompleteInput:
+      case SkCodec::kErrorInInput:
+        // Like lazily decoded images, show what could be decoded of
+        // truncated or corrupt images.
+        break;
+      default:
+        return ImageFromCompressedDataAtFullSize(std::move(data), target_width,
+                                                 target_height, target_subset,
+                                                 flow);
+    }
+  }
+
+  // Marking this as immutable makes the MakeFromBitmap call share the pixels
+  // instead of copying.
+  bitmap.setImmutable();
+  auto sampled_image = SkImage::MakeFromBitmap(bitmap);
+  if (!sampled_image) {
+    FML_LOG(ERROR) << "Could not create an image from the decoded bitmap.";
+    return nullptr;
+  }
+
+  if (origin == kTopLeft_SkEncodedOrigin && supported_source == source) {
+    // The common case. Only the resize is left.
+    return ResizeRasterImage(std::move(sampled_image),
+                             resized_dimensions.width(),
+                             resized_dimensions.height(), flow);
+  }
+
+  // Crop, orient and resize the decoded region in a single draw.
+  TRACE_EVENT0("flutter", "OrientDecodedImage");
+  const float sampled_scale_x =
+      static_cast<float>(sampled_dimensions.width()) /
+      supported_source.width();
+  const float sampled_scale_y =
+      static_cast<float>(sampled_dimensions.height()) /
+      supported_source.height();
+  const SkRect sampled_source = SkRect::MakeXYWH(
+      (source.x() - supported_source.x()) * sampled_scale_x,
+      (source.y() - supported_source.y()) * sampled_scale_y,
+      source.width() * sampled_scale_x, source.height() * sampled_scale_y);
+
+  auto surface = SkSurface::MakeRaster(SkImageInfo::MakeN32(
+      resized_dimensions.width(), resized_dimensions.height(),
+      info.alphaType(), info.refColorSpace()));
+  if (!surface) {
+    FML_LOG(ERROR) << "Could not create a surface to orient the image into.";
+    return nullptr;
+  }
+
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->scale(
+      static_cast<float>(resized_dimensions.width()) /
+          oriented_source_dimensions.width(),
+      static_cast<float>(resized_dimensions.height()) /
+          oriented_source_dimensions.height());
+  canvas->concat(
+      SkEncodedOriginToMatrix(origin, source.width(), source.height()));
+  SkPaint paint;
+  paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas->drawImageRect(sampled_image, sampled_source,
+                        SkRect::MakeWH(source.width(), source.height()),
+                        &paint);
+  return surface->makeImageSnapshot();
+}
+
 static SkiaGPUObject<SkImage> UploadRasterImage(
     sk_sp<SkImage> image,
     fml::WeakPtr<GrContext> context,
@@ -189,6 +412,28 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return {texture_image, queue};
 }
 
+static DecodedImageCache::Key MakeDecodedImageCacheKey(
+    const ImageDecoder::ImageDescriptor& descriptor) {
+  std::vector<int64_t> parameters = {
+      descriptor.target_width.value_or(-1),
+      descriptor.target_height.value_or(-1),
+  };
+  if (descriptor.target_subset) {
+    const SkIRect& subset = descriptor.target_subset.value();
+    parameters.insert(parameters.end(), {subset.left(), subset.top(),
+                                         subset.right(), subset.bottom()});
+  }
+  // The same bytes are a different image if they are interpreted differently.
+  if (descriptor.decompressed_image_info) {
+    const auto& info = descriptor.decompressed_image_info.value();
+    parameters.insert(parameters.end(),
+                      {info.sk_info.width(), info.sk_info.height(),
+                       info.sk_info.colorType(), info.sk_info.alphaType(),
+                       static_cast<int64_t>(info.row_bytes)});
+  }
+  return {descriptor.data, std::move(parameters)};
+}
+
 void ImageDecoder::Decode(ImageDescriptor descriptor, ImageResult callback) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
@@ -219,9 +464,47 @@ void ImageDecoder::Decode(ImageDescriptor descriptor, ImageResult callback) {
       fml::MakeCopyable([descriptor,                              //
                          io_manager = io_manager_,                //
                          io_runner = runners_.GetIOTaskRunner(),  //
+                         cache = decoded_image_cache_,            //
                          result,                                  //
                          flow = std::move(flow)                   //
   ]() mutable {
+        // Step 0: Look for the image in the cache.
+        // On Worker.
+
+        std::optional<DecodedImageCache::Key> cache_key;
+        if (cache) {
+          cache_key = MakeDecodedImageCacheKey(descriptor);
+          SkiaGPUObject<SkImage> cached;
+          switch (cache->Lookup(
+              cache_key.value(), &cached,
+              [result](SkiaGPUObject<SkImage> image) {
+                result(std::move(image),
+                       fml::tracing::TraceFlow("ImageDecoder::DecodePending"));
+              })) {
+            case DecodedImageCache::LookupResult::kHit:
+              result(std::move(cached), std::move(flow));
+              return;
+            case DecodedImageCache::LookupResult::kPending: {
+              // The decode that is already underway delivers the image.
+              TRACE_EVENT0("flutter", "WaitForPendingDecode");
+              flow.End();
+              return;
+            }
+            case DecodedImageCache::LookupResult::kMiss:
+              break;
+          }
+        }
+
+        // Every miss must be reported to the cache so that the callers waiting
+        // for the image are serviced, whether the decode succeeds or not.
+        auto finish = [cache, cache_key](const SkiaGPUObject<SkImage>& image,
+                                         fml::RefPtr<SkiaUnrefQueue> queue) {
+          if (cache) {
+            cache->FinishDecode(cache_key.value(), image.get(),
+                                std::move(queue));
+          }
+        };
+
         // Step 1: Decompress the image.
         // On Worker.
 
@@ -232,15 +515,18 @@ void ImageDecoder::Decode(ImageDescriptor descriptor, ImageResult callback) {
                       descriptor.decompressed_image_info.value(),  //
                       descriptor.target_width,                     //
                       descriptor.target_height,                    //
+                      descriptor.target_subset,                    //
                       flow                                         //
                       )
                 : ImageFromCompressedData(std::move(descriptor.data),  //
                                           descriptor.target_width,     //
                                           descriptor.target_height,    //
+                                          descriptor.target_subset,    //
                                           flow);
 
         if (!decompressed) {
           FML_LOG(ERROR) << "Could not decompress image.";
+          finish({}, nullptr);
           result({}, std::move(flow));
           return;
         }
@@ -249,10 +535,12 @@ void ImageDecoder::Decode(ImageDescriptor descriptor, ImageResult callback) {
         // On IO Thread.
 
         io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
+                                               finish,
                                                flow =
                                                    std::move(flow)]() mutable {
           if (!io_manager) {
             FML_LOG(ERROR) << "Could not acquire IO manager.";
+            finish({}, nullptr);
             return result({}, std::move(flow));
           }
 
@@ -260,8 +548,10 @@ void ImageDecoder::Decode(ImageDescriptor descriptor, ImageResult callback) {
           // might not have set one or a software backend could be in use.
           // Either way, just return the image as-is.
           if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
+            SkiaGPUObject<SkImage> image = {std::move(decompressed),
+                                            io_manager->GetSkiaUnrefQueue()};
+            finish(image, io_manager->GetSkiaUnrefQueue());
+            result(std::move(image), std::move(flow));
             return;
           }
 
@@ -271,11 +561,13 @@ void ImageDecoder::Decode(ImageDescriptor descriptor, ImageResult callback) {
 
           if (!uploaded.get()) {
             FML_LOG(ERROR) << "Could not upload image to the GPU.";
+            finish({}, nullptr);
             result({}, std::move(flow));
             return;
           }
 
           // Finally, all done.
+          finish(uploaded, io_manager->GetSkiaUnrefQueue());
           result(std::move(uploaded), std::move(flow));
         }));
       }));
@@ -285,4 +577,13 @@ fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
 
+std::shared_ptr<fml::ConcurrentTaskRunner>
+ImageDecoder::GetConcurrentTaskRunner() const {
+  return concurrent_task_runner_;
+}
+
+const DecodedImageCache* ImageDecoder::GetDecodedImageCache() const {
+  return decoded_image_cache_.get();
+}
+
 }  // namespace flutter
@@ -14,9 +14,11 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -32,7 +34,8 @@ class ImageDecoder {
   ImageDecoder(
       TaskRunners runners,
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
-      fml::WeakPtr<IOManager> io_manager);
+      fml::WeakPtr<IOManager> io_manager,
+      size_t decoded_image_cache_max_bytes = 0);
 
   ~ImageDecoder();
 
@@ -46,6 +49,10 @@ class ImageDecoder {
     std::optional<ImageInfo> decompressed_image_info;
     std::optional<uint32_t> target_width;
     std::optional<uint32_t> target_height;
+    // The region of the image to decode, in the coordinates of the image
+    // after its orientation is applied. The target dimensions apply to the
+    // region. Only the region is decompressed if the codec supports it.
+    std::optional<SkIRect> target_subset;
   };
 
   using ImageResult = std::function<void(SkiaGPUObject<SkImage>)>;
@@ -54,15 +61,25 @@ class ImageDecoder {
   // GPU. All image decompression and resizes are done on a worker thread
   // concurrently. Texture upload is done on the IO thread and the result
   // returned back on the UI thread. On error, the texture is null but the
-  // callback is guaranteed to return on the UI thread.
+  // callback is guaranteed to return on the UI thread. If the decoder has a
+  // decoded image cache, images decoded from the same bytes with the same
+  // parameters are shared instead.
   void Decode(ImageDescriptor descriptor, ImageResult result);
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
+  // The worker pool images are decoded on. Image encoding shares it.
+  std::shared_ptr<fml::ConcurrentTaskRunner> GetConcurrentTaskRunner() const;
+
+  // Null if decoded images are not cached.
+  const DecodedImageCache* GetDecodedImageCache() const;
+
  private:
   TaskRunners runners_;
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
   fml::WeakPtr<IOManager> io_manager_;
+  // Null if decoded images are not cached.
+  std::shared_ptr<DecodedImageCache> decoded_image_cache_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -354,6 +356,78 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   ASSERT_EQ(decoded_size(100, 100), SkISize::Make(100, 100));
 }
 
+TEST_F(ImageDecoderFixtureTest, CanDecodeSubsets) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),    // label
+                      GetThreadTaskRunner(),   // platform
+                      CreateNewThread("gpu"),  // gpu
+                      CreateNewThread("ui"),   // ui
+                      CreateNewThread("io")    // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  // Setup the IO manager.
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Setup the image decoder.
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager());
+
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Decodes a subset of the fixture and gives us the final decoded size, or
+  // an empty size if decoding failed.
+  auto decoded_size = [&](const char* fixture, SkIRect subset,
+                          std::optional<uint32_t> target_width) -> SkISize {
+    SkISize final_size = SkISize::MakeEmpty();
+    runners.GetUITaskRunner()->PostTask([&]() {
+      ImageDecoder::ImageDescriptor image_descriptor;
+      image_descriptor.target_width = target_width;
+      image_descriptor.target_subset = subset;
+      image_descriptor.data = OpenFixtureAsSkData(fixture);
+
+      ASSERT_TRUE(image_descriptor.data);
+
+      ImageDecoder::ImageResult callback = [&](SkiaGPUObject<SkImage> image) {
+        ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+        if (image.get()) {
+          final_size = image.get()->dimensions();
+        }
+        latch.Signal();
+      };
+      image_decoder->Decode(std::move(image_descriptor), callback);
+    });
+    latch.Wait();
+    return final_size;
+  };
+
+  // The fixture is 3024x4032.
+  ASSERT_EQ(decoded_size("DashInNooglerHat.jpg",
+                         SkIRect::MakeXYWH(1000, 1000, 1500, 2000), {}),
+            SkISize::Make(1500, 2000));
+  ASSERT_EQ(decoded_size("DashInNooglerHat.jpg",
+                         SkIRect::MakeXYWH(1000, 1000, 1500, 2000), 150),
+            SkISize::Make(150, 200));
+  ASSERT_TRUE(decoded_size("DashInNooglerHat.jpg",
+                           SkIRect::MakeXYWH(2000, 3000, 1500, 2000), {})
+                  .isEmpty());
+
+  // Subsets apply to the image after its EXIF orientation is applied.
+  ASSERT_EQ(decoded_size("Horizontal.jpg", SkIRect::MakeXYWH(0, 0, 300, 200),
+                         {}),
+            SkISize::Make(300, 200));
+}
+
 TEST_F(ImageDecoderFixtureTest, CanResizeWithoutDecode) {
   ImageDecoder::ImageInfo info = {};
   sk_sp<SkData> decompressed_data;
@@ -440,5 +514,79 @@ TEST_F(ImageDecoderFixtureTest, CanResizeWithoutDecode) {
   ASSERT_EQ(decoded_size(100, 100), SkISize::Make(100, 100));
 }
 
+TEST_F(ImageDecoderFixtureTest, SharesImagesDecodedFromTheSameData) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),    // label
+                      GetThreadTaskRunner(),   // platform
+                      CreateNewThread("gpu"),  // gpu
+                      CreateNewThread("ui"),   // ui
+                      CreateNewThread("io")    // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager =
+        std::make_unique<TestIOManager>(runners.GetIOTaskRunner(), false);
+    latch.Signal();
+  });
+  latch.Wait();
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager(),
+        64 * 1024 * 1024);
+    latch.Signal();
+  });
+  latch.Wait();
+
+  // Decodes the fixture |count| times at once.
+  auto decode = [&](size_t count) {
+    std::vector<sk_sp<SkImage>> images;
+    runners.GetUITaskRunner()->PostTask([&]() {
+      auto data = OpenFixtureAsSkData("Horizontal.jpg");
+      ASSERT_TRUE(data);
+      for (size_t i = 0; i < count; i++) {
+        ImageDecoder::ImageDescriptor image_descriptor;
+        image_descriptor.data = data;
+        image_decoder->Decode(std::move(image_descriptor),
+                              [&, count](SkiaGPUObject<SkImage> image) {
+                                ASSERT_TRUE(image.get());
+                                images.push_back(image.get());
+                                if (images.size() == count) {
+                                  latch.Signal();
+                                }
+                              });
+      }
+    });
+    latch.Wait();
+    return images;
+  };
+
+  // Concurrent requests wait for the first decode unless it has already
+  // finished.
+  auto first = decode(3);
+  ASSERT_EQ(first[0], first[1]);
+  ASSERT_EQ(first[0], first[2]);
+
+  // Later requests are served from the cache.
+  auto second = decode(1);
+  ASSERT_EQ(second[0], first[0]);
+
+  const auto* cache = image_decoder->GetDecodedImageCache();
+  ASSERT_NE(cache, nullptr);
+  ASSERT_EQ(cache->GetCachedImageCount(), 1u);
+  ASSERT_GE(cache->GetHitCount(), 1u);
+  ASSERT_EQ(cache->GetHitCount() + cache->GetMissCount(), 4u);
+
+  runners.GetUITaskRunner()->PostTask([&]() {
+    image_decoder.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/painting/image_encoding.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -12,14 +13,17 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/painting/image_encoding_buffer_pool.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageEncoder.h"
+#include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
-#include "third_party/tonic/typed_data/typed_list.h"
 
 using tonic::DartInvoke;
 using tonic::DartPersistentValue;
@@ -33,171 +37,270 @@ enum ImageByteFormat {
   kRawRGBA,
   kRawUnmodified,
   kPNG,
+  kJPEG,
+  kWEBP,
 };
 
+using Buffer = ImageEncodingBufferPool::Buffer;
+
+// The pixels of an image in memory that any thread may read. They either
+// belong to a raster image or were read back into a pooled scratch buffer.
+struct RasterPixels {
+  sk_sp<SkImage> image;
+  std::unique_ptr<Buffer> scratch;
+  SkPixmap pixmap;
+};
+
+// Writes encoded images straight into a pooled buffer.
+class BufferWStream final : public SkWStream {
+ public:
+  explicit BufferWStream(Buffer* buffer) : buffer_(buffer) {}
+
+  // |SkWStream|
+  bool write(const void* data, size_t size) override {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    buffer_->insert(buffer_->end(), bytes, bytes + size);
+    return true;
+  }
+
+  // |SkWStream|
+  size_t bytesWritten() const override { return buffer_->size(); }
+
+ private:
+  Buffer* buffer_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BufferWStream);
+};
+
+void EncodedBufferFinalizer(void* isolate_callback_data,
+                            Dart_WeakPersistentHandle handle,
+                            void* peer) {
+  ImageEncodingBufferPool::GetForProcess().Release(
+      std::unique_ptr<Buffer>(static_cast<Buffer*>(peer)));
+}
+
 void InvokeDataCallback(std::unique_ptr<DartPersistentValue> callback,
-                        sk_sp<SkData> buffer) {
+                        std::unique_ptr<Buffer> buffer) {
   std::shared_ptr<tonic::DartState> dart_state = callback->dart_state().lock();
   if (!dart_state) {
+    ImageEncodingBufferPool::GetForProcess().Release(std::move(buffer));
     return;
   }
   tonic::DartState::Scope scope(dart_state);
   if (!buffer) {
     DartInvoke(callback->value(), {Dart_Null()});
-  } else {
-    Dart_Handle dart_data = tonic::DartConverter<tonic::Uint8List>::ToDart(
-        buffer->bytes(), buffer->size());
-    DartInvoke(callback->value(), {dart_data});
+    return;
   }
-}
 
-sk_sp<SkImage> ConvertToRasterImageIfNecessary(sk_sp<SkImage> image,
-                                               GrContext* context) {
-  SkPixmap pixmap;
-  if (image->peekPixels(&pixmap)) {
-    // This is already a raster image.
-    return image;
+  // Dart takes over the buffer instead of a copy of it. The buffer returns to
+  // the pool once the list is collected. A pooled buffer may be larger than
+  // the encoded image, so its capacity is reported as the external size.
+  Dart_Handle dart_data = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kUint8, buffer->data(), buffer->size(), buffer.get(),
+      buffer->capacity(), EncodedBufferFinalizer);
+  if (Dart_IsError(dart_data)) {
+    FML_LOG(ERROR) << "Could not hand the encoded image to Dart.";
+    ImageEncodingBufferPool::GetForProcess().Release(std::move(buffer));
+    DartInvoke(callback->value(), {Dart_Null()});
+    return;
   }
+  buffer.release();
+  DartInvoke(callback->value(), {dart_data});
+}
 
-  if (sk_sp<SkImage> raster_image = image->makeRasterImage()) {
-    // The image can be converted to a raster image.
-    return raster_image;
+// The layout of the bytes returned for raw formats, or of the pixels that are
+// encoded otherwise.
+SkImageInfo GetTargetImageInfo(const SkImageInfo& image_info,
+                               ImageByteFormat format) {
+  switch (format) {
+    case kRawRGBA:
+      return SkImageInfo::Make(image_info.width(), image_info.height(),
+                               kRGBA_8888_SkColorType, kPremul_SkAlphaType,
+                               nullptr);
+    case kRawUnmodified:
+      if (image_info.colorType() != kUnknown_SkColorType) {
+        return image_info;
+      }
+      break;
+    case kPNG:
+    case kJPEG:
+    case kWEBP:
+      break;
   }
+  return SkImageInfo::MakeN32Premul(image_info.width(), image_info.height(),
+                                    image_info.refColorSpace());
+}
 
-  // Cross-context images do not support makeRasterImage.  Convert these images
-  // by drawing them into a surface.
-  if (context == nullptr) {
-    return nullptr;
+// Makes the pixels of the image readable on any thread. Texture backed images
+// are read back directly in the layout of |target_info| so that raw formats do
+// not need another copy.
+bool ReadRasterPixels(sk_sp<SkImage> image,
+                      GrContext* context,
+                      const SkImageInfo& target_info,
+                      RasterPixels* pixels) {
+  if (image->peekPixels(&pixels->pixmap)) {
+    // This is already a raster image.
+    pixels->image = std::move(image);
+    return true;
   }
 
   TRACE_EVENT0("flutter", __FUNCTION__);
 
-  // Create a GPU surface with the context and then do a device to host copy of
-  // image contents.
-  auto surface = SkSurface::MakeRenderTarget(
-      context, SkBudgeted::kNo,
-      SkImageInfo::MakeN32Premul(image->dimensions()));
+  auto& pool = ImageEncodingBufferPool::GetForProcess();
+  const size_t row_bytes = target_info.minRowBytes();
+  auto scratch = pool.Acquire(target_info.computeByteSize(row_bytes));
+  scratch->resize(target_info.computeByteSize(row_bytes));
 
-  if (surface == nullptr || surface->getCanvas() == nullptr) {
-    FML_LOG(ERROR) << "Could not create a surface to copy the texture into.";
-    return nullptr;
-  }
+  bool did_read =
+      image->readPixels(target_info, scratch->data(), row_bytes, 0, 0);
 
-  surface->getCanvas()->drawImage(image, 0, 0);
-  surface->getCanvas()->flush();
-
-  auto snapshot = surface->makeImageSnapshot();
+  // Cross-context images can not be read back directly. Convert these images
+  // by drawing them into a surface.
+  if (!did_read && context != nullptr) {
+    // Create a GPU surface with the context and then do a device to host copy
+    // of image contents.
+    auto surface = SkSurface::MakeRenderTarget(
+        context, SkBudgeted::kNo,
+        SkImageInfo::MakeN32Premul(image->dimensions()));
+
+    if (surface == nullptr || surface->getCanvas() == nullptr) {
+      FML_LOG(ERROR) << "Could not create a surface to copy the texture into.";
+    } else {
+      surface->getCanvas()->drawImage(image, 0, 0);
+      surface->getCanvas()->flush();
+      did_read =
+          surface->readPixels(target_info, scratch->data(), row_bytes, 0, 0);
+    }
+  }
 
-  if (snapshot == nullptr) {
-    FML_LOG(ERROR) << "Could not snapshot image to encode.";
-    return nullptr;
+  if (!did_read) {
+    pool.Release(std::move(scratch));
+    return false;
   }
 
-  return snapshot->makeRasterImage();
+  pixels->pixmap.reset(target_info, scratch->data(), row_bytes);
+  pixels->scratch = std::move(scratch);
+  return true;
 }
 
-sk_sp<SkData> CopyImageByteData(sk_sp<SkImage> raster_image,
-                                SkColorType color_type) {
-  FML_DCHECK(raster_image);
-
-  SkPixmap pixmap;
-
-  if (!raster_image->peekPixels(&pixmap)) {
-    FML_LOG(ERROR) << "Could not copy pixels from the raster image.";
-    return nullptr;
-  }
-
-  // The color types already match. No need to swizzle. Return early.
-  if (pixmap.colorType() == color_type) {
-    return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
+std::unique_ptr<Buffer> CopyPixels(RasterPixels& pixels,
+                                   const SkImageInfo& target_info) {
+  // Pixels that were read back in the target layout are returned as is.
+  if (pixels.scratch && pixels.pixmap.info() == target_info &&
+      pixels.pixmap.rowBytes() == target_info.minRowBytes()) {
+    return std::move(pixels.scratch);
   }
 
-  // Perform swizzle if the type doesnt match the specification.
-  auto surface = SkSurface::MakeRaster(
-      SkImageInfo::Make(raster_image->width(), raster_image->height(),
-                        color_type, kPremul_SkAlphaType, nullptr));
+  const size_t row_bytes = target_info.minRowBytes();
+  const size_t byte_size = target_info.computeByteSize(row_bytes);
+  auto buffer = ImageEncodingBufferPool::GetForProcess().Acquire(byte_size);
+  buffer->resize(byte_size);
 
-  if (!surface) {
-    FML_LOG(ERROR) << "Could not setup the surface for swizzle.";
+  // Swizzles if the color types do not match.
+  if (!pixels.pixmap.readPixels(target_info, buffer->data(), row_bytes)) {
+    FML_LOG(ERROR) << "Could not copy pixels from the raster image.";
+    ImageEncodingBufferPool::GetForProcess().Release(std::move(buffer));
     return nullptr;
   }
+  return buffer;
+}
 
-  surface->writePixels(pixmap, 0, 0);
-
-  if (!surface->peekPixels(&pixmap)) {
-    FML_LOG(ERROR) << "Pixel address is not available.";
+std::unique_ptr<Buffer> EncodePixels(const RasterPixels& pixels,
+                                     SkEncodedImageFormat format,
+                                     int quality) {
+  // Compressed images are usually much smaller than their pixels.
+  auto buffer = ImageEncodingBufferPool::GetForProcess().Acquire(
+      pixels.pixmap.computeByteSize() / 4);
+  BufferWStream stream(buffer.get());
+  if (!SkEncodeImage(&stream, pixels.pixmap, format, quality)) {
+    FML_LOG(ERROR) << "Could not encode the raster image.";
+    ImageEncodingBufferPool::GetForProcess().Release(std::move(buffer));
     return nullptr;
   }
-
-  return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
+  return buffer;
 }
 
-sk_sp<SkData> EncodeImage(sk_sp<SkImage> p_image,
-                          GrContext* context,
-                          ImageByteFormat format) {
+std::unique_ptr<Buffer> EncodeRasterPixels(RasterPixels pixels,
+                                           ImageByteFormat format,
+                                           int quality) {
   TRACE_EVENT0("flutter", __FUNCTION__);
 
-  // Check validity of the image.
-  if (p_image == nullptr) {
-    FML_LOG(ERROR) << "Image was null.";
-    return nullptr;
-  }
-
-  auto dimensions = p_image->dimensions();
-
-  if (dimensions.isEmpty()) {
-    FML_LOG(ERROR) << "Image dimensions were empty.";
-    return nullptr;
-  }
-
-  auto raster_image = ConvertToRasterImageIfNecessary(p_image, context);
-
-  if (raster_image == nullptr) {
-    FML_LOG(ERROR) << "Could not create a raster copy of the image.";
-    return nullptr;
-  }
-
+  std::unique_ptr<Buffer> encoded;
+  const SkImageInfo target_info =
+      GetTargetImageInfo(pixels.pixmap.info(), format);
   switch (format) {
-    case kPNG: {
-      auto png_image =
-          raster_image->encodeToData(SkEncodedImageFormat::kPNG, 0);
-
-      if (png_image == nullptr) {
-        FML_LOG(ERROR) << "Could not convert raster image to PNG.";
-        return nullptr;
-      }
-      return png_image;
-    } break;
-    case kRawRGBA: {
-      return CopyImageByteData(raster_image, kRGBA_8888_SkColorType);
-    } break;
-    case kRawUnmodified: {
-      return CopyImageByteData(raster_image, raster_image->colorType());
-    } break;
+    case kRawRGBA:
+    case kRawUnmodified:
+      encoded = CopyPixels(pixels, target_info);
+      break;
+    case kPNG:
+      encoded = EncodePixels(pixels, SkEncodedImageFormat::kPNG, quality);
+      break;
+    case kJPEG:
+      encoded = EncodePixels(pixels, SkEncodedImageFormat::kJPEG, quality);
+      break;
+    case kWEBP:
+      encoded = EncodePixels(pixels, SkEncodedImageFormat::kWEBP, quality);
+      break;
   }
 
-  FML_LOG(ERROR) << "Unknown error encoding image.";
-  return nullptr;
+  ImageEncodingBufferPool::GetForProcess().Release(std::move(pixels.scratch));
+  return encoded;
 }
 
 void EncodeImageAndInvokeDataCallback(
     std::unique_ptr<DartPersistentValue> callback,
     sk_sp<SkImage> image,
     GrContext* context,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
     fml::RefPtr<fml::TaskRunner> ui_task_runner,
-    ImageByteFormat format) {
-  sk_sp<SkData> encoded = EncodeImage(std::move(image), context, format);
+    ImageByteFormat format,
+    int quality) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
 
-  ui_task_runner->PostTask(
-      fml::MakeCopyable([callback = std::move(callback), encoded]() mutable {
-        InvokeDataCallback(std::move(callback), std::move(encoded));
-      }));
+  RasterPixels pixels;
+  const bool is_readable =
+      image != nullptr && !image->dimensions().isEmpty() &&
+      ReadRasterPixels(image, context,
+                       GetTargetImageInfo(image->imageInfo(), format),
+                       &pixels);
+  if (!is_readable) {
+    FML_LOG(ERROR) << "Could not create a raster copy of the image.";
+    ui_task_runner->PostTask(
+        fml::MakeCopyable([callback = std::move(callback)]() mutable {
+          InvokeDataCallback(std::move(callback), nullptr);
+        }));
+    return;
+  }
+
+  // Only the read back needs the resource context. The rest of the work is
+  // done on a worker so that it does not hold up texture uploads.
+  auto encode = fml::MakeCopyable([callback = std::move(callback),  //
+                                   pixels = std::move(pixels),      //
+                                   ui_task_runner,                  //
+                                   format,                          //
+                                   quality                          //
+  ]() mutable {
+    auto encoded = EncodeRasterPixels(std::move(pixels), format, quality);
+    ui_task_runner->PostTask(
+        fml::MakeCopyable([callback = std::move(callback),
+                           encoded = std::move(encoded)]() mutable {
+          InvokeDataCallback(std::move(callback), std::move(encoded));
+        }));
+  });
+
+  if (concurrent_task_runner) {
+    concurrent_task_runner->PostTask(encode);
+  } else {
+    encode();
+  }
 }
 
 }  // namespace
 
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
+                        int quality,
                         Dart_Handle callback_handle) {
   if (!canvas_image)
     return ToDart("encode called with non-genuine Image.");
@@ -205,6 +308,9 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
   if (!Dart_IsClosure(callback_handle))
     return ToDart("Callback must be a function.");
 
+  if (format < kRawRGBA || format > kWEBP)
+    return ToDart("Unknown image byte format.");
+
   ImageByteFormat image_format = static_cast<ImageByteFormat>(format);
 
   auto callback = std::make_unique<DartPersistentValue>(
@@ -212,19 +318,27 @@ Dart_Handle EncodeImage(CanvasImage* canvas_image,
 
   const auto& task_runners = UIDartState::Current()->GetTaskRunners();
   auto context = UIDartState::Current()->GetResourceContext();
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
+  if (auto image_decoder = UIDartState::Current()->GetImageDecoder()) {
+    concurrent_task_runner = image_decoder->GetConcurrentTaskRunner();
+  }
 
   task_runners.GetIOTaskRunner()->PostTask(
       fml::MakeCopyable([callback = std::move(callback),                   //
                          image = canvas_image->image(),                    //
                          context = std::move(context),                     //
+                         concurrent_task_runner,                           //
                          ui_task_runner = task_runners.GetUITaskRunner(),  //
-                         image_format                                      //
+                         image_format,                                     //
+                         quality = std::clamp(quality, 0, 100)             //
   ]() mutable {
-        EncodeImageAndInvokeDataCallback(std::move(callback),        //
-                                         std::move(image),           //
-                                         context.get(),              //
-                                         std::move(ui_task_runner),  //
-                                         image_format                //
+        EncodeImageAndInvokeDataCallback(std::move(callback),                //
+                                         std::move(image),                   //
+                                         context.get(),                      //
+                                         std::move(concurrent_task_runner),  //
+                                         std::move(ui_task_runner),          //
+                                         image_format,                       //
+                                         quality                             //
         );
       }));
 
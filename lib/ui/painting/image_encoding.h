@@ -13,6 +13,7 @@ class CanvasImage;
 
 Dart_Handle EncodeImage(CanvasImage* canvas_image,
                         int format,
+                        int quality,
                         Dart_Handle callback_handle);
 
 }  // namespace flutter
@@ -0,0 +1,86 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_encoding_buffer_pool.h"
+
+#include <utility>
+
+namespace flutter {
+
+// Enough for a few full screen images. Larger images are not worth keeping
+// around as they are rarely encoded repeatedly.
+static constexpr size_t kMaxRetainedBytes = 64 * 1024 * 1024;
+static constexpr size_t kMaxRetainedBuffers = 4;
+
+ImageEncodingBufferPool& ImageEncodingBufferPool::GetForProcess() {
+  // Never collected since buffers may be returned during shutdown.
+  static ImageEncodingBufferPool* pool =
+      new ImageEncodingBufferPool(kMaxRetainedBytes, kMaxRetainedBuffers);
+  return *pool;
+}
+
+ImageEncodingBufferPool::ImageEncodingBufferPool(size_t max_retained_bytes,
+                                                 size_t max_retained_buffers)
+    : max_retained_bytes_(max_retained_bytes),
+      max_retained_buffers_(max_retained_buffers) {}
+
+ImageEncodingBufferPool::~ImageEncodingBufferPool() = default;
+
+std::unique_ptr<ImageEncodingBufferPool::Buffer>
+ImageEncodingBufferPool::Acquire(size_t size_hint) {
+  std::unique_ptr<Buffer> buffer;
+  {
+    std::scoped_lock lock(mutex_);
+    auto best = buffers_.end();
+    for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+      const size_t capacity = (*it)->capacity();
+      if (capacity < size_hint ||
+          capacity > size_hint * kMaxReuseCapacityFactor) {
+        continue;
+      }
+      if (best == buffers_.end() || capacity < (*best)->capacity()) {
+        best = it;
+      }
+    }
+    if (best != buffers_.end()) {
+      buffer = std::move(*best);
+      buffers_.erase(best);
+      retained_bytes_ -= buffer->capacity();
+    }
+  }
+
+  if (!buffer) {
+    buffer = std::make_unique<Buffer>();
+    buffer->reserve(size_hint);
+  }
+  return buffer;
+}
+
+void ImageEncodingBufferPool::Release(std::unique_ptr<Buffer> buffer) {
+  if (!buffer) {
+    return;
+  }
+  buffer->clear();
+  const size_t capacity = buffer->capacity();
+
+  std::scoped_lock lock(mutex_);
+  if (buffers_.size() >= max_retained_buffers_ ||
+      retained_bytes_ + capacity > max_retained_bytes_) {
+    return;
+  }
+  retained_bytes_ += capacity;
+  buffers_.push_back(std::move(buffer));
+}
+
+size_t ImageEncodingBufferPool::GetRetainedBufferCount() const {
+  std::scoped_lock lock(mutex_);
+  return buffers_.size();
+}
+
+size_t ImageEncodingBufferPool::GetRetainedBytes() const {
+  std::scoped_lock lock(mutex_);
+  return retained_bytes_;
+}
+
+}  // namespace flutter
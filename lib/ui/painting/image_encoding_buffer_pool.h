@@ -0,0 +1,75 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_BUFFER_POOL_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_BUFFER_POOL_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/thread_annotations.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Retains the buffers that images are read back and encoded into, so that
+/// repeatedly encoding images of similar sizes, such as when taking a series
+/// of screenshots, does not allocate a new buffer for every image.
+///
+/// Buffers are returned to the pool once the engine or Dart is done with them.
+/// The pool only keeps a limited number of bytes. Buffers that do not fit are
+/// freed.
+///
+/// The pool may be used on any thread.
+///
+class ImageEncodingBufferPool {
+ public:
+  using Buffer = std::vector<uint8_t>;
+
+  static constexpr size_t kMaxReuseCapacityFactor = 2;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The pool shared by all images encoded in this process.
+  ///
+  static ImageEncodingBufferPool& GetForProcess();
+
+  ImageEncodingBufferPool(size_t max_retained_bytes,
+                          size_t max_retained_buffers);
+
+  ~ImageEncodingBufferPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns an empty buffer with a capacity of at least
+  ///             |size_hint| bytes. Retained buffers that are large enough
+  ///             are preferred, starting with the smallest one. Buffers of
+  ///             more than |kMaxReuseCapacityFactor| times the hint are not
+  ///             reused, so that a small image does not pin a large buffer.
+  ///
+  std::unique_ptr<Buffer> Acquire(size_t size_hint);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a buffer to the pool. It is freed if retaining it
+  ///             would exceed the limits of the pool.
+  ///
+  void Release(std::unique_ptr<Buffer> buffer);
+
+  size_t GetRetainedBufferCount() const;
+
+  size_t GetRetainedBytes() const;
+
+ private:
+  const size_t max_retained_bytes_;
+  const size_t max_retained_buffers_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Buffer>> buffers_ FML_GUARDED_BY(mutex_);
+  size_t retained_bytes_ FML_GUARDED_BY(mutex_) = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageEncodingBufferPool);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_ENCODING_BUFFER_POOL_H_
@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_encoding_buffer_pool.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(ImageEncodingBufferPoolTest, ReusesReleasedBuffers) {
+  ImageEncodingBufferPool pool(1024, 4);
+  auto buffer = pool.Acquire(100);
+  ASSERT_GE(buffer->capacity(), 100u);
+  buffer->resize(100);
+  const uint8_t* data = buffer->data();
+  pool.Release(std::move(buffer));
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 1u);
+
+  auto reused = pool.Acquire(50);
+  ASSERT_EQ(reused->data(), data);
+  ASSERT_TRUE(reused->empty());
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 0u);
+  ASSERT_EQ(pool.GetRetainedBytes(), 0u);
+}
+
+TEST(ImageEncodingBufferPoolTest, PrefersTheSmallestBufferThatFits) {
+  ImageEncodingBufferPool pool(1024, 4);
+  auto small = pool.Acquire(100);
+  auto large = pool.Acquire(400);
+  const size_t large_capacity = large->capacity();
+  pool.Release(std::move(large));
+  pool.Release(std::move(small));
+
+  ASSERT_EQ(pool.Acquire(200)->capacity(), large_capacity);
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 1u);
+}
+
+TEST(ImageEncodingBufferPoolTest, DoesNotReuseMuchLargerBuffers) {
+  ImageEncodingBufferPool pool(1024, 4);
+  pool.Release(pool.Acquire(800));
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 1u);
+
+  auto small = pool.Acquire(100);
+  ASSERT_LT(small->capacity(), 800u);
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 1u);
+}
+
+TEST(ImageEncodingBufferPoolTest, FreesBuffersBeyondItsLimits) {
+  ImageEncodingBufferPool pool(1024, 2);
+  pool.Release(pool.Acquire(2048));
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 0u);
+
+  auto first = pool.Acquire(100);
+  auto second = pool.Acquire(100);
+  auto third = pool.Acquire(100);
+  pool.Release(std::move(first));
+  pool.Release(std::move(second));
+  pool.Release(std::move(third));
+  ASSERT_EQ(pool.GetRetainedBufferCount(), 2u);
+  ASSERT_LE(pool.GetRetainedBytes(), 1024u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -1569,6 +1569,10 @@ enum PlaceholderAlignment {
   middle,
 }
 
+// The number of metrics that [Paragraph.layoutAll] returns for each paragraph.
+// Must be kept in sync with kMetricCount in paragraph.cc.
+const int _kParagraphMetricCount = 8;
+
 /// A paragraph of text.
 ///
 /// A paragraph retains the size and position of each glyph in the text and can
@@ -1638,6 +1642,36 @@ class Paragraph extends NativeFieldWrapperClass2 {
   void layout(ParagraphConstraints constraints) => _layout(constraints.width);
   void _layout(double width) native 'Paragraph_layout';
 
+  /// Lays out each of the `paragraphs` with the constraints at the same index
+  /// in `constraints`, and returns their metrics.
+  ///
+  /// This has the same effect as calling [layout] on each paragraph, but
+  /// crosses into the engine only once, which makes a difference when many
+  /// short paragraphs are laid out, such as the cells of a table. The engine
+  /// shares the shaping of paragraphs that have the same text and may lay out
+  /// the paragraphs concurrently.
+  ///
+  /// The returned list holds eight values for each paragraph, in order: its
+  /// [width], [height], [longestLine], [minIntrinsicWidth],
+  /// [maxIntrinsicWidth], [alphabeticBaseline], [ideographicBaseline], and
+  /// 1.0 if it [didExceedMaxLines] or 0.0 otherwise.
+  static Float64List layoutAll(List<Paragraph> paragraphs, List<ParagraphConstraints> constraints) {
+    assert(paragraphs != null);
+    assert(constraints != null);
+    assert(paragraphs.length == constraints.length);
+    assert(!paragraphs.contains(null));
+    final Float64List widths = Float64List(constraints.length);
+    for (int i = 0; i < constraints.length; i += 1)
+      widths[i] = constraints[i].width;
+    final Float64List metrics = Float64List(paragraphs.length * _kParagraphMetricCount);
+    final String error = _layoutAll(paragraphs, widths, metrics);
+    if (error != null)
+      throw ArgumentError(error);
+    return metrics;
+  }
+  /// Returns an error message on failure, null on success.
+  static String _layoutAll(List<Paragraph> paragraphs, Float64List widths, Float64List metrics) native 'Paragraph_layoutAll';
+
   /// Returns a list of text boxes that enclose the given text range.
   ///
   /// The [boxHeightStyle] and [boxWidthStyle] parameters allow customization
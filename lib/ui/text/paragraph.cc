@@ -4,10 +4,16 @@
 
 #include "flutter/lib/ui/text/paragraph.h"
 
+#include <vector>
+
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image_decoder.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "flutter/third_party/txt/src/txt/paragraph_batch.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
@@ -35,7 +41,20 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Paragraph);
   V(Paragraph, getRectsForPlaceholders) \
   V(Paragraph, getPositionForOffset)
 
-DART_BIND_ALL(Paragraph, FOR_EACH_BINDING)
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+DART_NATIVE_CALLBACK_STATIC(Paragraph, layoutAll)
+
+void Paragraph::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({DART_REGISTER_NATIVE_STATIC(Paragraph, layoutAll)});
+  natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+namespace {
+
+// Must be kept in sync with _kParagraphMetricCount in text.dart.
+constexpr size_t kMetricCount = 8;
+
+}  // namespace
 
 Paragraph::Paragraph(std::unique_ptr<txt::Paragraph> paragraph)
     : m_paragraphImpl(
@@ -90,6 +109,64 @@ void Paragraph::paint(Canvas* canvas, double x, double y) {
   m_paragraphImpl->paint(canvas, x, y);
 }
 
+Dart_Handle Paragraph::layoutAll(Dart_Handle paragraphs_handle,
+                                 Dart_Handle widths_handle,
+                                 Dart_Handle metrics_handle) {
+  TRACE_EVENT0("flutter", "Paragraph::layoutAll");
+  intptr_t length = 0;
+  if (Dart_IsError(Dart_ListLength(paragraphs_handle, &length))) {
+    return tonic::ToDart("paragraphs must be a list");
+  }
+  tonic::Float64List widths(widths_handle);
+  tonic::Float64List metrics(metrics_handle);
+  if (static_cast<size_t>(widths.num_elements()) !=
+          static_cast<size_t>(length) ||
+      static_cast<size_t>(metrics.num_elements()) != length * kMetricCount) {
+    return tonic::ToDart("Each paragraph must have a width and metrics");
+  }
+
+  std::vector<Paragraph*> paragraphs;
+  std::vector<txt::Paragraph*> txt_paragraphs;
+  std::vector<double> txt_widths;
+  for (intptr_t i = 0; i < length; i++) {
+    Dart_Handle paragraph_handle = Dart_ListGetAt(paragraphs_handle, i);
+    if (Dart_IsError(paragraph_handle) || Dart_IsNull(paragraph_handle)) {
+      return tonic::ToDart("paragraphs must not contain null");
+    }
+    Paragraph* paragraph =
+        tonic::DartConverter<Paragraph*>::FromDart(paragraph_handle);
+    if (paragraph == nullptr) {
+      return tonic::ToDart("paragraphs must only contain Paragraph objects");
+    }
+    paragraphs.push_back(paragraph);
+    txt_paragraphs.push_back(paragraph->m_paragraphImpl->paragraph());
+    txt_widths.push_back(widths[i]);
+  }
+
+  // The layout caches are shared between threads, so the paragraphs can be
+  // laid out by the workers that also decode images.
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner;
+  if (auto image_decoder = UIDartState::Current()->GetImageDecoder()) {
+    concurrent_task_runner = image_decoder->GetConcurrentTaskRunner();
+  }
+  txt::LayoutParagraphs(txt_paragraphs, txt_widths,
+                        concurrent_task_runner.get());
+
+  for (intptr_t i = 0; i < length; i++) {
+    Paragraph* paragraph = paragraphs[i];
+    const size_t offset = i * kMetricCount;
+    metrics[offset + 0] = paragraph->width();
+    metrics[offset + 1] = paragraph->height();
+    metrics[offset + 2] = paragraph->longestLine();
+    metrics[offset + 3] = paragraph->minIntrinsicWidth();
+    metrics[offset + 4] = paragraph->maxIntrinsicWidth();
+    metrics[offset + 5] = paragraph->alphabeticBaseline();
+    metrics[offset + 6] = paragraph->ideographicBaseline();
+    metrics[offset + 7] = paragraph->didExceedMaxLines() ? 1 : 0;
+  }
+  return Dart_Null();
+}
+
 std::vector<TextBox> Paragraph::getRectsForRange(unsigned start,
                                                  unsigned end,
                                                  unsigned boxHeightStyle,
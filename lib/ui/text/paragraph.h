@@ -12,6 +12,7 @@
 #include "flutter/lib/ui/text/paragraph_impl_txt.h"
 #include "flutter/lib/ui/text/text_box.h"
 #include "flutter/third_party/txt/src/txt/paragraph.h"
+#include "third_party/tonic/typed_data/typed_list.h"
 
 namespace tonic {
 class DartLibraryNatives;
@@ -43,6 +44,13 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   void layout(double width);
   void paint(Canvas* canvas, double x, double y);
 
+  // Lays out each paragraph in the Dart list at the width with the same index,
+  // and writes the metrics of all of them to |metrics|. Returns an error
+  // message if the arguments are invalid, null otherwise.
+  static Dart_Handle layoutAll(Dart_Handle paragraphs,
+                               Dart_Handle widths,
+                               Dart_Handle metrics);
+
   std::vector<TextBox> getRectsForRange(unsigned start,
                                         unsigned end,
                                         unsigned boxHeightStyle,
@@ -46,6 +46,10 @@ class ParagraphImpl {
   virtual Dart_Handle getPositionForOffset(double dx, double dy) = 0;
 
   virtual Dart_Handle getWordBoundary(unsigned offset) = 0;
+
+  // Returns the paragraph that is laid out, so that many of them can be laid
+  // out at once.
+  virtual txt::Paragraph* paragraph() = 0;
 };
 
 }  // namespace flutter
@@ -107,4 +107,8 @@ Dart_Handle ParagraphImplTxt::getWordBoundary(unsigned offset) {
   return result;
 }
 
+txt::Paragraph* ParagraphImplTxt::paragraph() {
+  return m_paragraph.get();
+}
+
 }  // namespace flutter
@@ -38,6 +38,8 @@ class ParagraphImplTxt : public ParagraphImpl {
   Dart_Handle getPositionForOffset(double dx, double dy) override;
   Dart_Handle getWordBoundary(unsigned offset) override;
 
+  txt::Paragraph* paragraph() override;
+
  private:
   std::unique_ptr<txt::Paragraph> m_paragraph;
   double m_width = -1.0;
@@ -39,6 +39,9 @@ typedef PlatformMessageResponseCallback = void Function(ByteData data);
 /// Signature for [Window.onPlatformMessage].
 typedef PlatformMessageCallback = void Function(String name, ByteData data, PlatformMessageResponseCallback callback);
 
+/// Signature for [Window.onPlatformMessageChunk].
+typedef PlatformMessageChunkCallback = void Function(String name, int streamId, ByteData data, bool isLast);
+
 // Signature for _setNeedsReportTimings.
 typedef _SetNeedsReportTimingsFunc = void Function(bool value);
 
@@ -1126,6 +1129,34 @@ class Window {
     _onPlatformMessageZone = Zone.current;
   }
 
+  /// Called whenever this window receives a chunk of a payload that a
+  /// platform-specific plugin streams to the application.
+  ///
+  /// The `name` parameter determines which plugin sent the chunk. All chunks
+  /// of a payload have the same `streamId`, and are received in the order in
+  /// which they were sent. The last chunk of a payload has a null `data`
+  /// parameter and an `isLast` parameter of true.
+  ///
+  /// Unlike [onPlatformMessage], this callback lets the application start
+  /// processing large payloads before they have been sent completely. Chunks
+  /// received while this callback is not set are dropped.
+  ///
+  /// Only embedders built on the embedder API can stream payloads so far, via
+  /// `FlutterEngineCreatePlatformMessageStream`. The Android and iOS
+  /// embeddings do not send chunks, so on those platforms this callback is
+  /// never invoked and plugins deliver their payloads through
+  /// [onPlatformMessage] as a whole.
+  ///
+  /// The framework invokes this callback in the same zone in which the
+  /// callback was set.
+  PlatformMessageChunkCallback get onPlatformMessageChunk => _onPlatformMessageChunk;
+  PlatformMessageChunkCallback _onPlatformMessageChunk;
+  Zone _onPlatformMessageChunkZone;
+  set onPlatformMessageChunk(PlatformMessageChunkCallback callback) {
+    _onPlatformMessageChunk = callback;
+    _onPlatformMessageChunkZone = Zone.current;
+  }
+
   /// Called by [_dispatchPlatformMessage].
   void _respondToPlatformMessage(int responseId, ByteData data)
       native 'Window_respondToPlatformMessage';
@@ -6,21 +6,43 @@
 
 #include <utility>
 
+#include "flutter/fml/logging.h"
+#include "flutter/lib/ui/window/platform_message_stream.h"
+
 namespace flutter {
 
 PlatformMessage::PlatformMessage(std::string channel,
                                  std::vector<uint8_t> data,
                                  fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(std::move(data)),
+      data_(std::make_unique<fml::DataMapping>(std::move(data))),
       hasData_(true),
       response_(std::move(response)) {}
+PlatformMessage::PlatformMessage(std::string channel,
+                                 std::unique_ptr<fml::Mapping> data,
+                                 fml::RefPtr<PlatformMessageResponse> response)
+    : channel_(std::move(channel)),
+      data_(std::move(data)),
+      hasData_(true),
+      response_(std::move(response)) {
+  FML_DCHECK(data_);
+}
 PlatformMessage::PlatformMessage(std::string channel,
                                  fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(),
+      data_(std::make_unique<fml::DataMapping>(std::vector<uint8_t>{})),
       hasData_(false),
       response_(std::move(response)) {}
+PlatformMessage::PlatformMessage(fml::RefPtr<PlatformMessageStream> stream,
+                                 std::unique_ptr<fml::Mapping> data,
+                                 bool is_last_chunk)
+    : channel_(stream->channel()),
+      data_(std::move(data)),
+      hasData_(!is_last_chunk),
+      stream_(std::move(stream)),
+      is_last_chunk_(is_last_chunk) {
+  FML_DCHECK(data_);
+}
 
 PlatformMessage::~PlatformMessage() = default;
 
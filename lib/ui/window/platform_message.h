@@ -5,40 +5,63 @@
 #ifndef FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 #define FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/lib/ui/window/platform_message_response.h"
 
 namespace flutter {
 
+class PlatformMessageStream;
+
 class PlatformMessage : public fml::RefCountedThreadSafe<PlatformMessage> {
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(PlatformMessage);
   FML_FRIEND_MAKE_REF_COUNTED(PlatformMessage);
 
  public:
   const std::string& channel() const { return channel_; }
-  const std::vector<uint8_t>& data() const { return data_; }
+  // The payload of the message. Empty if the message has no data.
+  const fml::Mapping& data() const { return *data_; }
   bool hasData() { return hasData_; }
 
   const fml::RefPtr<PlatformMessageResponse>& response() const {
     return response_;
   }
 
+  // The stream this message is a chunk of, if any.
+  const fml::RefPtr<PlatformMessageStream>& stream() const { return stream_; }
+  // Whether this message is the empty chunk that ends its stream.
+  bool is_last_chunk() const { return is_last_chunk_; }
+
  private:
   PlatformMessage(std::string channel,
                   std::vector<uint8_t> data,
                   fml::RefPtr<PlatformMessageResponse> response);
+  // Creates a message that owns |data| without copying it. Large payloads are
+  // handed to Dart without being copied either, so |data| must be writable
+  // memory.
+  PlatformMessage(std::string channel,
+                  std::unique_ptr<fml::Mapping> data,
+                  fml::RefPtr<PlatformMessageResponse> response);
   PlatformMessage(std::string channel,
                   fml::RefPtr<PlatformMessageResponse> response);
+  // Creates a chunk of |stream|. Chunks have no response. The last chunk has
+  // no data.
+  PlatformMessage(fml::RefPtr<PlatformMessageStream> stream,
+                  std::unique_ptr<fml::Mapping> data,
+                  bool is_last_chunk);
   ~PlatformMessage();
 
   std::string channel_;
-  std::vector<uint8_t> data_;
+  std::unique_ptr<fml::Mapping> data_;
   bool hasData_;
   fml::RefPtr<PlatformMessageResponse> response_;
+  fml::RefPtr<PlatformMessageStream> stream_;
+  bool is_last_chunk_ = false;
 };
 
 }  // namespace flutter
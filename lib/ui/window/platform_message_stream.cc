@@ -0,0 +1,86 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/platform_message_stream.h"
+
+#include <atomic>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+static std::atomic<int64_t> next_stream_id{1};
+
+PlatformMessageStream::PlatformMessageStream(std::string channel,
+                                             size_t max_pending_bytes,
+                                             fml::closure drain_callback)
+    : id_(next_stream_id++),
+      channel_(std::move(channel)),
+      max_pending_bytes_(max_pending_bytes),
+      drain_callback_(std::move(drain_callback)) {}
+
+PlatformMessageStream::~PlatformMessageStream() = default;
+
+fml::RefPtr<PlatformMessage> PlatformMessageStream::Write(
+    std::unique_ptr<fml::Mapping> data,
+    bool* is_full) {
+  FML_DCHECK(data);
+  std::scoped_lock lock(mutex_);
+  if (is_closed_) {
+    return nullptr;
+  }
+
+  pending_bytes_ += data->GetSize();
+  if (pending_bytes_ >= max_pending_bytes_) {
+    is_full_ = true;
+  }
+  if (is_full) {
+    *is_full = is_full_;
+  }
+
+  return fml::MakeRefCounted<PlatformMessage>(fml::Ref(this), std::move(data),
+                                              false);
+}
+
+fml::RefPtr<PlatformMessage> PlatformMessageStream::Close() {
+  std::scoped_lock lock(mutex_);
+  if (is_closed_) {
+    return nullptr;
+  }
+  is_closed_ = true;
+  drain_callback_ = nullptr;
+
+  auto empty = std::make_unique<fml::DataMapping>(std::vector<uint8_t>{});
+  return fml::MakeRefCounted<PlatformMessage>(fml::Ref(this), std::move(empty),
+                                              true);
+}
+
+void PlatformMessageStream::OnChunkConsumed(const PlatformMessage& chunk) {
+  FML_DCHECK(chunk.stream().get() == this);
+  fml::closure drain_callback;
+  {
+    std::scoped_lock lock(mutex_);
+    const size_t size = chunk.data().GetSize();
+    FML_DCHECK(pending_bytes_ >= size);
+    pending_bytes_ -= size;
+    // Waiting for the stream to drain completely would leave the receiver
+    // idle till the writer produces the next chunk.
+    if (is_full_ && pending_bytes_ <= max_pending_bytes_ / 2) {
+      is_full_ = false;
+      drain_callback = drain_callback_;
+    }
+  }
+
+  if (drain_callback) {
+    drain_callback();
+  }
+}
+
+size_t PlatformMessageStream::GetPendingBytes() const {
+  std::scoped_lock lock(mutex_);
+  return pending_bytes_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_WINDOW_PLATFORM_MESSAGE_STREAM_H_
+#define FLUTTER_LIB_UI_WINDOW_PLATFORM_MESSAGE_STREAM_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/synchronization/thread_annotations.h"
+#include "flutter/lib/ui/window/platform_message.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// A payload sent by the platform to the Dart application in chunks. Each
+/// chunk is a platform message on the channel of the stream that is delivered
+/// as soon as it is written, so that the application can start processing the
+/// payload before all of it has been produced.
+///
+/// Streams apply backpressure to their writer. Once the chunks that were
+/// written but not yet delivered add up to the pending byte limit of the
+/// stream, `Write` reports that the stream is full. The writer should then
+/// wait for the drain callback, which is invoked once half of the pending
+/// bytes have been delivered, before writing again.
+///
+/// Streams may be written to on any thread. Their chunks are delivered in
+/// the order in which they were written.
+///
+/// Streams are only created by the embedder API so far. The Android and iOS
+/// platform views, and the message dispatchers of their embeddings (such as
+/// `DartMessenger` on Android), don't create them yet. On those platforms,
+/// payloads are still sent to Dart as single platform messages.
+///
+class PlatformMessageStream
+    : public fml::RefCountedThreadSafe<PlatformMessageStream> {
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(PlatformMessageStream);
+  FML_FRIEND_MAKE_REF_COUNTED(PlatformMessageStream);
+
+ public:
+  int64_t id() const { return id_; }
+
+  const std::string& channel() const { return channel_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates the message that carries the next chunk of the
+  ///             stream. The message must be dispatched to the engine like
+  ///             any other platform message.
+  ///
+  /// @param[in]  data     The payload of the chunk.
+  /// @param[out] is_full  Set to whether the writer should wait for the drain
+  ///                      callback before writing more data. May be null.
+  ///
+  /// @return     The message, or `nullptr` if the stream is closed.
+  ///
+  fml::RefPtr<PlatformMessage> Write(std::unique_ptr<fml::Mapping> data,
+                                     bool* is_full);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Closes the stream. The drain callback is not invoked for
+  ///             chunks consumed after this call, but a drain callback that
+  ///             is already running on another thread may still finish.
+  ///
+  /// @return     The empty message that marks the end of the stream, or
+  ///             `nullptr` if the stream was already closed.
+  ///
+  fml::RefPtr<PlatformMessage> Close();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called when a chunk of the stream has been delivered to the
+  ///             application, or was dropped because there was no
+  ///             application to deliver it to.
+  ///
+  void OnChunkConsumed(const PlatformMessage& chunk);
+
+  size_t GetPendingBytes() const;
+
+ private:
+  const int64_t id_;
+  const std::string channel_;
+  const size_t max_pending_bytes_;
+  mutable std::mutex mutex_;
+  fml::closure drain_callback_ FML_GUARDED_BY(mutex_);
+  size_t pending_bytes_ FML_GUARDED_BY(mutex_) = 0;
+  bool is_full_ FML_GUARDED_BY(mutex_) = false;
+  bool is_closed_ FML_GUARDED_BY(mutex_) = false;
+
+  //----------------------------------------------------------------------------
+  /// @param[in]  channel            The channel the chunks are sent on.
+  /// @param[in]  max_pending_bytes  The number of written bytes that may be
+  ///                                waiting for delivery before the stream
+  ///                                is full.
+  /// @param[in]  drain_callback     Invoked when a full stream can be written
+  ///                                to again. Invoked on the UI task runner.
+  ///
+  PlatformMessageStream(std::string channel,
+                        size_t max_pending_bytes,
+                        fml::closure drain_callback);
+
+  ~PlatformMessageStream();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageStream);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_WINDOW_PLATFORM_MESSAGE_STREAM_H_
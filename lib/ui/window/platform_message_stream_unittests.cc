@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/platform_message_stream.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static std::unique_ptr<fml::Mapping> MakeData(size_t size) {
+  return std::make_unique<fml::DataMapping>(std::vector<uint8_t>(size, 42));
+}
+
+TEST(PlatformMessageStreamTest, ChunksAreMessagesOnTheStreamChannel) {
+  auto stream =
+      fml::MakeRefCounted<PlatformMessageStream>("test", 100, nullptr);
+  auto chunk = stream->Write(MakeData(10), nullptr);
+  ASSERT_TRUE(chunk);
+  ASSERT_EQ(chunk->channel(), "test");
+  ASSERT_EQ(chunk->stream(), stream);
+  ASSERT_EQ(chunk->data().GetSize(), 10u);
+  ASSERT_TRUE(chunk->hasData());
+  ASSERT_FALSE(chunk->is_last_chunk());
+  ASSERT_FALSE(chunk->response());
+
+  auto last = stream->Close();
+  ASSERT_TRUE(last);
+  ASSERT_EQ(last->stream(), stream);
+  ASSERT_FALSE(last->hasData());
+  ASSERT_TRUE(last->is_last_chunk());
+}
+
+TEST(PlatformMessageStreamTest, StreamsHaveUniqueIds) {
+  auto first = fml::MakeRefCounted<PlatformMessageStream>("test", 1, nullptr);
+  auto second = fml::MakeRefCounted<PlatformMessageStream>("test", 1, nullptr);
+  ASSERT_NE(first->id(), second->id());
+}
+
+TEST(PlatformMessageStreamTest, ClosedStreamsCannotBeWritten) {
+  auto stream =
+      fml::MakeRefCounted<PlatformMessageStream>("test", 100, nullptr);
+  ASSERT_TRUE(stream->Close());
+  ASSERT_FALSE(stream->Close());
+  ASSERT_FALSE(stream->Write(MakeData(10), nullptr));
+}
+
+TEST(PlatformMessageStreamTest, DrainsOnceHalfThePendingBytesAreConsumed) {
+  size_t drain_count = 0;
+  auto stream = fml::MakeRefCounted<PlatformMessageStream>(
+      "test", 100, [&drain_count]() { drain_count++; });
+
+  bool is_full = true;
+  auto first = stream->Write(MakeData(40), &is_full);
+  ASSERT_FALSE(is_full);
+  auto second = stream->Write(MakeData(40), &is_full);
+  ASSERT_FALSE(is_full);
+  auto third = stream->Write(MakeData(40), &is_full);
+  ASSERT_TRUE(is_full);
+  ASSERT_EQ(stream->GetPendingBytes(), 120u);
+
+  stream->OnChunkConsumed(*first);
+  ASSERT_EQ(drain_count, 0u);
+  stream->OnChunkConsumed(*second);
+  ASSERT_EQ(drain_count, 1u);
+  ASSERT_EQ(stream->GetPendingBytes(), 40u);
+
+  stream->Write(MakeData(10), &is_full);
+  ASSERT_FALSE(is_full);
+
+  stream->OnChunkConsumed(*third);
+  ASSERT_EQ(drain_count, 1u);
+}
+
+TEST(PlatformMessageStreamTest, ClosedStreamsDoNotDrain) {
+  size_t drain_count = 0;
+  auto stream = fml::MakeRefCounted<PlatformMessageStream>(
+      "test", 10, [&drain_count]() { drain_count++; });
+
+  bool is_full = false;
+  auto chunk = stream->Write(MakeData(10), &is_full);
+  ASSERT_TRUE(is_full);
+  stream->Close();
+  stream->OnChunkConsumed(*chunk);
+  ASSERT_EQ(drain_count, 0u);
+  ASSERT_EQ(stream->GetPendingBytes(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -7,6 +7,7 @@
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
+#include "flutter/lib/ui/window/platform_message_stream.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_library_natives.h"
@@ -144,9 +145,11 @@ void _RespondToPlatformMessage(Dart_NativeArguments args) {
 
 }  // namespace
 
-Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
-  Dart_Handle data_handle =
-      Dart_NewTypedData(Dart_TypedData_kByteData, buffer.size());
+// Avoid copying the contents of messages beyond a certain size.
+static constexpr size_t kMessageCopyThreshold = 1000;
+
+static Dart_Handle ToByteData(const uint8_t* buffer, size_t size) {
+  Dart_Handle data_handle = Dart_NewTypedData(Dart_TypedData_kByteData, size);
   if (Dart_IsError(data_handle))
     return data_handle;
 
@@ -156,11 +159,40 @@ Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
   FML_CHECK(!Dart_IsError(
       Dart_TypedDataAcquireData(data_handle, &type, &data, &num_bytes)));
 
-  memcpy(data, buffer.data(), num_bytes);
+  memcpy(data, buffer, num_bytes);
   Dart_TypedDataReleaseData(data_handle);
   return data_handle;
 }
 
+Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
+  return ToByteData(buffer.data(), buffer.size());
+}
+
+static void PlatformMessageDataFinalizer(void* isolate_callback_data,
+                                         Dart_WeakPersistentHandle handle,
+                                         void* peer) {
+  reinterpret_cast<PlatformMessage*>(peer)->Release();
+}
+
+// Wraps the data of a platform message into a ByteData. Large payloads are
+// not copied. The ByteData references the message data instead and keeps the
+// message alive till it is collected.
+static Dart_Handle ToByteData(const fml::RefPtr<PlatformMessage>& message) {
+  const fml::Mapping& data = message->data();
+  if (data.GetSize() < kMessageCopyThreshold) {
+    return ToByteData(data.GetMapping(), data.GetSize());
+  }
+
+  Dart_Handle data_handle = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, const_cast<uint8_t*>(data.GetMapping()),
+      data.GetSize(), message.get(), data.GetSize(),
+      PlatformMessageDataFinalizer);
+  if (!Dart_IsError(data_handle)) {
+    message->AddRef();
+  }
+  return data_handle;
+}
+
 WindowClient::~WindowClient() {}
 
 Window::Window(WindowClient* client) : client_(client) {}
@@ -255,12 +287,17 @@ void Window::UpdateAccessibilityFeatures(int32_t values) {
 }
 
 void Window::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
+  if (message->stream()) {
+    DispatchPlatformMessageChunk(std::move(message));
+    return;
+  }
+
   std::shared_ptr<tonic::DartState> dart_state = library_.dart_state().lock();
   if (!dart_state)
     return;
   tonic::DartState::Scope scope(dart_state);
   Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+      (message->hasData()) ? ToByteData(message) : Dart_Null();
   if (Dart_IsError(data_handle))
     return;
 
@@ -276,6 +313,25 @@ void Window::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
                               tonic::ToDart(response_id)}));
 }
 
+void Window::DispatchPlatformMessageChunk(
+    fml::RefPtr<PlatformMessage> message) {
+  const auto& stream = message->stream();
+  std::shared_ptr<tonic::DartState> dart_state = library_.dart_state().lock();
+  if (dart_state) {
+    tonic::DartState::Scope scope(dart_state);
+    Dart_Handle data_handle =
+        (message->hasData()) ? ToByteData(message) : Dart_Null();
+    if (!Dart_IsError(data_handle)) {
+      tonic::LogIfError(tonic::DartInvokeField(
+          library_.value(), "_dispatchPlatformMessageChunk",
+          {tonic::ToDart(message->channel()), tonic::ToDart(stream->id()),
+           data_handle, tonic::ToDart(message->is_last_chunk())}));
+    }
+  }
+  // Chunks that could not be delivered must not hold up the writer either.
+  stream->OnChunkConsumed(*message);
+}
+
 void Window::DispatchPointerDataPacket(const PointerDataPacket& packet) {
   std::shared_ptr<tonic::DartState> dart_state = library_.dart_state().lock();
   if (!dart_state)
@@ -102,6 +102,8 @@ class Window final {
   int next_response_id_ = 1;
   std::unordered_map<int, fml::RefPtr<PlatformMessageResponse>>
       pending_responses_;
+
+  void DispatchPlatformMessageChunk(fml::RefPtr<PlatformMessage> message);
 };
 
 }  // namespace flutter
@@ -21,7 +21,8 @@ constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
 
 Animator::Animator(Delegate& delegate,
                    TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   PipelineMode pipeline_mode)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
@@ -34,7 +35,8 @@ Animator::Animator(Delegate& delegate,
           task_runners.GetPlatformTaskRunner() ==
                   task_runners.GetGPUTaskRunner()
               ? 1
-              : 2)),
+              : 2,
+          pipeline_mode)),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
@@ -117,7 +119,8 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
     if (!producer_continuation_) {
       // If we still don't have valid continuation, the pipeline is currently
       // full because the consumer is being too slow. Try again at the next
-      // frame interval.
+      // frame interval. This can't happen in mailbox mode where the new frame
+      // replaces the one that the consumer hasn't picked up yet.
       RequestFrame();
       return;
     }
@@ -128,6 +131,7 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   FML_DCHECK(producer_continuation_);
 
   last_begin_frame_time_ = frame_start_time;
+  last_frame_target_time_ = frame_target_time;
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
@@ -173,7 +177,8 @@ void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
 
   if (layer_tree) {
     // Note the frame time for instrumentation.
-    layer_tree->RecordBuildTime(last_begin_frame_time_);
+    layer_tree->RecordBuildTime(last_begin_frame_time_,
+                                last_frame_target_time_);
   }
 
   // Commit the pending continuation.
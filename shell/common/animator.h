@@ -42,7 +42,8 @@ class Animator final {
 
   Animator(Delegate& delegate,
            TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           PipelineMode pipeline_mode = PipelineMode::kQueue);
 
   ~Animator();
 
@@ -58,6 +59,12 @@ class Animator final {
 
   void SetDimensionChangePending();
 
+  // Whether the next vsync is going to produce a new frame, in which case
+  // |Delegate::OnAnimatorBeginFrame| will be called.
+  bool IsBeginFrameScheduled() const {
+    return frame_scheduled_ && regenerate_layer_tree_;
+  }
+
   // Enqueue |trace_flow_id| into |trace_flow_ids_|.  The corresponding flow
   // will be ended during the next |BeginFrame|.
   void EnqueueTraceFlowId(uint64_t trace_flow_id);
@@ -80,6 +87,7 @@ class Animator final {
   std::shared_ptr<VsyncWaiter> waiter_;
 
   fml::TimePoint last_begin_frame_time_;
+  fml::TimePoint last_frame_target_time_;
   int64_t dart_frame_deadline_;
   fml::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   fml::Semaphore pending_frame_semaphore_;
@@ -18,6 +18,7 @@
 #include "flutter/fml/unique_fd.h"
 #include "flutter/lib/snapshot/snapshot.h"
 #include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/lib/ui/window/platform_message_stream.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/shell.h"
@@ -50,7 +51,11 @@ Engine::Engine(Delegate& delegate,
       have_surface_(false),
       image_decoder_(task_runners,
                      vm.GetConcurrentWorkerTaskRunner(),
-                     io_manager),
+                     io_manager,
+                     settings_.decoded_image_cache_max_bytes),
+      pointer_event_queue_(settings_.enable_pointer_event_coalescing
+                               ? std::make_shared<PointerEventQueue>()
+                               : nullptr),
       weak_factory_(this) {
   // Runtime controller is initialized here because it takes a reference to this
   // object as its delegate. The delegate may be called in the constructor and
@@ -209,7 +214,20 @@ Engine::RunStatus Engine::PrepareAndLaunchIsolate(
 
 void Engine::BeginFrame(fml::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
+  if (pointer_event_queue_ && !pointer_event_queue_->IsEmpty()) {
+    FlushPointerEvents(frame_time);
+    if (!pointer_event_queue_->IsEmpty()) {
+      // Samples newer than the frame time are left for the next frame. Make
+      // sure there is one, or deliver them right away if frames are paused.
+      ScheduleFrame();
+      if (!animator_->IsBeginFrameScheduled()) {
+        FlushPointerEvents(std::nullopt);
+      }
+    }
+  }
   runtime_controller_->BeginFrame(frame_time);
+  // The frame has laid out its paragraphs by now.
+  txt::FontCollection::TraceShapedWordCacheCounters();
 }
 
 void Engine::ReportTimings(std::vector<int64_t> timings) {
@@ -270,6 +288,17 @@ void Engine::SetViewportMetrics(const ViewportMetrics& metrics) {
 }
 
 void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
+  if (const auto stream = message->stream()) {
+    // Chunks of streams are only meant for the application. They are dropped
+    // if it isn't running, but still count as consumed so that the writer of
+    // the stream isn't held up forever.
+    if (!runtime_controller_->IsRootIsolateRunning() ||
+        !runtime_controller_->DispatchPlatformMessage(message)) {
+      stream->OnChunkConsumed(*message);
+    }
+    return;
+  }
+
   if (message->channel() == kLifecycleChannel) {
     if (HandleLifecyclePlatformMessage(message.get()))
       return;
@@ -293,7 +322,8 @@ void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
 
 bool Engine::HandleLifecyclePlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
-  std::string state(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string state(reinterpret_cast<const char*>(data.GetMapping()),
+                    data.GetSize());
   if (state == "AppLifecycleState.paused" ||
       state == "AppLifecycleState.suspending") {
     activity_running_ = false;
@@ -320,7 +350,8 @@ bool Engine::HandleNavigationPlatformMessage(
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -336,7 +367,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -368,7 +400,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
 
 void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
-  std::string jsonData(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string jsonData(reinterpret_cast<const char*>(data.GetMapping()),
+                       data.GetSize());
   if (runtime_controller_->SetUserSettingsData(std::move(jsonData)) &&
       have_surface_) {
     ScheduleFrame();
@@ -383,6 +416,37 @@ void Engine::DispatchPointerDataPacket(const PointerDataPacket& packet,
   runtime_controller_->DispatchPointerDataPacket(packet);
 }
 
+std::shared_ptr<PointerEventQueue> Engine::GetPointerEventQueue() const {
+  return pointer_event_queue_;
+}
+
+void Engine::DispatchPendingPointerEvents() {
+  if (!pointer_event_queue_) {
+    return;
+  }
+  // The events are delivered at the beginning of the scheduled frame.
+  if (animator_->IsBeginFrameScheduled()) {
+    return;
+  }
+  FlushPointerEvents(std::nullopt);
+}
+
+void Engine::FlushPointerEvents(std::optional<fml::TimePoint> frame_time) {
+  TRACE_EVENT0("flutter", "Engine::FlushPointerEvents");
+  std::optional<int64_t> sample_time;
+  if (frame_time) {
+    sample_time = frame_time->ToEpochDelta().ToMicroseconds();
+  }
+  auto batch = pointer_event_queue_->Pop(sample_time);
+  for (uint64_t trace_flow_id : batch.trace_flow_ids) {
+    TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+    animator_->EnqueueTraceFlowId(trace_flow_id);
+  }
+  if (batch.packet) {
+    runtime_controller_->DispatchPointerDataPacket(*batch.packet);
+  }
+}
+
 void Engine::DispatchSemanticsAction(int id,
                                      SemanticsAction action,
                                      std::vector<uint8_t> args) {
@@ -462,8 +526,8 @@ void Engine::HandleAssetPlatformMessage(fml::RefPtr<PlatformMessage> message) {
     return;
   }
   const auto& data = message->data();
-  std::string asset_name(reinterpret_cast<const char*>(data.data()),
-                         data.size());
+  std::string asset_name(reinterpret_cast<const char*>(data.GetMapping()),
+                         data.GetSize());
 
   if (asset_manager_) {
     std::unique_ptr<fml::Mapping> asset_mapping =
@@ -6,6 +6,7 @@
 #define SHELL_COMMON_ENGINE_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "flutter/assets/asset_manager.h"
@@ -22,6 +23,7 @@
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/runtime/runtime_delegate.h"
 #include "flutter/shell/common/animator.h"
+#include "flutter/shell/common/pointer_event_queue.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/run_configuration.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -652,6 +654,30 @@ class Engine final : public RuntimeDelegate {
   void DispatchPointerDataPacket(const PointerDataPacket& packet,
                                  uint64_t trace_flow_id);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Gets the queue into which the shell pushes pointer data
+  ///             packets when pointer event coalescing is enabled. The queue
+  ///             is created with the engine and may be used on any thread.
+  ///
+  /// @see        `Settings::enable_pointer_event_coalescing`
+  ///
+  /// @return     The pointer event queue or `nullptr` if pointer event
+  ///             coalescing is disabled.
+  ///
+  std::shared_ptr<PointerEventQueue> GetPointerEventQueue() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the shell has pushed pointer data
+  ///             packets to the pointer event queue. If a frame is scheduled,
+  ///             the queued events are delivered to the framework, merged
+  ///             into one packet and resampled to the frame time, right
+  ///             before the frame begins. Otherwise they are delivered
+  ///             immediately.
+  ///
+  /// @see        `PointerEventQueue`
+  ///
+  void DispatchPendingPointerEvents();
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that the embedder encountered an
   ///             accessibility related action on the specified node. This call
@@ -712,8 +738,11 @@ class Engine final : public RuntimeDelegate {
   bool have_surface_;
   FontCollection font_collection_;
   ImageDecoder image_decoder_;
+  const std::shared_ptr<PointerEventQueue> pointer_event_queue_;
   fml::WeakPtrFactory<Engine> weak_factory_;
 
+  void FlushPointerEvents(std::optional<fml::TimePoint> frame_time);
+
   // |RuntimeDelegate|
   std::string DefaultRouteName() override;
 
@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_encoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+
+FrameEncoder::State::State(Callback callback)
+    : callback(std::move(callback)) {}
+
+size_t FrameEncoder::State::GetPendingFrameCountLocked() const {
+  return next_frame_number - next_delivered_frame_number;
+}
+
+void FrameEncoder::State::OnFrameEncoded(uint64_t frame_number,
+                                         const SkISize& size,
+                                         sk_sp<SkData> data) {
+  {
+    std::scoped_lock lock(mutex);
+    encoded_frames[frame_number] = {size, std::move(data)};
+  }
+
+  // Whoever holds the delivery lock delivers all frames that are ready, so a
+  // frame that finished encoding early waits for its predecessors.
+  std::scoped_lock delivery_lock(delivery_mutex);
+  while (true) {
+    uint64_t number = 0;
+    std::pair<SkISize, sk_sp<SkData>> frame;
+    {
+      std::scoped_lock lock(mutex);
+      auto found = encoded_frames.find(next_delivered_frame_number);
+      if (found == encoded_frames.end()) {
+        return;
+      }
+      number = found->first;
+      frame = std::move(found->second);
+      encoded_frames.erase(found);
+    }
+
+    callback(number, frame.first, std::move(frame.second));
+
+    {
+      std::scoped_lock lock(mutex);
+      next_delivered_frame_number++;
+    }
+    frame_delivered.notify_all();
+  }
+}
+
+FrameEncoder::FrameEncoder(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+    SkEncodedImageFormat format,
+    int quality,
+    size_t max_pending_frames,
+    Callback callback)
+    : task_runner_(std::move(task_runner)),
+      format_(format),
+      quality_(quality),
+      max_pending_frames_(std::max<size_t>(max_pending_frames, 1)),
+      state_(std::make_shared<State>(std::move(callback))) {
+  FML_DCHECK(task_runner_);
+  FML_DCHECK(state_->callback);
+}
+
+FrameEncoder::~FrameEncoder() {
+  WaitForPendingFrames();
+}
+
+uint64_t FrameEncoder::Encode(const SkPixmap& pixels) {
+  TRACE_EVENT0("flutter", "FrameEncoder::Encode");
+  uint64_t frame_number = 0;
+  {
+    std::unique_lock lock(state_->mutex);
+    if (state_->GetPendingFrameCountLocked() >= max_pending_frames_) {
+      TRACE_EVENT0("flutter", "FrameEncoder::WaitForEncoder");
+      state_->frame_delivered.wait(lock, [this]() {
+        return state_->GetPendingFrameCountLocked() < max_pending_frames_;
+      });
+    }
+    frame_number = state_->next_frame_number++;
+  }
+
+  // The pixels usually belong to a backing store that is reused for the next
+  // frame.
+  sk_sp<SkImage> image = SkImage::MakeRasterCopy(pixels);
+  if (!image) {
+    FML_LOG(ERROR) << "Could not copy frame " << frame_number
+                   << " for encoding.";
+  }
+
+  task_runner_->PostTask([state = state_, image = std::move(image),
+                          frame_number, size = pixels.info().dimensions(),
+                          format = format_, quality = quality_]() {
+    TRACE_EVENT0("flutter", "FrameEncoder::EncodeFrame");
+    sk_sp<SkData> data =
+        image ? image->encodeToData(format, quality) : nullptr;
+    if (image && !data) {
+      FML_LOG(ERROR) << "Could not encode frame " << frame_number << ".";
+    }
+    state->OnFrameEncoded(frame_number, size, std::move(data));
+  });
+
+  return frame_number;
+}
+
+void FrameEncoder::WaitForPendingFrames() {
+  std::unique_lock lock(state_->mutex);
+  state_->frame_delivered.wait(
+      lock, [this]() { return state_->GetPendingFrameCountLocked() == 0; });
+}
+
+size_t FrameEncoder::GetPendingFrameCount() const {
+  std::scoped_lock lock(state_->mutex);
+  return state_->GetPendingFrameCountLocked();
+}
+
+}  // namespace flutter
@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_ENCODER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_ENCODER_H_
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkEncodedImageFormat.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Encodes rendered frames into an image format for headless rendering.
+///
+/// Frames are copied on the thread that submits them and encoded on a
+/// concurrent task runner, so that encoding does not limit the rate at which
+/// frames are rendered. Encoded frames are nevertheless delivered to the
+/// callback one at a time and in the order they were submitted.
+///
+/// To keep memory usage bounded, |Encode| blocks while the maximum number of
+/// frames are waiting to be encoded or delivered. This applies back pressure
+/// to the rasterizer when encoding is slower than rendering.
+///
+class FrameEncoder {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Invoked on the task runner with each encoded frame. The data
+  ///             is null if the frame could not be encoded.
+  ///
+  using Callback = std::function<
+      void(uint64_t frame_number, const SkISize& size, sk_sp<SkData> data)>;
+
+  FrameEncoder(std::shared_ptr<fml::ConcurrentTaskRunner> task_runner,
+               SkEncodedImageFormat format,
+               int quality,
+               size_t max_pending_frames,
+               Callback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Waits for all submitted frames to be delivered.
+  ///
+  ~FrameEncoder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Copies the pixels of a frame and schedules them to be
+  ///             encoded.
+  ///
+  /// @return     The number of the frame. Frames are numbered from zero in the
+  ///             order they are submitted.
+  ///
+  uint64_t Encode(const SkPixmap& pixels);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Blocks until all submitted frames were delivered.
+  ///
+  void WaitForPendingFrames();
+
+  size_t GetPendingFrameCount() const;
+
+ private:
+  // Shared with the encoding tasks, which still signal |frame_delivered| after
+  // the encoder may have stopped waiting for them.
+  struct State {
+    // Guards the frame numbers and |encoded_frames|.
+    mutable std::mutex mutex;
+    std::condition_variable frame_delivered;
+    uint64_t next_frame_number = 0;
+    uint64_t next_delivered_frame_number = 0;
+    std::map<uint64_t, std::pair<SkISize, sk_sp<SkData>>> encoded_frames;
+    // Serializes the invocations of the callback.
+    std::mutex delivery_mutex;
+    const Callback callback;
+
+    explicit State(Callback callback);
+
+    // Must be called with |mutex| held.
+    size_t GetPendingFrameCountLocked() const;
+
+    void OnFrameEncoded(uint64_t frame_number,
+                        const SkISize& size,
+                        sk_sp<SkData> data);
+  };
+
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner_;
+  const SkEncodedImageFormat format_;
+  const int quality_;
+  const size_t max_pending_frames_;
+  std::shared_ptr<State> state_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameEncoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_ENCODER_H_
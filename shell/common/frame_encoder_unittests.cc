@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_encoder.h"
+
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+namespace testing {
+
+static SkBitmap MakeFrame(SkColor color) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(64, 32);
+  bitmap.eraseColor(color);
+  return bitmap;
+}
+
+TEST(FrameEncoderTest, DeliversFramesInOrder) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  std::vector<uint64_t> frame_numbers;
+  std::vector<SkColor> colors;
+  {
+    FrameEncoder encoder(
+        loop->GetTaskRunner(), SkEncodedImageFormat::kPNG, 100, 8,
+        [&](uint64_t frame_number, const SkISize& size, sk_sp<SkData> data) {
+          ASSERT_EQ(size, SkISize::Make(64, 32));
+          ASSERT_TRUE(data);
+          auto image = SkImage::MakeFromEncoded(data);
+          ASSERT_TRUE(image);
+          SkBitmap decoded;
+          ASSERT_TRUE(decoded.tryAllocN32Pixels(64, 32));
+          ASSERT_TRUE(image->readPixels(decoded.pixmap(), 0, 0));
+          frame_numbers.push_back(frame_number);
+          colors.push_back(decoded.getColor(0, 0));
+        });
+    for (int i = 0; i < 32; i++) {
+      auto frame = MakeFrame(i % 2 == 0 ? SK_ColorRED : SK_ColorBLUE);
+      ASSERT_EQ(encoder.Encode(frame.pixmap()), static_cast<uint64_t>(i));
+    }
+  }
+
+  ASSERT_EQ(frame_numbers.size(), 32u);
+  for (size_t i = 0; i < frame_numbers.size(); i++) {
+    ASSERT_EQ(frame_numbers[i], i);
+    ASSERT_EQ(colors[i], i % 2 == 0 ? SK_ColorRED : SK_ColorBLUE);
+  }
+}
+
+TEST(FrameEncoderTest, BlocksWhileTooManyFramesArePending) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  fml::ManualResetWaitableEvent release_delivery;
+  FrameEncoder encoder(loop->GetTaskRunner(), SkEncodedImageFormat::kPNG, 100,
+                       2, [&](uint64_t, const SkISize&, sk_sp<SkData>) {
+                         release_delivery.Wait();
+                       });
+
+  auto frame = MakeFrame(SK_ColorGREEN);
+  encoder.Encode(frame.pixmap());
+  encoder.Encode(frame.pixmap());
+  ASSERT_EQ(encoder.GetPendingFrameCount(), 2u);
+
+  fml::AutoResetWaitableEvent encoded_third_frame;
+  std::thread thread([&]() {
+    encoder.Encode(frame.pixmap());
+    encoded_third_frame.Signal();
+  });
+  // Times out since the third frame waits for the first to be delivered.
+  ASSERT_TRUE(encoded_third_frame.WaitWithTimeout(
+      fml::TimeDelta::FromMilliseconds(50)));
+
+  release_delivery.Signal();
+  encoded_third_frame.Wait();
+  thread.join();
+  encoder.WaitForPendingFrames();
+  ASSERT_EQ(encoder.GetPendingFrameCount(), 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_statistics.h"
+
+namespace flutter {
+
+static FrameStatistics::Percentiles GetPercentiles(
+    const TimeHistogram& histogram) {
+  FrameStatistics::Percentiles percentiles;
+  percentiles.p50 = histogram.Percentile(50);
+  percentiles.p90 = histogram.Percentile(90);
+  percentiles.p99 = histogram.Percentile(99);
+  percentiles.p999 = histogram.Percentile(99.9);
+  percentiles.max = histogram.Max();
+  return percentiles;
+}
+
+FrameStatistics::FrameStatistics() = default;
+
+FrameStatistics::~FrameStatistics() = default;
+
+void FrameStatistics::Record(const FrameTiming& timing) {
+  const fml::TimePoint build_start = timing.Get(FrameTiming::kBuildStart);
+  const fml::TimeDelta build_time =
+      timing.Get(FrameTiming::kBuildFinish) - build_start;
+  const fml::TimeDelta raster_time = timing.Get(FrameTiming::kRasterFinish) -
+                                     timing.Get(FrameTiming::kRasterStart);
+  const fml::TimeDelta total_time =
+      timing.Get(FrameTiming::kRasterFinish) - build_start;
+
+  // Frames that were not started by a vsync (e.g. in tests) don't have a
+  // target time. Assume a 60Hz display for those.
+  fml::TimeDelta budget = timing.GetFrameTargetTime() - build_start;
+  if (budget <= fml::TimeDelta::Zero()) {
+    budget = fml::TimeDelta::FromSecondsF(kOneFrameMS / 1e3);
+  }
+
+  std::scoped_lock lock(mutex_);
+  build_time_.Record(build_time);
+  raster_time_.Record(raster_time);
+  total_time_.Record(total_time);
+  if (build_time > budget || raster_time > budget) {
+    dropped_frame_count_++;
+  }
+  if (timing.GetCompiledNewShaders()) {
+    shader_compilation_frame_count_++;
+  }
+}
+
+FrameStatistics::Summary FrameStatistics::GetSummary() const {
+  std::scoped_lock lock(mutex_);
+  Summary summary;
+  summary.frame_count = total_time_.count();
+  summary.dropped_frame_count = dropped_frame_count_;
+  summary.shader_compilation_frame_count = shader_compilation_frame_count_;
+  summary.build_time = GetPercentiles(build_time_);
+  summary.raster_time = GetPercentiles(raster_time_);
+  summary.total_time = GetPercentiles(total_time_);
+  return summary;
+}
+
+void FrameStatistics::Reset() {
+  std::scoped_lock lock(mutex_);
+  build_time_.Reset();
+  raster_time_.Reset();
+  total_time_.Reset();
+  dropped_frame_count_ = 0;
+  shader_compilation_frame_count_ = 0;
+}
+
+}  // namespace flutter
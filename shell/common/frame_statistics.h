@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_STATISTICS_H_
+#define FLUTTER_SHELL_COMMON_FRAME_STATISTICS_H_
+
+#include <mutex>
+
+#include "flutter/common/settings.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Aggregates the timings of every rasterized frame into histograms so that
+/// tail latencies and jank can be monitored in production, independently of
+/// the performance overlay and of the Dart side timings callback.
+///
+/// Frames are recorded on the GPU thread. Summaries may be requested from any
+/// thread.
+///
+class FrameStatistics {
+ public:
+  struct Percentiles {
+    fml::TimeDelta p50;
+    fml::TimeDelta p90;
+    fml::TimeDelta p99;
+    fml::TimeDelta p999;
+    fml::TimeDelta max;
+  };
+
+  struct Summary {
+    size_t frame_count = 0;
+    // Frames whose build or raster phase did not fit in the frame budget.
+    size_t dropped_frame_count = 0;
+    // Frames during which Skia compiled at least one new shader.
+    size_t shader_compilation_frame_count = 0;
+    // Time spent on the UI thread building the layer tree.
+    Percentiles build_time;
+    // Time spent on the GPU thread rasterizing the layer tree.
+    Percentiles raster_time;
+    // Time from the vsync that started the frame to the end of its
+    // rasterization.
+    Percentiles total_time;
+  };
+
+  FrameStatistics();
+
+  ~FrameStatistics();
+
+  void Record(const FrameTiming& timing);
+
+  Summary GetSummary() const;
+
+  void Reset();
+
+ private:
+  mutable std::mutex mutex_;
+  TimeHistogram build_time_;
+  TimeHistogram raster_time_;
+  TimeHistogram total_time_;
+  size_t dropped_frame_count_ = 0;
+  size_t shader_compilation_frame_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameStatistics);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_STATISTICS_H_
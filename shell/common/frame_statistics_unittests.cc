@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_statistics.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static FrameTiming MakeTiming(int64_t build_ms,
+                              int64_t raster_ms,
+                              int64_t budget_ms,
+                              bool compiled_new_shaders = false) {
+  const fml::TimePoint vsync = fml::TimePoint::Now();
+  const fml::TimePoint build_finish =
+      vsync + fml::TimeDelta::FromMilliseconds(build_ms);
+  FrameTiming timing;
+  timing.Set(FrameTiming::kBuildStart, vsync);
+  timing.Set(FrameTiming::kBuildFinish, build_finish);
+  timing.Set(FrameTiming::kRasterStart, build_finish);
+  timing.Set(FrameTiming::kRasterFinish,
+             build_finish + fml::TimeDelta::FromMilliseconds(raster_ms));
+  timing.SetFrameTargetTime(vsync +
+                            fml::TimeDelta::FromMilliseconds(budget_ms));
+  timing.SetCompiledNewShaders(compiled_new_shaders);
+  return timing;
+}
+
+TEST(FrameStatisticsTest, SummarizesPhases) {
+  FrameStatistics statistics;
+  for (int i = 0; i < 99; i++) {
+    statistics.Record(MakeTiming(4, 6, 16));
+  }
+  statistics.Record(MakeTiming(4, 40, 16));
+
+  const auto summary = statistics.GetSummary();
+  ASSERT_EQ(summary.frame_count, 100u);
+  ASSERT_EQ(summary.dropped_frame_count, 1u);
+  ASSERT_EQ(summary.shader_compilation_frame_count, 0u);
+  ASSERT_EQ(summary.build_time.p50.ToMilliseconds(), 4);
+  ASSERT_EQ(summary.raster_time.p50.ToMilliseconds(), 6);
+  ASSERT_EQ(summary.raster_time.p99.ToMilliseconds(), 6);
+  ASSERT_EQ(summary.raster_time.max.ToMilliseconds(), 40);
+  ASSERT_EQ(summary.total_time.p50.ToMilliseconds(), 10);
+  ASSERT_EQ(summary.total_time.max.ToMilliseconds(), 44);
+}
+
+TEST(FrameStatisticsTest, UsesFrameBudgetOfTheVsync) {
+  FrameStatistics statistics;
+  // 12ms fits in a 60Hz frame but not in a 120Hz one.
+  statistics.Record(MakeTiming(12, 1, 16));
+  statistics.Record(MakeTiming(12, 1, 8));
+  statistics.Record(MakeTiming(1, 12, 8));
+  ASSERT_EQ(statistics.GetSummary().dropped_frame_count, 2u);
+}
+
+TEST(FrameStatisticsTest, CountsShaderCompilationFrames) {
+  FrameStatistics statistics;
+  statistics.Record(MakeTiming(1, 30, 16, true));
+  statistics.Record(MakeTiming(1, 2, 16, false));
+  statistics.Record(MakeTiming(1, 3, 16, true));
+  ASSERT_EQ(statistics.GetSummary().shader_compilation_frame_count, 2u);
+}
+
+TEST(FrameStatisticsTest, Reset) {
+  FrameStatistics statistics;
+  statistics.Record(MakeTiming(20, 20, 16, true));
+  statistics.Reset();
+
+  const auto summary = statistics.GetSummary();
+  ASSERT_EQ(summary.frame_count, 0u);
+  ASSERT_EQ(summary.dropped_frame_count, 0u);
+  ASSERT_EQ(summary.shader_compilation_frame_count, 0u);
+  ASSERT_EQ(summary.total_time.max, fml::TimeDelta::Zero());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -20,6 +20,12 @@ namespace flutter {
 
 std::string PersistentCache::cache_base_path_;
 
+// New entries are usually stored in bursts (e.g. when a new screen compiles
+// its shaders). Wait a bit before writing them so that a burst ends up in a
+// single batch, unless a lot of data is waiting already.
+static constexpr fml::TimeDelta kFlushDelay = fml::TimeDelta::FromSeconds(1);
+static constexpr size_t kMaxPendingBytes = 1 << 20;
+
 static std::string SkKeyToFilePath(const SkData& data) {
   if (data.data() == nullptr || data.size() == 0) {
     return "";
@@ -77,25 +83,60 @@ std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
 
 PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
-      cache_directory_(MakeCacheDirectory(cache_base_path_, read_only)) {
+      cache_directory_(MakeCacheDirectory(cache_base_path_, read_only)),
+      pack_(std::make_shared<PersistentCachePack>(cache_directory_,
+                                                  read_only)) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
+    return;
+  }
+
+  if (!read_only) {
+    legacy_entries_migrated_ = pack_->MigrateLegacyEntries();
   }
 }
 
-PersistentCache::~PersistentCache() = default;
+PersistentCache::~PersistentCache() {
+  Flush();
+}
 
 bool PersistentCache::IsValid() const {
   return cache_directory_ && cache_directory_->is_valid();
 }
 
+static thread_local size_t tls_load_count = 0;
+
+size_t PersistentCache::GetLoadCountOnCurrentThread() {
+  return tls_load_count;
+}
+
 // |GrContextOptions::PersistentCache|
 sk_sp<SkData> PersistentCache::load(const SkData& key) {
   TRACE_EVENT0("flutter", "PersistentCacheLoad");
+  tls_load_count++;
   if (!IsValid()) {
     return nullptr;
   }
+
+  sk_sp<SkData> result;
+  pack_->Load({reinterpret_cast<const char*>(key.data()), key.size()},
+              [&result](const uint8_t* data, size_t size) {
+                if (size > 0) {
+                  result = SkData::MakeWithCopy(data, size);
+                }
+              });
+  if (result) {
+    TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
+    return result;
+  }
+
+  // Once migrated, writable caches only contain the pack file. Read-only
+  // caches may still have been shipped with one file per entry.
+  if (legacy_entries_migrated_) {
+    return nullptr;
+  }
+
   auto file_name = SkKeyToFilePath(key);
   if (file_name.size() == 0) {
     return nullptr;
@@ -156,21 +197,63 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  auto file_name = SkKeyToFilePath(key);
-
-  if (file_name.size() == 0) {
+  if (key.data() == nullptr || key.size() == 0 || data.size() == 0) {
     return;
   }
 
-  auto mapping = std::make_unique<fml::DataMapping>(
-      std::vector<uint8_t>{data.bytes(), data.bytes() + data.size()});
+  const size_t pending_bytes =
+      pack_->Store({reinterpret_cast<const char*>(key.data()), key.size()},
+                   data.bytes(), data.size());
+  ScheduleFlush(pending_bytes);
+}
 
-  if (mapping == nullptr || mapping->GetSize() == 0) {
-    return;
+void PersistentCache::ScheduleFlush(size_t pending_bytes) {
+  const bool flush_now = pending_bytes >= kMaxPendingBytes;
+  const fml::TimePoint now = fml::TimePoint::Now();
+  {
+    std::scoped_lock lock(worker_task_runners_mutex_);
+    if (flush_task_runner_ && now < flush_time_ && !flush_now) {
+      // The pending entries will be part of the batch that is already
+      // scheduled.
+      return;
+    }
+
+    if (!worker_task_runners_.empty()) {
+      const fml::TimeDelta delay =
+          flush_now ? fml::TimeDelta::Zero() : kFlushDelay;
+      flush_task_runner_ = *worker_task_runners_.begin();
+      flush_time_ = now + delay;
+      flush_task_runner_->PostDelayedTask(
+          [pack = std::weak_ptr<PersistentCachePack>(pack_)]() {
+            if (auto strong_pack = pack.lock()) {
+              FlushPack(*strong_pack);
+            }
+          },
+          delay);
+      return;
+    }
+    flush_task_runner_ = nullptr;
   }
 
-  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_,
-                       std::move(file_name), std::move(mapping));
+  FML_LOG(WARNING)
+      << "The persistent cache has no available workers. Performing the task "
+         "on the current thread. This slow operation is going to occur on a "
+         "frame workload.";
+  Flush();
+}
+
+void PersistentCache::FlushPack(PersistentCachePack& pack) {
+  TRACE_EVENT0("flutter", "PersistentCacheStore");
+  if (pack.IsValid() && !pack.Flush()) {
+    FML_DLOG(WARNING) << "Could not write cache contents to persistent store.";
+  }
+}
+
+void PersistentCache::Flush() {
+  if (!is_read_only_ && !legacy_entries_migrated_) {
+    legacy_entries_migrated_ = pack_->MigrateLegacyEntries();
+  }
+  FlushPack(*pack_);
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
@@ -199,10 +282,24 @@ void PersistentCache::AddWorkerTaskRunner(
 
 void PersistentCache::RemoveWorkerTaskRunner(
     fml::RefPtr<fml::TaskRunner> task_runner) {
-  std::scoped_lock lock(worker_task_runners_mutex_);
-  auto found = worker_task_runners_.find(task_runner);
-  if (found != worker_task_runners_.end()) {
-    worker_task_runners_.erase(found);
+  bool flush = false;
+  {
+    std::scoped_lock lock(worker_task_runners_mutex_);
+    auto found = worker_task_runners_.find(task_runner);
+    if (found != worker_task_runners_.end()) {
+      worker_task_runners_.erase(found);
+    }
+    // The scheduled flush may never run if its task runner goes away.
+    if (flush_task_runner_ == task_runner &&
+        worker_task_runners_.count(task_runner) == 0) {
+      flush_task_runner_ = nullptr;
+      flush = true;
+    }
+    flush = flush || worker_task_runners_.empty();
+  }
+
+  if (flush) {
+    Flush();
   }
 }
 
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_H_
 #define FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -12,7 +13,9 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/synchronization/thread_annotations.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/shell/common/persistent_cache_pack.h"
 #include "third_party/skia/include/gpu/GrContextOptions.h"
 
 namespace flutter {
@@ -21,6 +24,13 @@ namespace flutter {
 ///
 /// This is mainly used for Shaders but is also written to by Dart.  It is
 /// thread-safe for reading and writing from multiple threads.
+///
+/// Entries live in a single pack file (see |PersistentCachePack|) that is
+/// indexed once when the cache is created. New entries are written to disk
+/// in batches on a worker task runner. Caches written by older engines, which
+/// used one file per entry, are migrated into the pack file. Until that
+/// migration succeeds, entries missing from the pack are still looked up in
+/// their own files.
 class PersistentCache : public GrContextOptions::PersistentCache {
  public:
   // Mutable static switch that can be set before GetCacheForProcess. If true,
@@ -40,6 +50,10 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   void RemoveWorkerTaskRunner(fml::RefPtr<fml::TaskRunner> task_runner);
 
+  // Writes the entries that are waiting for the next batch to disk. Retries
+  // migrating the entries of older engines if that failed before.
+  void Flush();
+
   // Whether Skia tries to store any shader into this persistent cache after
   // |ResetStoredNewShaders| is called. This flag is usually reset before each
   // frame so we can know if Skia tries to compile new shaders in that frame.
@@ -49,14 +63,28 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   bool IsDumpingSkp() const { return is_dumping_skp_; }
   void SetIsDumpingSkp(bool value) { is_dumping_skp_ = value; }
 
+  // The number of times Skia asked for a shader program on the calling thread,
+  // whether or not it was found. Each request is a program that a context used
+  // on this thread had to compile or link. Requests made by contexts on other
+  // threads, such as the resource context on the IO thread, are not counted.
+  static size_t GetLoadCountOnCurrentThread();
+
  private:
   static std::string cache_base_path_;
 
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
+  // Shared with scheduled flushes, which may outlive the cache.
+  const std::shared_ptr<PersistentCachePack> pack_;
+  std::atomic<bool> legacy_entries_migrated_ = false;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_
       FML_GUARDED_BY(worker_task_runners_mutex_);
+  // The worker on which a flush of the pack is scheduled, if any, and the
+  // time at which it runs. Entries stored before then are part of that flush.
+  fml::RefPtr<fml::TaskRunner> flush_task_runner_
+      FML_GUARDED_BY(worker_task_runners_mutex_);
+  fml::TimePoint flush_time_ FML_GUARDED_BY(worker_task_runners_mutex_);
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
@@ -73,6 +101,11 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   fml::RefPtr<fml::TaskRunner> GetWorkerTaskRunner() const;
 
+  // Flushes on a worker after a delay, or right away if there is no worker.
+  void ScheduleFlush(size_t pending_bytes);
+
+  static void FlushPack(PersistentCachePack& pack);
+
   FML_DISALLOW_COPY_AND_ASSIGN(PersistentCache);
 };
 
@@ -0,0 +1,491 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/persistent_cache_pack.h"
+
+#include <cstring>
+#include <limits>
+
+#include "flutter/fml/base32.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+// The pack file starts with a |PackHeader| followed by records. Each record
+// is a |RecordHeader| followed by the key and the value bytes. Integers are
+// stored in the byte order of the device since the cache is never shared
+// between devices.
+struct PackHeader {
+  uint32_t magic;
+  uint32_t version;
+};
+
+struct RecordHeader {
+  uint32_t key_size;
+  uint32_t value_size;
+  // FNV-1a of the sizes, the key and the value.
+  uint32_t checksum;
+};
+
+static constexpr uint32_t kPackMagic = 0x4b504346;  // "FCPK"
+static constexpr uint32_t kPackVersion = 1;
+
+// Superseded records are only dropped once they make up at least half of the
+// file and are larger than this. This keeps compaction, which rewrites the
+// whole file, rare.
+static constexpr size_t kCompactionMinDeadBytes = 64 * 1024;
+
+constexpr char PersistentCachePack::kFileName[];
+
+static uint32_t Fnv1a(uint32_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+static uint32_t RecordChecksum(uint32_t key_size,
+                               uint32_t value_size,
+                               const void* key,
+                               const void* value) {
+  uint32_t hash = 2166136261u;
+  hash = Fnv1a(hash, &key_size, sizeof(key_size));
+  hash = Fnv1a(hash, &value_size, sizeof(value_size));
+  hash = Fnv1a(hash, key, key_size);
+  return Fnv1a(hash, value, value_size);
+}
+
+static size_t RecordSize(size_t key_size, size_t value_size) {
+  return sizeof(RecordHeader) + key_size + value_size;
+}
+
+// Writes a record at |destination| and returns the offset of its value
+// relative to |destination|.
+static size_t WriteRecord(uint8_t* destination,
+                          std::string_view key,
+                          const uint8_t* value,
+                          size_t value_size) {
+  RecordHeader header;
+  header.key_size = key.size();
+  header.value_size = value_size;
+  header.checksum =
+      RecordChecksum(header.key_size, header.value_size, key.data(), value);
+  ::memcpy(destination, &header, sizeof(header));
+  ::memcpy(destination + sizeof(header), key.data(), key.size());
+  ::memcpy(destination + sizeof(header) + key.size(), value, value_size);
+  return sizeof(header) + key.size();
+}
+
+PersistentCachePack::PersistentCachePack(
+    std::shared_ptr<fml::UniqueFD> directory,
+    bool read_only)
+    : directory_(std::move(directory)), read_only_(read_only) {
+  TRACE_EVENT0("flutter", "PersistentCachePack::Open");
+  if (!Open()) {
+    file_.reset();
+  }
+}
+
+PersistentCachePack::~PersistentCachePack() = default;
+
+bool PersistentCachePack::IsValid() const {
+  std::scoped_lock lock(mutex_);
+  return file_.is_valid();
+}
+
+bool PersistentCachePack::Open() {
+  if (!directory_ || !directory_->is_valid()) {
+    return false;
+  }
+
+  file_ = fml::OpenFile(*directory_, kFileName, !read_only_,
+                        read_only_ ? fml::FilePermission::kRead
+                                   : fml::FilePermission::kReadWrite);
+  if (!file_.is_valid()) {
+    return false;
+  }
+
+  std::scoped_lock lock(mutex_);
+  RemapLocked();
+
+  PackHeader header = {};
+  if (mapping_->GetSize() >= sizeof(header)) {
+    ::memcpy(&header, mapping_->GetMapping(), sizeof(header));
+  }
+
+  if (header.magic != kPackMagic || header.version != kPackVersion) {
+    if (read_only_) {
+      FML_LOG(ERROR) << "The persistent cache pack is corrupt or was created "
+                        "by an incompatible engine.";
+      return false;
+    }
+
+    // Start over with an empty pack.
+    mapping_.reset();
+    header.magic = kPackMagic;
+    header.version = kPackVersion;
+    if (!fml::TruncateFile(file_, 0) ||
+        !fml::TruncateFile(file_, sizeof(header))) {
+      return false;
+    }
+    {
+      fml::FileMapping writable(file_, {fml::FileMapping::Protection::kRead,
+                                        fml::FileMapping::Protection::kWrite});
+      if (writable.GetMutableMapping() == nullptr) {
+        return false;
+      }
+      ::memcpy(writable.GetMutableMapping(), &header, sizeof(header));
+    }
+    if (!RemapLocked()) {
+      return false;
+    }
+  }
+
+  ReadIndexLocked();
+
+  // Drop a partially written batch so that new records can be appended.
+  if (!read_only_ && file_size_ < mapping_->GetSize()) {
+    FML_LOG(WARNING) << "Discarding "
+                     << mapping_->GetSize() - file_size_
+                     << " bytes of incomplete records in the persistent cache.";
+    mapping_.reset();
+    if (!fml::TruncateFile(file_, file_size_)) {
+      return false;
+    }
+    return RemapLocked();
+  }
+
+  return true;
+}
+
+bool PersistentCachePack::RemapLocked() {
+  mapping_ = std::make_unique<fml::FileMapping>(file_);
+  return mapping_->GetMapping() != nullptr;
+}
+
+void PersistentCachePack::ReadIndexLocked() {
+  index_.clear();
+  live_bytes_ = 0;
+  dead_bytes_ = 0;
+
+  const uint8_t* data = mapping_->GetMapping();
+  const size_t size = mapping_->GetSize();
+  size_t offset = sizeof(PackHeader);
+
+  while (size - offset >= sizeof(RecordHeader)) {
+    RecordHeader header;
+    ::memcpy(&header, data + offset, sizeof(header));
+    const size_t available = size - offset - sizeof(header);
+    if (header.key_size > available ||
+        header.value_size > available - header.key_size) {
+      break;
+    }
+
+    const uint8_t* key = data + offset + sizeof(header);
+    const uint8_t* value = key + header.key_size;
+    if (RecordChecksum(header.key_size, header.value_size, key, value) !=
+        header.checksum) {
+      break;
+    }
+
+    const size_t record_size = RecordSize(header.key_size, header.value_size);
+    Entry& entry = index_[std::string{reinterpret_cast<const char*>(key),
+                                      header.key_size}];
+    if (entry.offset != 0) {
+      const size_t superseded = RecordSize(header.key_size, entry.size);
+      live_bytes_ -= superseded;
+      dead_bytes_ += superseded;
+    }
+    entry.offset = value - data;
+    entry.size = header.value_size;
+    live_bytes_ += record_size;
+    offset += record_size;
+  }
+
+  file_size_ = offset;
+}
+
+bool PersistentCachePack::Load(std::string_view key,
+                               const Reader& reader) const {
+  std::scoped_lock lock(mutex_);
+
+  // The lookups have to construct a key because the maps aren't transparent.
+  std::string key_string(key);
+
+  for (const Batch* batch : {&pending_, &flushing_}) {
+    auto pending = batch->find(key_string);
+    if (pending != batch->end()) {
+      reader(pending->second.data(), pending->second.size());
+      return true;
+    }
+  }
+
+  auto found = index_.find(key_string);
+  if (found == index_.end() || !mapping_ ||
+      found->second.offset + found->second.size > mapping_->GetSize()) {
+    return false;
+  }
+
+  reader(mapping_->GetMapping() + found->second.offset, found->second.size);
+  return true;
+}
+
+size_t PersistentCachePack::Store(std::string_view key,
+                                  const uint8_t* data,
+                                  size_t size) {
+  std::scoped_lock lock(mutex_);
+  if (key.size() > std::numeric_limits<uint32_t>::max() ||
+      size > std::numeric_limits<uint32_t>::max()) {
+    return pending_bytes_;
+  }
+
+  auto [pending, inserted] = pending_.try_emplace(std::string{key});
+  if (!inserted) {
+    pending_bytes_ -= RecordSize(key.size(), pending->second.size());
+  }
+  pending->second.assign(data, data + size);
+  pending_bytes_ += RecordSize(key.size(), size);
+  return pending_bytes_;
+}
+
+bool PersistentCachePack::Flush() {
+  TRACE_EVENT0("flutter", "PersistentCachePack::Flush");
+  std::scoped_lock flush_lock(flush_mutex_);
+
+  size_t batch_bytes = 0;
+  bool compact = false;
+  {
+    std::scoped_lock lock(mutex_);
+    if (pending_.empty()) {
+      return true;
+    }
+
+    if (read_only_ || !file_.is_valid()) {
+      return false;
+    }
+
+    flushing_ = std::move(pending_);
+    pending_.clear();
+    batch_bytes = pending_bytes_;
+    pending_bytes_ = 0;
+    compact =
+        dead_bytes_ >= kCompactionMinDeadBytes && dead_bytes_ >= live_bytes_;
+  }
+
+  if (compact ? Compact(batch_bytes) : Append(batch_bytes)) {
+    return true;
+  }
+
+  std::scoped_lock lock(mutex_);
+  RestoreBatchLocked();
+  return false;
+}
+
+bool PersistentCachePack::Append(size_t batch_bytes) {
+  size_t old_size = 0;
+  size_t new_size = 0;
+  {
+    // Files can't be resized while they are mapped on some platforms. Only
+    // the size of the file is changed while lookups are blocked.
+    std::scoped_lock lock(mutex_);
+    old_size = file_size_;
+    new_size = old_size + batch_bytes;
+    mapping_.reset();
+    const bool grown = fml::TruncateFile(file_, new_size);
+    RemapLocked();
+    if (!grown) {
+      FML_LOG(ERROR) << "Could not grow the persistent cache pack.";
+      return false;
+    }
+  }
+
+  std::vector<std::pair<const std::string*, Entry>> appended;
+  appended.reserve(flushing_.size());
+  {
+    fml::FileMapping writable(file_, {fml::FileMapping::Protection::kRead,
+                                      fml::FileMapping::Protection::kWrite});
+    if (writable.GetMutableMapping() == nullptr ||
+        writable.GetSize() != new_size) {
+      FML_LOG(ERROR) << "Could not write to the persistent cache pack.";
+      std::scoped_lock lock(mutex_);
+      mapping_.reset();
+      fml::TruncateFile(file_, old_size);
+      RemapLocked();
+      return false;
+    }
+
+    size_t offset = old_size;
+    for (const auto& [key, value] : flushing_) {
+      Entry entry;
+      entry.offset = offset + WriteRecord(writable.GetMutableMapping() + offset,
+                                          key, value.data(), value.size());
+      entry.size = value.size();
+      appended.emplace_back(&key, entry);
+      offset += RecordSize(key.size(), value.size());
+    }
+    FML_DCHECK(offset == new_size);
+  }
+
+  std::scoped_lock lock(mutex_);
+  for (const auto& [key, entry] : appended) {
+    auto found = index_.find(*key);
+    if (found != index_.end()) {
+      const size_t superseded = RecordSize(key->size(), found->second.size);
+      live_bytes_ -= superseded;
+      dead_bytes_ += superseded;
+    }
+    index_[*key] = entry;
+    live_bytes_ += RecordSize(key->size(), entry.size);
+  }
+
+  file_size_ = new_size;
+  flushing_.clear();
+  return RemapLocked();
+}
+
+bool PersistentCachePack::Compact(size_t batch_bytes) {
+  TRACE_EVENT0("flutter", "PersistentCachePack::Compact");
+
+  // Gather the live records and the pending ones into a new file image.
+  size_t size = sizeof(PackHeader) + batch_bytes;
+  for (const auto& [key, entry] : index_) {
+    if (flushing_.count(key) == 0) {
+      size += RecordSize(key.size(), entry.size);
+    }
+  }
+
+  std::vector<uint8_t> image(size);
+  PackHeader header;
+  header.magic = kPackMagic;
+  header.version = kPackVersion;
+  ::memcpy(image.data(), &header, sizeof(header));
+
+  std::unordered_map<std::string, Entry> index;
+  size_t offset = sizeof(header);
+  auto write = [&](const std::string& key, const uint8_t* value,
+                   size_t value_size) {
+    Entry& entry = index[key];
+    entry.offset =
+        offset + WriteRecord(image.data() + offset, key, value, value_size);
+    entry.size = value_size;
+    offset += RecordSize(key.size(), value_size);
+  };
+  for (const auto& [key, entry] : index_) {
+    if (flushing_.count(key) == 0) {
+      write(key, mapping_->GetMapping() + entry.offset, entry.size);
+    }
+  }
+  for (const auto& [key, value] : flushing_) {
+    write(key, value.data(), value.size());
+  }
+  FML_DCHECK(offset == size);
+
+  // The file is replaced atomically. Lookups keep using the old mapping till
+  // the new file is in place, and the old file is kept in case that fails.
+  fml::DataMapping data(std::move(image));
+  if (!fml::WriteAtomically(*directory_, kFileName, data)) {
+    FML_LOG(ERROR) << "Could not compact the persistent cache pack.";
+    return Append(batch_bytes);
+  }
+
+  fml::UniqueFD file = fml::OpenFile(*directory_, kFileName, false,
+                                     fml::FilePermission::kReadWrite);
+  auto mapping =
+      file.is_valid() ? std::make_unique<fml::FileMapping>(file) : nullptr;
+
+  std::scoped_lock lock(mutex_);
+  file_ = std::move(file);
+  mapping_ = std::move(mapping);
+  if (!file_.is_valid()) {
+    index_.clear();
+    return false;
+  }
+
+  index_ = std::move(index);
+  file_size_ = size;
+  live_bytes_ = size - sizeof(header);
+  dead_bytes_ = 0;
+  flushing_.clear();
+  return mapping_->GetMapping() != nullptr;
+}
+
+void PersistentCachePack::RestoreBatchLocked() {
+  for (auto& [key, value] : flushing_) {
+    auto [pending, inserted] = pending_.try_emplace(key, std::move(value));
+    if (inserted) {
+      pending_bytes_ += RecordSize(key.size(), pending->second.size());
+    }
+  }
+  flushing_.clear();
+}
+
+bool PersistentCachePack::MigrateLegacyEntries() {
+  if (read_only_ || !IsValid()) {
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "PersistentCachePack::MigrateLegacyEntries");
+
+  // Entries of the old layout are named after the Base32 encoding of their
+  // key, which can't collide with the pack file or with SKP dumps.
+  std::vector<std::pair<std::string, std::string>> legacy_entries;
+  fml::VisitFiles(*directory_, [&legacy_entries](
+                                   const fml::UniqueFD& directory,
+                                   const std::string& filename) {
+    auto decoded = fml::Base32Decode(filename);
+    if (decoded.first && !decoded.second.empty()) {
+      legacy_entries.emplace_back(filename, std::move(decoded.second));
+    }
+    return true;
+  });
+
+  if (legacy_entries.empty()) {
+    return true;
+  }
+
+  for (const auto& [filename, key] : legacy_entries) {
+    auto mapping = fml::FileMapping::CreateReadOnly(*directory_, filename);
+    if (mapping && mapping->GetSize() > 0) {
+      Store(key, mapping->GetMapping(), mapping->GetSize());
+    }
+  }
+
+  if (!Flush()) {
+    return false;
+  }
+
+  for (const auto& entry : legacy_entries) {
+    fml::UnlinkFile(*directory_, entry.first.c_str());
+  }
+
+  FML_DLOG(INFO) << "Migrated " << legacy_entries.size()
+                 << " persistent cache entries into the pack file.";
+  return true;
+}
+
+size_t PersistentCachePack::GetEntryCount() const {
+  std::scoped_lock lock(mutex_);
+  size_t count = index_.size();
+  for (const auto& pending : pending_) {
+    count += index_.count(pending.first) == 0 ? 1 : 0;
+  }
+  for (const auto& flushing : flushing_) {
+    count += index_.count(flushing.first) == 0 &&
+                     pending_.count(flushing.first) == 0
+                 ? 1
+                 : 0;
+  }
+  return count;
+}
+
+size_t PersistentCachePack::GetDeadBytes() const {
+  std::scoped_lock lock(mutex_);
+  return dead_bytes_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,146 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_PACK_H_
+#define FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_PACK_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/thread_annotations.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// A key-value store backed by a single append-only pack file.
+///
+/// The pack file is memory mapped and indexed once when the pack is opened,
+/// after which lookups don't perform any system calls. Stores are buffered in
+/// memory until |Flush| appends them to the file in a single batch. Records
+/// that have been superseded by a newer value for the same key are dropped
+/// by rewriting the file when they take up too much space.
+///
+/// Each record is checksummed so that a batch that was only partially written
+/// (e.g. because the process was killed) is discarded on the next open.
+///
+/// All methods are thread-safe. Lookups don't wait for |Flush| to write the
+/// file.
+///
+class PersistentCachePack {
+ public:
+  static constexpr char kFileName[] = "persistent_cache.pack";
+
+  using Reader = std::function<void(const uint8_t* data, size_t size)>;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Opens or creates the pack in |directory|.
+  ///
+  /// @param[in]  directory  The directory that contains the pack file.
+  /// @param[in]  read_only  Whether the pack may be modified. A read-only
+  ///                        pack is invalid if the pack file doesn't exist.
+  ///
+  PersistentCachePack(std::shared_ptr<fml::UniqueFD> directory, bool read_only);
+
+  ~PersistentCachePack();
+
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up |key| and, if found, calls |reader| with its value.
+  ///             The value is only valid for the duration of the call.
+  ///
+  /// @return     Whether the key was found.
+  ///
+  bool Load(std::string_view key, const Reader& reader) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Buffers a value for |key|. The value is visible to |Load|
+  ///             immediately but is only persisted by the next |Flush|.
+  ///
+  /// @return     The number of bytes waiting to be flushed.
+  ///
+  size_t Store(std::string_view key, const uint8_t* data, size_t size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Appends all buffered values to the pack file, compacting the
+  ///             file first if it contains too many superseded records.
+  ///
+  /// @return     Whether all buffered values were persisted.
+  ///
+  bool Flush();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Moves the entries of the one-file-per-key cache layout (file
+  ///             names are the Base32 encoded keys) from the pack directory
+  ///             into the pack and removes the old files. The old files are
+  ///             kept if the pack could not be written.
+  ///
+  /// @return     Whether the directory no longer contains any entries of the
+  ///             old layout.
+  ///
+  bool MigrateLegacyEntries();
+
+  size_t GetEntryCount() const;
+
+  // Size of the records in the pack file that have been superseded.
+  size_t GetDeadBytes() const;
+
+ private:
+  struct Entry {
+    // Offset of the value in the pack file.
+    size_t offset = 0;
+    size_t size = 0;
+  };
+
+  using Batch = std::unordered_map<std::string, std::vector<uint8_t>>;
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const bool read_only_;
+  // Serializes the writers of the pack file, which write it without holding
+  // |mutex_|. The members describing the file are only replaced while holding
+  // both locks, so writers may read them while only holding this one.
+  std::mutex flush_mutex_;
+  mutable std::mutex mutex_;
+  fml::UniqueFD file_ FML_GUARDED_BY(mutex_);
+  std::unique_ptr<fml::FileMapping> mapping_ FML_GUARDED_BY(mutex_);
+  size_t file_size_ FML_GUARDED_BY(mutex_) = 0;
+  std::unordered_map<std::string, Entry> index_ FML_GUARDED_BY(mutex_);
+  size_t live_bytes_ FML_GUARDED_BY(mutex_) = 0;
+  size_t dead_bytes_ FML_GUARDED_BY(mutex_) = 0;
+  // Stored values that haven't been flushed yet.
+  Batch pending_ FML_GUARDED_BY(mutex_);
+  // The size of the records that |pending_| will be written as.
+  size_t pending_bytes_ FML_GUARDED_BY(mutex_) = 0;
+  // Values that are being written by |Flush|. They remain visible to |Load|
+  // till the index refers to their records.
+  Batch flushing_ FML_GUARDED_BY(mutex_);
+
+  bool Open();
+
+  void ReadIndexLocked() FML_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  bool RemapLocked() FML_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  bool Append(size_t batch_bytes) FML_EXCLUSIVE_LOCKS_REQUIRED(flush_mutex_);
+
+  bool Compact(size_t batch_bytes) FML_EXCLUSIVE_LOCKS_REQUIRED(flush_mutex_);
+
+  // Returns the values of a failed flush to |pending_| unless they have been
+  // stored again since.
+  void RestoreBatchLocked() FML_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PersistentCachePack);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_PACK_H_
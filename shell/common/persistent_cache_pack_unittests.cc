@@ -0,0 +1,244 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/persistent_cache_pack.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "flutter/fml/base32.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static std::shared_ptr<fml::UniqueFD> DuplicateDirectory(
+    fml::ScopedTemporaryDirectory& dir) {
+  return std::make_shared<fml::UniqueFD>(fml::Duplicate(dir.fd().get()));
+}
+
+static void StoreString(PersistentCachePack& pack,
+                        const std::string& key,
+                        const std::string& value) {
+  pack.Store(key, reinterpret_cast<const uint8_t*>(value.data()),
+             value.size());
+}
+
+static std::string LoadString(const PersistentCachePack& pack,
+                              const std::string& key) {
+  std::string result;
+  pack.Load(key, [&result](const uint8_t* data, size_t size) {
+    result.assign(reinterpret_cast<const char*>(data), size);
+  });
+  return result;
+}
+
+static size_t GetPackFileSize(fml::ScopedTemporaryDirectory& dir) {
+  auto mapping = fml::FileMapping::CreateReadOnly(
+      dir.fd(), PersistentCachePack::kFileName);
+  return mapping ? mapping->GetSize() : 0;
+}
+
+static void CleanUp(fml::ScopedTemporaryDirectory& dir) {
+  fml::UnlinkFile(dir.fd(), PersistentCachePack::kFileName);
+}
+
+TEST(PersistentCachePackTest, StoredValuesSurviveReopening) {
+  fml::ScopedTemporaryDirectory dir;
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), false);
+    ASSERT_TRUE(pack.IsValid());
+    ASSERT_EQ(pack.GetEntryCount(), 0u);
+
+    StoreString(pack, "key1", "value1");
+    StoreString(pack, "key2", "value2");
+    // Pending values are visible before they are flushed.
+    ASSERT_EQ(LoadString(pack, "key1"), "value1");
+    ASSERT_TRUE(pack.Flush());
+    ASSERT_EQ(LoadString(pack, "key2"), "value2");
+  }
+
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+  ASSERT_TRUE(pack.IsValid());
+  ASSERT_EQ(pack.GetEntryCount(), 2u);
+  ASSERT_EQ(LoadString(pack, "key1"), "value1");
+  ASSERT_EQ(LoadString(pack, "key2"), "value2");
+  ASSERT_FALSE(pack.Load("key3", [](const uint8_t*, size_t) { FAIL(); }));
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, UnflushedValuesAreNotPersisted) {
+  fml::ScopedTemporaryDirectory dir;
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), false);
+    StoreString(pack, "key", "value");
+  }
+
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+  ASSERT_EQ(pack.GetEntryCount(), 0u);
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, BatchesAreAppended) {
+  fml::ScopedTemporaryDirectory dir;
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+  StoreString(pack, "key1", "value1");
+  ASSERT_TRUE(pack.Flush());
+  const size_t size_after_first_batch = GetPackFileSize(dir);
+
+  StoreString(pack, "key2", "value2");
+  StoreString(pack, "key3", "value3");
+  ASSERT_TRUE(pack.Flush());
+  ASSERT_GT(GetPackFileSize(dir), size_after_first_batch);
+
+  ASSERT_EQ(LoadString(pack, "key1"), "value1");
+  ASSERT_EQ(LoadString(pack, "key2"), "value2");
+  ASSERT_EQ(LoadString(pack, "key3"), "value3");
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, IncompleteRecordsAreDiscarded) {
+  fml::ScopedTemporaryDirectory dir;
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), false);
+    StoreString(pack, "key1", "value1");
+    ASSERT_TRUE(pack.Flush());
+    StoreString(pack, "key2", "value2");
+    ASSERT_TRUE(pack.Flush());
+  }
+
+  // Simulate a batch that was only partially written.
+  {
+    auto file = fml::OpenFile(dir.fd(), PersistentCachePack::kFileName, false,
+                              fml::FilePermission::kReadWrite);
+    ASSERT_TRUE(fml::TruncateFile(file, GetPackFileSize(dir) - 2));
+  }
+
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), false);
+    ASSERT_TRUE(pack.IsValid());
+    ASSERT_EQ(pack.GetEntryCount(), 1u);
+    ASSERT_EQ(LoadString(pack, "key1"), "value1");
+
+    // The pack can still be appended to.
+    StoreString(pack, "key3", "value3");
+    ASSERT_TRUE(pack.Flush());
+  }
+
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+  ASSERT_EQ(pack.GetEntryCount(), 2u);
+  ASSERT_EQ(LoadString(pack, "key3"), "value3");
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, SupersededRecordsAreCompacted) {
+  fml::ScopedTemporaryDirectory dir;
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+
+  const std::string large_value(100 * 1024, 'a');
+  const std::string new_large_value(100 * 1024, 'b');
+  StoreString(pack, "key", large_value);
+  ASSERT_TRUE(pack.Flush());
+  StoreString(pack, "key", new_large_value);
+  ASSERT_TRUE(pack.Flush());
+  ASSERT_GT(pack.GetDeadBytes(), large_value.size());
+  ASSERT_GT(GetPackFileSize(dir), 2 * large_value.size());
+
+  // Half of the file is dead, so the next batch rewrites it.
+  StoreString(pack, "other", "value");
+  ASSERT_TRUE(pack.Flush());
+  ASSERT_EQ(pack.GetDeadBytes(), 0u);
+  ASSERT_LT(GetPackFileSize(dir), 2 * large_value.size());
+  ASSERT_EQ(LoadString(pack, "key"), new_large_value);
+  ASSERT_EQ(LoadString(pack, "other"), "value");
+
+  PersistentCachePack reopened(DuplicateDirectory(dir), false);
+  ASSERT_EQ(reopened.GetEntryCount(), 2u);
+  ASSERT_EQ(LoadString(reopened, "key"), new_large_value);
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, ValuesCanBeLoadedWhileFlushing) {
+  fml::ScopedTemporaryDirectory dir;
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+
+  StoreString(pack, "stable", "value");
+  ASSERT_TRUE(pack.Flush());
+
+  std::atomic<bool> done(false);
+  std::atomic<size_t> misses(0);
+  std::thread reader([&pack, &done, &misses]() {
+    while (!done) {
+      if (LoadString(pack, "stable") != "value") {
+        misses++;
+      }
+    }
+  });
+
+  // Superseding a large value over and over both appends and compacts.
+  const std::string large_value(100 * 1024, 'a');
+  for (size_t i = 0; i < 20; i++) {
+    StoreString(pack, "key", large_value);
+    EXPECT_TRUE(pack.Flush());
+    EXPECT_EQ(LoadString(pack, "key"), large_value);
+  }
+
+  done = true;
+  reader.join();
+  ASSERT_EQ(misses, 0u);
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, MigratesOneFilePerKeyLayout) {
+  fml::ScopedTemporaryDirectory dir;
+  const std::string key = "legacy key";
+  const std::string value = "legacy value";
+  const std::string file_name = fml::Base32Encode(key).second;
+  fml::DataMapping data(std::vector<uint8_t>{value.begin(), value.end()});
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), file_name.c_str(), data));
+  // Unrelated files are left alone.
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "shader_dump_1.skp", data));
+
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), false);
+    ASSERT_TRUE(pack.MigrateLegacyEntries());
+    ASSERT_EQ(LoadString(pack, key), value);
+    ASSERT_FALSE(fml::FileExists(dir.fd(), file_name.c_str()));
+    ASSERT_TRUE(fml::FileExists(dir.fd(), "shader_dump_1.skp"));
+    ASSERT_TRUE(pack.MigrateLegacyEntries());
+  }
+
+  PersistentCachePack pack(DuplicateDirectory(dir), false);
+  ASSERT_EQ(LoadString(pack, key), value);
+  fml::UnlinkFile(dir.fd(), "shader_dump_1.skp");
+  CleanUp(dir);
+}
+
+TEST(PersistentCachePackTest, ReadOnlyPack) {
+  fml::ScopedTemporaryDirectory dir;
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), true);
+    ASSERT_FALSE(pack.IsValid());
+  }
+  {
+    PersistentCachePack pack(DuplicateDirectory(dir), false);
+    StoreString(pack, "key", "value");
+    ASSERT_TRUE(pack.Flush());
+  }
+
+  PersistentCachePack pack(DuplicateDirectory(dir), true);
+  ASSERT_TRUE(pack.IsValid());
+  ASSERT_EQ(LoadString(pack, "key"), "value");
+  StoreString(pack, "other", "value");
+  ASSERT_FALSE(pack.Flush());
+  ASSERT_FALSE(pack.MigrateLegacyEntries());
+  CleanUp(dir);
+}
+
+}  // namespace testing
+}  // namespace flutter
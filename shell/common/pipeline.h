@@ -8,6 +8,8 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/synchronization/semaphore.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 
 #include <deque>
@@ -22,6 +24,18 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+enum class PipelineMode {
+  /// Resources are consumed in the order in which they were produced. Once
+  /// the pipeline is full, the producer has to wait for the consumer.
+  kQueue,
+  /// The producer always succeeds. A completed resource replaces the one that
+  /// is still waiting to be consumed, if any, so that the consumer always gets
+  /// the newest resource. This trades dropped resources for latency. Resources
+  /// pushed to the front are older than any waiting resource and are dropped
+  /// instead.
+  kMailbox,
+};
+
 size_t GetNextPipelineTraceID();
 
 /// A thread-safe queue of resources for a single consumer and a single
@@ -88,15 +102,19 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : depth_(depth), empty_(depth), available_(0) {}
+  explicit Pipeline(uint32_t depth, PipelineMode mode = PipelineMode::kQueue)
+      : depth_(depth), mode_(mode), empty_(depth), available_(0) {}
 
   ~Pipeline() = default;
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  PipelineMode mode() const { return mode_; }
+
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    // In mailbox mode there is never more than one resource waiting and the
+    // producer may always replace it.
+    if (mode_ == PipelineMode::kQueue && !empty_.TryWait()) {
       return {};
     }
 
@@ -122,33 +140,54 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
   using Consumer = std::function<void(ResourcePtr)>;
 
+  /// Like |Consumer| but also told how long the resource waited in the
+  /// pipeline between the producer completing it and it being consumed.
+  using TimedConsumer = std::function<void(ResourcePtr, fml::TimeDelta)>;
+
   FML_WARN_UNUSED_RESULT
   PipelineConsumeResult Consume(Consumer consumer) {
     if (consumer == nullptr) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
+    return Consume(TimedConsumer(
+        [&consumer](ResourcePtr resource, fml::TimeDelta queueing_delay) {
+          consumer(std::move(resource));
+        }));
+  }
+
+  FML_WARN_UNUSED_RESULT
+  PipelineConsumeResult Consume(TimedConsumer consumer) {
+    if (consumer == nullptr) {
+      return PipelineConsumeResult::NoneAvailable;
+    }
+
     if (!available_.TryWait()) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
+    QueueItem item;
     size_t items_count = 0;
 
     {
       std::scoped_lock lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
+      item = std::move(queue_.front());
       queue_.pop_front();
       items_count = queue_.size();
     }
 
+    const size_t trace_id = item.trace_id;
+    const fml::TimeDelta queueing_delay =
+        fml::TimePoint::Now() - item.commit_time;
+
     {
       TRACE_EVENT0("flutter", "PipelineConsume");
-      consumer(std::move(resource));
+      consumer(std::move(item.resource), queueing_delay);
     }
 
-    empty_.Signal();
+    if (mode_ == PipelineMode::kQueue) {
+      empty_.Signal();
+    }
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
     TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
@@ -158,16 +197,28 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   }
 
  private:
+  struct QueueItem {
+    ResourcePtr resource;
+    size_t trace_id = 0;
+    fml::TimePoint commit_time;
+  };
+
   uint32_t depth_;
+  const PipelineMode mode_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::mutex queue_mutex_;
-  std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  std::deque<QueueItem> queue_;
 
   void ProducerCommit(ResourcePtr resource, size_t trace_id) {
+    if (mode_ == PipelineMode::kMailbox) {
+      ProducerCommitMailbox(std::move(resource), trace_id, false);
+      return;
+    }
+
     {
       std::scoped_lock lock(queue_mutex_);
-      queue_.emplace_back(std::move(resource), trace_id);
+      queue_.push_back({std::move(resource), trace_id, fml::TimePoint::Now()});
     }
 
     // Ensure the queue mutex is not held as that would be a pessimization.
@@ -175,9 +226,14 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   }
 
   void ProducerCommitFront(ResourcePtr resource, size_t trace_id) {
+    if (mode_ == PipelineMode::kMailbox) {
+      ProducerCommitMailbox(std::move(resource), trace_id, true);
+      return;
+    }
+
     {
       std::scoped_lock lock(queue_mutex_);
-      queue_.emplace_front(std::move(resource), trace_id);
+      queue_.push_front({std::move(resource), trace_id, fml::TimePoint::Now()});
       while (queue_.size() > depth_) {
         queue_.pop_back();
       }
@@ -187,6 +243,45 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     available_.Signal();
   }
 
+  void ProducerCommitMailbox(ResourcePtr resource,
+                             size_t trace_id,
+                             bool front) {
+    // Continuations that are dropped without being completed reserved no slot
+    // and must not replace a resource that is still waiting.
+    if (!resource) {
+      return;
+    }
+
+    bool replaced = false;
+    {
+      std::scoped_lock lock(queue_mutex_);
+      FML_DCHECK(queue_.size() <= 1);
+      if (!queue_.empty() && front) {
+        // The waiting resource was produced after the one being pushed back to
+        // the front was consumed, so it is newer.
+        TRACE_EVENT_INSTANT0("flutter", "PipelineItemDropped");
+        TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", trace_id);
+        return;
+      }
+      if (!queue_.empty()) {
+        const size_t replaced_trace_id = queue_.front().trace_id;
+        TRACE_EVENT_INSTANT0("flutter", "PipelineItemReplaced");
+        TRACE_FLOW_END("flutter", "PipelineItem", replaced_trace_id);
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", replaced_trace_id);
+        queue_.clear();
+        replaced = true;
+      }
+      queue_.push_back({std::move(resource), trace_id, fml::TimePoint::Now()});
+    }
+
+    // The replaced resource was already accounted for. Only signal for new
+    // ones so that every wait of the consumer finds a resource.
+    if (!replaced) {
+      available_.Signal();
+    }
+  }
+
   FML_DISALLOW_COPY_AND_ASSIGN(Pipeline);
 };
 
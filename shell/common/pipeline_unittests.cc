@@ -131,5 +131,114 @@ TEST(PipelineTest, PushingToFrontDropsLastResource) {
   ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, MailboxProducerAlwaysSucceeds) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::kMailbox);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+  Continuation continuation_3 = pipeline->Produce();
+
+  ASSERT_TRUE(continuation_1);
+  ASSERT_TRUE(continuation_2);
+  ASSERT_TRUE(continuation_3);
+}
+
+TEST(PipelineTest, MailboxConsumerGetsNewestResource) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::kMailbox);
+
+  const int test_val_1 = 1, test_val_2 = 2, test_val_3 = 3;
+  pipeline->Produce().Complete(std::make_unique<int>(test_val_1));
+  pipeline->Produce().Complete(std::make_unique<int>(test_val_2));
+  pipeline->Produce().Complete(std::make_unique<int>(test_val_3));
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_3](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_3); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  // The replaced resources are gone.
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::NoneAvailable);
+
+  // And the mailbox can be filled again.
+  pipeline->Produce().Complete(std::make_unique<int>(test_val_1));
+  PipelineConsumeResult consume_result_3 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_3, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, MailboxProduceToFrontDoesNotReplaceNewerResource) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::kMailbox);
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  pipeline->Produce().Complete(std::make_unique<int>(test_val_1));
+  pipeline->ProduceToFront().Complete(std::make_unique<int>(test_val_2));
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::NoneAvailable);
+}
+
+TEST(PipelineTest, MailboxProduceToFrontFillsEmptyMailbox) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::kMailbox);
+
+  const int test_val_1 = 1;
+  pipeline->ProduceToFront().Complete(std::make_unique<int>(test_val_1));
+
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, MailboxDroppedContinuationKeepsWaitingResource) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::kMailbox);
+
+  const int test_val_1 = 1;
+  pipeline->Produce().Complete(std::make_unique<int>(test_val_1));
+  {
+    // Dropped without being completed.
+    Continuation continuation = pipeline->Produce();
+    ASSERT_TRUE(continuation);
+  }
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  // Nor does a dropped continuation fill an empty mailbox.
+  pipeline->Produce();
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::NoneAvailable);
+}
+
+TEST(PipelineTest, ConsumerIsToldQueueingDelay) {
+  fml::RefPtr<IntPipeline> pipeline = fml::MakeRefCounted<IntPipeline>(2);
+
+  pipeline->Produce().Complete(std::make_unique<int>(1));
+  const auto wait = fml::TimeDelta::FromMilliseconds(5);
+  const auto start = fml::TimePoint::Now();
+  while (fml::TimePoint::Now() - start < wait) {
+  }
+
+  fml::TimeDelta queueing_delay;
+  PipelineConsumeResult consume_result = pipeline->Consume(
+      IntPipeline::TimedConsumer([&queueing_delay](std::unique_ptr<int> v,
+                                                   fml::TimeDelta delay) {
+        queueing_delay = delay;
+      }));
+  ASSERT_EQ(consume_result, PipelineConsumeResult::Done);
+  ASSERT_GE(queueing_delay, wait);
+}
+
 }  // namespace testing
 }  // namespace flutter
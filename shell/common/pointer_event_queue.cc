@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pointer_event_queue.h"
+
+#include <string.h>
+
+namespace flutter {
+
+static bool CanCoalesce(const PointerData& queued, const PointerData& next) {
+  if (queued.change != PointerData::Change::kMove &&
+      queued.change != PointerData::Change::kHover) {
+    return false;
+  }
+  return queued.change == next.change &&
+         queued.signal_kind == PointerData::SignalKind::kNone &&
+         next.signal_kind == PointerData::SignalKind::kNone &&
+         queued.kind == next.kind && queued.buttons == next.buttons;
+}
+
+static PointerData Resample(const PointerData& previous,
+                            const PointerData& next,
+                            int64_t sample_time) {
+  const double t = static_cast<double>(sample_time - previous.time_stamp) /
+                   (next.time_stamp - previous.time_stamp);
+  PointerData resampled = next;
+  resampled.time_stamp = sample_time;
+  resampled.physical_x =
+      previous.physical_x + (next.physical_x - previous.physical_x) * t;
+  resampled.physical_y =
+      previous.physical_y + (next.physical_y - previous.physical_y) * t;
+  return resampled;
+}
+
+PointerEventQueue::PointerEventQueue() = default;
+
+PointerEventQueue::~PointerEventQueue() = default;
+
+bool PointerEventQueue::Push(const PointerDataPacket& packet,
+                             uint64_t trace_flow_id) {
+  const auto& bytes = packet.data();
+  const size_t count = bytes.size() / sizeof(PointerData);
+
+  std::scoped_lock lock(mutex_);
+  trace_flow_ids_.push_back(trace_flow_id);
+
+  for (size_t i = 0; i < count; i++) {
+    PointerData data;
+    memcpy(&data, &bytes[i * sizeof(PointerData)], sizeof(PointerData));
+
+    auto tail = device_tails_.find(data.device);
+    if (tail != device_tails_.end()) {
+      Entry& entry = entries_[tail->second];
+      if (CanCoalesce(entry.data, data)) {
+        entry.previous = entry.data;
+        entry.data = data;
+        coalesced_event_count_++;
+        continue;
+      }
+    }
+
+    device_tails_[data.device] = entries_.size();
+    entries_.push_back({data, std::nullopt});
+  }
+
+  if (pop_scheduled_) {
+    return false;
+  }
+  pop_scheduled_ = true;
+  return true;
+}
+
+PointerEventQueue::Batch PointerEventQueue::Pop(
+    std::optional<int64_t> sample_time) {
+  Batch batch;
+  std::vector<PointerData> events;
+  {
+    std::scoped_lock lock(mutex_);
+    batch.trace_flow_ids = std::move(trace_flow_ids_);
+    trace_flow_ids_.clear();
+    pop_scheduled_ = false;
+
+    std::vector<Entry> retained;
+    for (const auto& entry : entries_) {
+      if (sample_time && entry.previous &&
+          entry.previous->time_stamp < *sample_time &&
+          *sample_time < entry.data.time_stamp) {
+        // The newest sample is ahead of the frame. Deliver the position at
+        // the frame time now and the newest sample with a later frame.
+        auto resampled = Resample(*entry.previous, entry.data, *sample_time);
+        events.push_back(resampled);
+        retained.push_back({entry.data, resampled});
+      } else {
+        events.push_back(entry.data);
+      }
+    }
+
+    entries_ = std::move(retained);
+    device_tails_.clear();
+    for (size_t i = 0; i < entries_.size(); i++) {
+      device_tails_[entries_[i].data.device] = i;
+    }
+  }
+
+  if (!events.empty()) {
+    batch.packet = std::make_unique<PointerDataPacket>(events.size());
+    for (size_t i = 0; i < events.size(); i++) {
+      batch.packet->SetPointerData(i, events[i]);
+    }
+  }
+  return batch;
+}
+
+bool PointerEventQueue::IsEmpty() const {
+  std::scoped_lock lock(mutex_);
+  return entries_.empty();
+}
+
+size_t PointerEventQueue::GetCoalescedEventCount() const {
+  std::scoped_lock lock(mutex_);
+  return coalesced_event_count_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_POINTER_EVENT_QUEUE_H_
+#define FLUTTER_SHELL_COMMON_POINTER_EVENT_QUEUE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/thread_annotations.h"
+#include "flutter/lib/ui/window/pointer_data_packet.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Collects the pointer events sent by the platform view so that they can be
+/// delivered to the framework in one packet per frame instead of one Dart call
+/// per platform event.
+///
+/// Consecutive move (or hover) events of the same device are coalesced into a
+/// single event. When the queue is drained for a frame, coalesced events are
+/// resampled to the frame time by interpolating between the last two samples.
+/// All other events (down, up, add, remove, cancel and pointer signals) are
+/// delivered unchanged and in order.
+///
+/// Events are pushed on the platform task runner and popped on the UI task
+/// runner.
+///
+class PointerEventQueue {
+ public:
+  struct Batch {
+    std::unique_ptr<PointerDataPacket> packet;
+    // The trace flows of the packets that were merged into |packet|.
+    std::vector<uint64_t> trace_flow_ids;
+  };
+
+  PointerEventQueue();
+
+  ~PointerEventQueue();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the events of a packet to the queue.
+  ///
+  /// @param[in]  packet         The packet sent by the platform view.
+  /// @param[in]  trace_flow_id  The trace flow associated with the packet.
+  ///
+  /// @return     Whether the caller must arrange for the queue to be popped.
+  ///             This is the case for the first packet pushed after the
+  ///             queue was last popped.
+  ///
+  bool Push(const PointerDataPacket& packet, uint64_t trace_flow_id);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Removes the queued events and merges them into a single
+  ///             packet.
+  ///
+  /// @param[in]  sample_time  The time to resample coalesced events to, in
+  ///                          the time base of `PointerData::time_stamp`.
+  ///                          Samples newer than this time stay in the queue
+  ///                          so that they are delivered later. If not given,
+  ///                          the latest samples are delivered.
+  ///
+  /// @return     The merged packet, which is `nullptr` if there were no
+  ///             events, and the trace flows of the pushed packets.
+  ///
+  Batch Pop(std::optional<int64_t> sample_time);
+
+  bool IsEmpty() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The number of events that were merged into a later event of
+  ///             the same device instead of being delivered separately.
+  ///
+  size_t GetCoalescedEventCount() const;
+
+ private:
+  struct Entry {
+    PointerData data;
+    // The sample |data| replaced, used to resample the event.
+    std::optional<PointerData> previous;
+  };
+
+  mutable std::mutex mutex_;
+  std::vector<Entry> entries_ FML_GUARDED_BY(mutex_);
+  // The index in |entries_| of the last event of each device.
+  std::map<int64_t, size_t> device_tails_ FML_GUARDED_BY(mutex_);
+  std::vector<uint64_t> trace_flow_ids_ FML_GUARDED_BY(mutex_);
+  bool pop_scheduled_ FML_GUARDED_BY(mutex_) = false;
+  size_t coalesced_event_count_ FML_GUARDED_BY(mutex_) = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PointerEventQueue);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_POINTER_EVENT_QUEUE_H_
@@ -0,0 +1,144 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pointer_event_queue.h"
+
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static PointerData MakePointerData(PointerData::Change change,
+                                   int64_t device,
+                                   int64_t time_stamp,
+                                   double x,
+                                   double y) {
+  PointerData data;
+  data.Clear();
+  data.change = change;
+  data.kind = PointerData::DeviceKind::kTouch;
+  data.device = device;
+  data.time_stamp = time_stamp;
+  data.physical_x = x;
+  data.physical_y = y;
+  return data;
+}
+
+static std::unique_ptr<PointerDataPacket> MakePacket(
+    const std::vector<PointerData>& events) {
+  auto packet = std::make_unique<PointerDataPacket>(events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    packet->SetPointerData(i, events[i]);
+  }
+  return packet;
+}
+
+static std::vector<PointerData> Unpack(const PointerDataPacket& packet) {
+  std::vector<PointerData> events(packet.data().size() / sizeof(PointerData));
+  memcpy(events.data(), packet.data().data(), packet.data().size());
+  return events;
+}
+
+using Change = PointerData::Change;
+
+TEST(PointerEventQueueTest, OnlyTheFirstPushSchedulesAPop) {
+  PointerEventQueue queue;
+  ASSERT_TRUE(queue.IsEmpty());
+  auto down = MakePointerData(Change::kDown, 0, 0, 0, 0);
+  auto up = MakePointerData(Change::kUp, 0, 1, 0, 0);
+  ASSERT_TRUE(queue.Push(*MakePacket({down}), 1));
+  ASSERT_FALSE(queue.Push(*MakePacket({up}), 2));
+  ASSERT_FALSE(queue.IsEmpty());
+
+  auto batch = queue.Pop(std::nullopt);
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(batch.trace_flow_ids, (std::vector<uint64_t>{1, 2}));
+  ASSERT_EQ(Unpack(*batch.packet).size(), 2u);
+
+  ASSERT_TRUE(queue.Push(*MakePacket({down}), 3));
+}
+
+TEST(PointerEventQueueTest, PopOfEmptyQueueHasNoPacket) {
+  PointerEventQueue queue;
+  auto batch = queue.Pop(std::nullopt);
+  ASSERT_EQ(batch.packet, nullptr);
+  ASSERT_TRUE(batch.trace_flow_ids.empty());
+}
+
+TEST(PointerEventQueueTest, CoalescesConsecutiveMovesPerDevice) {
+  PointerEventQueue queue;
+  queue.Push(*MakePacket({MakePointerData(Change::kDown, 0, 0, 0, 0),
+                          MakePointerData(Change::kMove, 0, 1, 1, 1),
+                          MakePointerData(Change::kMove, 1, 1, 5, 5),
+                          MakePointerData(Change::kMove, 0, 2, 2, 2)}),
+             1);
+  queue.Push(*MakePacket({MakePointerData(Change::kMove, 0, 3, 3, 3),
+                          MakePointerData(Change::kUp, 0, 4, 3, 3),
+                          MakePointerData(Change::kMove, 1, 4, 6, 6)}),
+             2);
+  ASSERT_EQ(queue.GetCoalescedEventCount(), 3u);
+
+  auto events = Unpack(*queue.Pop(std::nullopt).packet);
+  ASSERT_EQ(events.size(), 4u);
+  ASSERT_EQ(events[0].change, Change::kDown);
+  ASSERT_EQ(events[1].change, Change::kMove);
+  ASSERT_EQ(events[1].device, 0);
+  ASSERT_EQ(events[1].physical_x, 3);
+  // The up event of device 0 doesn't end the run of moves of device 1.
+  ASSERT_EQ(events[2].change, Change::kMove);
+  ASSERT_EQ(events[2].device, 1);
+  ASSERT_EQ(events[2].physical_x, 6);
+  ASSERT_EQ(events[3].change, Change::kUp);
+}
+
+TEST(PointerEventQueueTest, DoesNotCoalesceMovesWithDifferentButtons) {
+  PointerEventQueue queue;
+  auto first = MakePointerData(Change::kMove, 0, 0, 0, 0);
+  auto second = MakePointerData(Change::kMove, 0, 1, 1, 1);
+  second.buttons = kPointerButtonTouchContact;
+  queue.Push(*MakePacket({first, second}), 1);
+  ASSERT_EQ(queue.GetCoalescedEventCount(), 0u);
+  ASSERT_EQ(Unpack(*queue.Pop(std::nullopt).packet).size(), 2u);
+}
+
+TEST(PointerEventQueueTest, ResamplesCoalescedMovesToTheFrameTime) {
+  PointerEventQueue queue;
+  queue.Push(*MakePacket({MakePointerData(Change::kMove, 0, 100, 10, 0),
+                          MakePointerData(Change::kMove, 0, 200, 20, 40)}),
+             1);
+
+  auto events = Unpack(*queue.Pop(150).packet);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 150);
+  ASSERT_DOUBLE_EQ(events[0].physical_x, 15);
+  ASSERT_DOUBLE_EQ(events[0].physical_y, 20);
+
+  // The newest sample is delivered with the next frame.
+  ASSERT_FALSE(queue.IsEmpty());
+  events = Unpack(*queue.Pop(250).packet);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 200);
+  ASSERT_EQ(events[0].physical_x, 20);
+  ASSERT_TRUE(queue.IsEmpty());
+}
+
+TEST(PointerEventQueueTest, DeliversLatestSampleWithoutSampleTime) {
+  PointerEventQueue queue;
+  queue.Push(*MakePacket({MakePointerData(Change::kMove, 0, 100, 10, 0),
+                          MakePointerData(Change::kMove, 0, 200, 20, 40)}),
+             1);
+
+  auto events = Unpack(*queue.Pop(std::nullopt).packet);
+  ASSERT_EQ(events.size(), 1u);
+  ASSERT_EQ(events[0].time_stamp, 200);
+  ASSERT_TRUE(queue.IsEmpty());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -56,6 +56,17 @@ fml::WeakPtr<Rasterizer> Rasterizer::GetWeakPtr() const {
 void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
   surface_ = std::move(surface);
   compositor_context_->OnGrContextCreated();
+
+  // Replay in a separate task so that the platform thread, which waits for
+  // the surface to be set up, isn't held up by the warm-up.
+  if (!shader_warm_up_pictures_.empty()) {
+    task_runners_.GetGPUTaskRunner()->PostTask(
+        [weak_this = weak_factory_.GetWeakPtr()]() {
+          if (weak_this) {
+            weak_this->ReplayShaderWarmUpPictures();
+          }
+        });
+  }
 }
 
 void Rasterizer::Teardown() {
@@ -95,8 +106,9 @@ void Rasterizer::DrawLastLayerTree() {
 void Rasterizer::Draw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) {
   TRACE_EVENT0("flutter", "GPURasterizer::Draw");
 
-  Pipeline<flutter::LayerTree>::Consumer consumer =
-      std::bind(&Rasterizer::DoDraw, this, std::placeholders::_1);
+  Pipeline<flutter::LayerTree>::TimedConsumer consumer =
+      std::bind(&Rasterizer::DoDraw, this, std::placeholders::_1,
+                std::placeholders::_2);
 
   // Consume as many pipeline items as possible. But yield the event loop
   // between successive tries.
@@ -115,7 +127,8 @@ void Rasterizer::Draw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) {
   }
 }
 
-void Rasterizer::DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree) {
+void Rasterizer::DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree,
+                        fml::TimeDelta queueing_delay) {
   FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
 
   if (!layer_tree || !surface_) {
@@ -126,14 +139,19 @@ void Rasterizer::DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree) {
   timing.Set(FrameTiming::kBuildStart, layer_tree->build_start());
   timing.Set(FrameTiming::kBuildFinish, layer_tree->build_finish());
   timing.Set(FrameTiming::kRasterStart, fml::TimePoint::Now());
+  timing.SetQueueingDelay(queueing_delay);
+  timing.SetFrameTargetTime(layer_tree->target_time());
 
   PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
   persistent_cache->ResetStoredNewShaders();
 
   if (DrawToSurface(*layer_tree) == RasterStatus::kSuccess) {
+    has_rasterized_frame_ = true;
     last_layer_tree_ = std::move(layer_tree);
   }
 
+  timing.SetCompiledNewShaders(persistent_cache->StoredNewShaders());
+
   if (persistent_cache->IsDumpingSkp() &&
       persistent_cache->StoredNewShaders()) {
     auto screenshot =
@@ -175,10 +193,17 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
       surface_->GetRootTransformation(), true);
 
   if (compositor_frame) {
+    // Platform views are composited by the embedder and cannot be tracked.
+    compositor_frame->set_partial_repaint_enabled(
+        surface_->SupportsPartialRepaint() &&
+        external_view_embedder == nullptr);
     RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
     if (raster_status == RasterStatus::kFailed) {
       return raster_status;
     }
+    if (compositor_frame->damage()) {
+      frame->set_damage(*compositor_frame->damage());
+    }
     frame->Submit();
     if (external_view_embedder != nullptr) {
       external_view_embedder->SubmitFrame(surface_->GetContext());
@@ -345,6 +370,47 @@ void Rasterizer::SetNextFrameCallback(fml::closure callback) {
   next_frame_callback_ = callback;
 }
 
+void Rasterizer::WarmUpShaders(std::vector<sk_sp<SkPicture>> pictures,
+                               fml::TimeDelta budget) {
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+  shader_warm_up_pictures_ = std::move(pictures);
+  shader_warm_up_budget_ = budget;
+  ReplayShaderWarmUpPictures();
+}
+
+void Rasterizer::ReplayShaderWarmUpPictures() {
+  if (shader_warm_up_pictures_.empty()) {
+    return;
+  }
+
+  if (has_rasterized_frame_) {
+    // Replaying now would block the GPU thread while the application is
+    // already rendering, which is the jank the warm-up is meant to prevent.
+    FML_LOG(INFO) << "Shader warm-up skipped as the pictures became available "
+                     "after the first frame was rasterized.";
+    shader_warm_up_pictures_.clear();
+    return;
+  }
+
+  if (!surface_) {
+    return;
+  }
+
+  if (!surface_->MakeRenderContextCurrent()) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "Rasterizer::ReplayShaderWarmUpPictures");
+  auto result = ShaderWarmUp::Replay(
+      surface_->GetContext(), shader_warm_up_pictures_, shader_warm_up_budget_);
+  shader_warm_up_pictures_.clear();
+
+  FML_LOG(INFO) << "Shader warm-up replayed " << result.pictures_replayed
+                << " pictures (" << result.pictures_skipped
+                << " skipped) and warmed " << result.shaders_warmed
+                << " shaders in " << result.duration.ToMilliseconds() << "ms.";
+}
+
 void Rasterizer::FireNextFrameCallbackIfPresent() {
   if (!next_frame_callback_) {
     return;
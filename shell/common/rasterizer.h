@@ -6,6 +6,7 @@
 #define SHELL_COMMON_RASTERIZER_H_
 
 #include <memory>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
@@ -15,6 +16,7 @@
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/shader_warm_up.h"
 #include "flutter/shell/common/surface.h"
 
 namespace flutter {
@@ -377,6 +379,24 @@ class Rasterizer final {
   ///
   void SetResourceCacheMaxBytes(int max_bytes);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replays the given pictures against the context of the
+  ///             on-screen surface so that the shaders they use are compiled
+  ///             before they are needed by a frame. If there is no surface
+  ///             yet, the pictures are replayed as soon as one is provided
+  ///             via `Rasterizer::Setup`. The pictures are released once they
+  ///             have been replayed. If a frame has already been rasterized
+  ///             by then, the pictures are released without being replayed,
+  ///             as replaying them would stall the frames that follow.
+  ///
+  /// @see        `ShaderWarmUp`
+  ///
+  /// @param[in]  pictures  The pictures to replay.
+  /// @param[in]  budget    The maximum time spent replaying pictures.
+  ///
+  void WarmUpShaders(std::vector<sk_sp<SkPicture>> pictures,
+                     fml::TimeDelta budget);
+
  private:
   Delegate& delegate_;
   TaskRunners task_runners_;
@@ -384,14 +404,20 @@ class Rasterizer final {
   std::unique_ptr<flutter::CompositorContext> compositor_context_;
   std::unique_ptr<flutter::LayerTree> last_layer_tree_;
   fml::closure next_frame_callback_;
+  std::vector<sk_sp<SkPicture>> shader_warm_up_pictures_;
+  fml::TimeDelta shader_warm_up_budget_;
+  bool has_rasterized_frame_ = false;
   fml::WeakPtrFactory<Rasterizer> weak_factory_;
 
-  void DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree);
+  void DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree,
+              fml::TimeDelta queueing_delay);
 
   RasterStatus DrawToSurface(flutter::LayerTree& layer_tree);
 
   void FireNextFrameCallbackIfPresent();
 
+  void ReplayShaderWarmUpPictures();
+
   FML_DISALLOW_COPY_AND_ASSIGN(Rasterizer);
 };
 
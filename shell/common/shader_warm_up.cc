@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shader_warm_up.h"
+
+#include <algorithm>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/shell/common/persistent_cache.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+static constexpr char kPictureExtension[] = ".skp";
+
+static bool HasPictureExtension(const std::string& filename) {
+  const size_t extension_length = sizeof(kPictureExtension) - 1;
+  return filename.size() > extension_length &&
+         filename.compare(filename.size() - extension_length, extension_length,
+                          kPictureExtension) == 0;
+}
+
+std::vector<sk_sp<SkPicture>> ShaderWarmUp::LoadPictures(
+    const std::string& directory) {
+  TRACE_EVENT0("flutter", "ShaderWarmUp::LoadPictures");
+  std::vector<sk_sp<SkPicture>> pictures;
+
+  auto directory_fd = fml::OpenDirectory(directory.c_str(), false,
+                                         fml::FilePermission::kRead);
+  if (!directory_fd.is_valid()) {
+    FML_LOG(ERROR) << "Could not open the shader warm-up directory "
+                   << directory;
+    return pictures;
+  }
+
+  std::vector<std::string> filenames;
+  fml::VisitFiles(directory_fd,
+                  [&filenames](const fml::UniqueFD& directory,
+                               const std::string& filename) {
+                    if (HasPictureExtension(filename)) {
+                      filenames.push_back(filename);
+                    }
+                    return true;
+                  });
+  std::sort(filenames.begin(), filenames.end());
+
+  for (const auto& filename : filenames) {
+    auto mapping = fml::FileMapping::CreateReadOnly(directory_fd, filename);
+    if (!mapping || mapping->GetSize() == 0) {
+      continue;
+    }
+    auto picture =
+        SkPicture::MakeFromData(mapping->GetMapping(), mapping->GetSize());
+    if (!picture) {
+      FML_LOG(ERROR) << "Could not deserialize the shader warm-up picture "
+                     << filename;
+      continue;
+    }
+    pictures.push_back(std::move(picture));
+  }
+
+  return pictures;
+}
+
+ShaderWarmUp::Result ShaderWarmUp::Replay(
+    GrContext* context,
+    const std::vector<sk_sp<SkPicture>>& pictures,
+    fml::TimeDelta budget) {
+  TRACE_EVENT0("flutter", "ShaderWarmUp::Replay");
+  Result result;
+  result.pictures_skipped = pictures.size();
+
+  if (context == nullptr || pictures.empty()) {
+    return result;
+  }
+
+  // A single render target that fits all pictures is reused for every one of
+  // them. The shaders Skia picks don't depend on the size of the target.
+  SkIRect bounds = SkIRect::MakeEmpty();
+  for (const auto& picture : pictures) {
+    bounds.join(picture->cullRect().roundOut());
+  }
+  const int max_size = context->maxRenderTargetSize();
+  const int width = std::min(std::max(bounds.right(), 1), max_size);
+  const int height = std::min(std::max(bounds.bottom(), 1), max_size);
+
+  auto surface = SkSurface::MakeRenderTarget(
+      context, SkBudgeted::kNo, SkImageInfo::MakeN32Premul(width, height));
+  if (!surface) {
+    FML_LOG(ERROR) << "Could not create the shader warm-up render target.";
+    return result;
+  }
+
+  // Skia loads the programs of this context on this thread, so loads made for
+  // other contexts in the meantime are not counted.
+  const size_t initial_load_count =
+      PersistentCache::GetLoadCountOnCurrentThread();
+  const auto start = fml::TimePoint::Now();
+
+  for (const auto& picture : pictures) {
+    if (fml::TimePoint::Now() - start >= budget) {
+      break;
+    }
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->drawPicture(picture);
+    // Shaders are compiled when the recorded operations are executed.
+    surface->flush();
+    result.pictures_replayed++;
+    result.pictures_skipped--;
+  }
+
+  result.duration = fml::TimePoint::Now() - start;
+  result.shaders_warmed =
+      PersistentCache::GetLoadCountOnCurrentThread() - initial_load_count;
+  return result;
+}
+
+}  // namespace flutter
@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHADER_WARM_UP_H_
+#define FLUTTER_SHELL_COMMON_SHADER_WARM_UP_H_
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Replays pictures captured ahead of time (for example the SKPs written by
+/// `--dump-skp-on-shader-compilation`) into an offscreen render target so that
+/// Skia compiles the shaders they need before the first frame is drawn. This
+/// moves on-demand shader compilation out of the first frames an application
+/// renders.
+///
+/// Pictures are read and deserialized on the IO task runner. They are replayed
+/// on the GPU task runner against the context used for on-screen rendering.
+///
+class ShaderWarmUp {
+ public:
+  struct Result {
+    size_t pictures_replayed = 0;
+    // Pictures that were not replayed because the budget ran out.
+    size_t pictures_skipped = 0;
+    // Shader programs Skia requested from the persistent cache while the
+    // pictures were replayed. Each one is a shader that would otherwise have
+    // been compiled or linked during a frame.
+    size_t shaders_warmed = 0;
+    fml::TimeDelta duration;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reads and deserializes every `.skp` file in the directory.
+  ///             Files that can't be read or are not valid pictures are
+  ///             skipped. Pictures are returned in file name order so that
+  ///             dumps, which are named after their capture time, replay in
+  ///             the order they were recorded.
+  ///
+  /// @param[in]  directory  The path of the directory to read.
+  ///
+  /// @return     The pictures in the directory.
+  ///
+  static std::vector<sk_sp<SkPicture>> LoadPictures(
+      const std::string& directory);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Draws the pictures into an offscreen render target of the
+  ///             given context and flushes after each one. The context must
+  ///             be current on the calling thread. Pictures are replayed until
+  ///             the budget is exhausted. The picture that exceeds the budget
+  ///             is still completed.
+  ///
+  /// @param[in]  context   The context whose shaders to warm up. No work is
+  ///                       done for software rendering (`nullptr`).
+  /// @param[in]  pictures  The pictures to replay.
+  /// @param[in]  budget    The time after which no more pictures are replayed.
+  ///
+  /// @return     What was replayed.
+  ///
+  static Result Replay(GrContext* context,
+                       const std::vector<sk_sp<SkPicture>>& pictures,
+                       fml::TimeDelta budget);
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(ShaderWarmUp);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SHADER_WARM_UP_H_
@@ -0,0 +1,72 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shader_warm_up.h"
+
+#include <string>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace flutter {
+namespace testing {
+
+static sk_sp<SkPicture> MakePicture(SkScalar width) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(width, 10));
+  canvas->drawRect(SkRect::MakeWH(width, 10), SkPaint());
+  return recorder.finishRecordingAsPicture();
+}
+
+static void WriteFile(const fml::UniqueFD& directory,
+                      const char* filename,
+                      sk_sp<SkData> data) {
+  fml::NonOwnedMapping mapping(data->bytes(), data->size());
+  ASSERT_TRUE(fml::WriteAtomically(directory, filename, mapping));
+}
+
+TEST(ShaderWarmUpTest, LoadsPicturesInFileNameOrder) {
+  fml::ScopedTemporaryDirectory dir;
+  WriteFile(dir.fd(), "b.skp", MakePicture(20)->serialize());
+  WriteFile(dir.fd(), "a.skp", MakePicture(10)->serialize());
+
+  auto pictures = ShaderWarmUp::LoadPictures(dir.path());
+  ASSERT_EQ(pictures.size(), 2u);
+  ASSERT_EQ(pictures[0]->cullRect().width(), 10);
+  ASSERT_EQ(pictures[1]->cullRect().width(), 20);
+
+  fml::UnlinkFile(dir.fd(), "a.skp");
+  fml::UnlinkFile(dir.fd(), "b.skp");
+}
+
+TEST(ShaderWarmUpTest, SkipsInvalidPicturesAndOtherFiles) {
+  fml::ScopedTemporaryDirectory dir;
+  WriteFile(dir.fd(), "picture.skp", MakePicture(10)->serialize());
+  WriteFile(dir.fd(), "picture.png", MakePicture(10)->serialize());
+  WriteFile(dir.fd(), "garbage.skp", SkData::MakeWithCString("garbage"));
+
+  auto pictures = ShaderWarmUp::LoadPictures(dir.path());
+  ASSERT_EQ(pictures.size(), 1u);
+
+  fml::UnlinkFile(dir.fd(), "picture.skp");
+  fml::UnlinkFile(dir.fd(), "picture.png");
+  fml::UnlinkFile(dir.fd(), "garbage.skp");
+}
+
+TEST(ShaderWarmUpTest, MissingDirectoryHasNoPictures) {
+  ASSERT_TRUE(ShaderWarmUp::LoadPictures("/does/not/exist").empty());
+}
+
+TEST(ShaderWarmUpTest, SoftwareRenderingSkipsReplay) {
+  auto result = ShaderWarmUp::Replay(nullptr, {MakePicture(10)},
+                                     fml::TimeDelta::FromSeconds(1));
+  ASSERT_EQ(result.pictures_replayed, 0u);
+  ASSERT_EQ(result.pictures_skipped, 1u);
+  ASSERT_EQ(result.shaders_warmed, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
@@ -24,9 +25,11 @@
 #include "flutter/runtime/start_up.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/persistent_cache.h"
+#include "flutter/shell/common/shader_warm_up.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
+#include "flutter/shell/common/vsync_waiter_fallback.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/tonic/common/log.h"
@@ -58,8 +61,13 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   }
 
   // Ask the platform view for the vsync waiter. This will be used by the engine
-  // to create the animator.
-  auto vsync_waiter = platform_view->CreateVSyncWaiter();
+  // to create the animator. Unthrottled frames do not depend on the display.
+  std::unique_ptr<VsyncWaiter> vsync_waiter;
+  if (settings.disable_frame_throttling) {
+    vsync_waiter = std::make_unique<VsyncWaiterFallback>(task_runners, true);
+  } else {
+    vsync_waiter = platform_view->CreateVSyncWaiter();
+  }
   if (!vsync_waiter) {
     return nullptr;
   }
@@ -96,6 +104,31 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         if (auto new_rasterizer = on_create_rasterizer(*shell)) {
+          if (shell->GetSettings().enable_concurrent_raster_cache) {
+            new_rasterizer->compositor_context()
+                ->raster_cache()
+                .SetConcurrentTaskRunner(
+                    shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+          }
+          if (shell->GetSettings().enable_adaptive_raster_cache) {
+            new_rasterizer->compositor_context()->raster_cache().SetAdaptive(
+                true);
+          }
+          if (shell->GetSettings().raster_cache_rasterization_budget_ms > 0) {
+            new_rasterizer->compositor_context()
+                ->raster_cache()
+                .SetPictureRasterizationBudgetPerFrame(
+                    fml::TimeDelta::FromMilliseconds(
+                        shell->GetSettings()
+                            .raster_cache_rasterization_budget_ms));
+          }
+          if (shell->GetSettings().enable_concurrent_software_paint) {
+            // More bands than workers balance the load between bands that
+            // are cheap and expensive to paint.
+            new_rasterizer->compositor_context()->SetConcurrentPaintTaskRunner(
+                shell->GetDartVM()->GetConcurrentWorkerTaskRunner(),
+                2 * std::thread::hardware_concurrency());
+          }
           rasterizer = std::move(new_rasterizer);
         }
         gpu_latch.Signal();
@@ -121,8 +154,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            shell->GetSettings().enable_frame_pipeline_mailbox
+                ? PipelineMode::kMailbox
+                : PipelineMode::kQueue);
 
         engine = std::make_unique<Engine>(*shell,                       //
                                           *shell->GetDartVM(),          //
@@ -307,6 +343,11 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
           task_runners_.GetUITaskRunner(),
           std::bind(&Shell::OnServiceProtocolGetDisplayRefreshRate, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameStatisticsExtensionName] = {
+          task_runners_.GetUITaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameStatistics, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -398,6 +439,7 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_engine_ = engine_->GetWeakPtr();
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
+  pointer_event_queue_ = engine_->GetPointerEventQueue();
 
   is_setup_ = true;
 
@@ -409,6 +451,28 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   PersistentCache::GetCacheForProcess()->SetIsDumpingSkp(
       settings_.dump_skp_on_shader_compilation);
 
+  if (!settings_.shader_warm_up_skp_path.empty()) {
+    // The pictures are read on the IO thread and handed to the rasterizer,
+    // which replays them as soon as it has an on-screen surface.
+    task_runners_.GetIOTaskRunner()->PostTask(
+        [path = settings_.shader_warm_up_skp_path,
+         budget = fml::TimeDelta::FromMilliseconds(
+             settings_.shader_warm_up_budget_ms),
+         rasterizer = weak_rasterizer_,
+         gpu_task_runner = task_runners_.GetGPUTaskRunner()]() {
+          auto pictures = ShaderWarmUp::LoadPictures(path);
+          if (pictures.empty()) {
+            return;
+          }
+          gpu_task_runner->PostTask(fml::MakeCopyable(
+              [rasterizer, budget, pictures = std::move(pictures)]() mutable {
+                if (rasterizer) {
+                  rasterizer->WarmUpShaders(std::move(pictures), budget);
+                }
+              }));
+        });
+  }
+
   return true;
 }
 
@@ -635,6 +699,23 @@ void Shell::OnPlatformViewDispatchPointerDataPacket(
   TRACE_FLOW_BEGIN("flutter", "PointerEvent", next_pointer_flow_id_);
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+  if (pointer_event_queue_) {
+    // Packets that arrive before the engine got to the queue are merged into
+    // the pending ones instead of posting a task each.
+    if (pointer_event_queue_->Push(*packet, next_pointer_flow_id_)) {
+      task_runners_.GetUITaskRunner()->PostTask([engine = weak_engine_]() {
+        if (engine) {
+          engine->DispatchPendingPointerEvents();
+        }
+      });
+    }
+    FML_TRACE_COUNTER("flutter", "PointerEventQueue",
+                      reinterpret_cast<int64_t>(pointer_event_queue_.get()),
+                      "Coalesced",
+                      pointer_event_queue_->GetCoalescedEventCount());
+    next_pointer_flow_id_++;
+    return;
+  }
   task_runners_.GetUITaskRunner()->PostTask(fml::MakeCopyable(
       [engine = engine_->GetWeakPtr(), packet = std::move(packet),
        flow_id = next_pointer_flow_id_] {
@@ -851,7 +932,8 @@ void Shell::HandleEngineSkiaMessage(fml::RefPtr<PlatformMessage> message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return;
   auto root = document.GetObject();
@@ -925,6 +1007,8 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
 
+  frame_statistics_.Record(timing);
+
   // The C++ callback defined in settings.h and set by Flutter runner. This is
   // independent of the timings report to the Dart side.
   if (settings_.frame_rasterized_callback) {
@@ -1171,6 +1255,51 @@ bool Shell::OnServiceProtocolGetDisplayRefreshRate(
   return true;
 }
 
+static void AddFramePercentiles(rapidjson::Document& response,
+                                const char* name,
+                                const FrameStatistics::Percentiles& value) {
+  auto& allocator = response.GetAllocator();
+  rapidjson::Value percentiles(rapidjson::kObjectType);
+  percentiles.AddMember("p50", value.p50.ToMicroseconds(), allocator);
+  percentiles.AddMember("p90", value.p90.ToMicroseconds(), allocator);
+  percentiles.AddMember("p99", value.p99.ToMicroseconds(), allocator);
+  percentiles.AddMember("p99.9", value.p999.ToMicroseconds(), allocator);
+  percentiles.AddMember("max", value.max.ToMicroseconds(), allocator);
+  response.AddMember(rapidjson::StringRef(name), percentiles, allocator);
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetFrameStatistics(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  const auto summary = GetFrameStatistics();
+
+  // Optionally start a new measurement window, e.g. for per-scenario numbers.
+  auto reset = params.find("reset");
+  if (reset != params.end() && reset->second == "true") {
+    ResetFrameStatistics();
+  }
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "FrameStatistics", allocator);
+  response.AddMember("frameCount",
+                     static_cast<uint64_t>(summary.frame_count), allocator);
+  response.AddMember("droppedFrameCount",
+                     static_cast<uint64_t>(summary.dropped_frame_count),
+                     allocator);
+  response.AddMember(
+      "shaderCompilationFrameCount",
+      static_cast<uint64_t>(summary.shader_compilation_frame_count),
+      allocator);
+  // All durations are in microseconds.
+  AddFramePercentiles(response, "buildTime", summary.build_time);
+  AddFramePercentiles(response, "rasterTime", summary.raster_time);
+  AddFramePercentiles(response, "totalTime", summary.total_time);
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1232,6 +1361,14 @@ Rasterizer::Screenshot Shell::Screenshot(
   return screenshot;
 }
 
+FrameStatistics::Summary Shell::GetFrameStatistics() const {
+  return frame_statistics_.GetSummary();
+}
+
+void Shell::ResetFrameStatistics() {
+  frame_statistics_.Reset();
+}
+
 fml::Status Shell::WaitForFirstFrame(fml::TimeDelta timeout) {
   FML_DCHECK(is_setup_);
   if (task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread() ||
@@ -28,6 +28,7 @@
 #include "flutter/runtime/service_protocol.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_statistics.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -253,6 +254,22 @@ class Shell final : public PlatformView::Delegate,
   ///
   fml::Status WaitForFirstFrame(fml::TimeDelta timeout);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Summarizes the timings of all frames rasterized since the
+  ///             shell was created or since the last |ResetFrameStatistics|.
+  ///             This is collected independently of the performance overlay
+  ///             and of the Dart timings callback. Can be called on any
+  ///             thread.
+  ///
+  /// @return     The frame statistics summary.
+  ///
+  FrameStatistics::Summary GetFrameStatistics() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Clears the frame statistics. Can be called on any thread.
+  ///
+  void ResetFrameStatistics();
+
  private:
   using ServiceProtocolHandler =
       std::function<bool(const ServiceProtocol::Handler::ServiceProtocolMap&,
@@ -279,6 +296,9 @@ class Shell final : public PlatformView::Delegate,
       service_protocol_handlers_;
   bool is_setup_ = false;
   uint64_t next_pointer_flow_id_ = 0;
+  // Set when pointer event coalescing is enabled. Pointer data packets are
+  // pushed here on the platform thread and delivered by the engine.
+  std::shared_ptr<PointerEventQueue> pointer_event_queue_;
 
   bool first_frame_rasterized_ = false;
   std::atomic<bool> waiting_for_first_frame_ = true;
@@ -298,6 +318,9 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // Recorded on the GPU thread, summarized on demand.
+  FrameStatistics frame_statistics_;
+
   // How many frames have been timed since last report.
   size_t UnreportedFramesCount() const;
 
@@ -445,6 +468,11 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  bool OnServiceProtocolGetFrameStatistics(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   fml::WeakPtrFactory<Shell> weak_factory_;
 
   friend class testing::ShellTest;
@@ -2,7 +2,15 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <memory>
+#include <vector>
+
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
 #include "flutter/fml/logging.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/shell.h"
@@ -109,4 +117,60 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+// Builds a layer tree with |state.range(0)| clipped leaves the way the
+// SceneBuilder does, and tears it down again.
+static void BuildAndTeardownLayerTree(benchmark::State& state, bool use_arena) {
+  const SkMatrix matrix = SkMatrix::MakeTrans(1, 1);
+  const SkRect clip = SkRect::MakeWH(100, 100);
+  const SkSize size = SkSize::Make(10, 10);
+
+  while (state.KeepRunning()) {
+    auto layer_tree = std::make_unique<LayerTree>();
+    // Every pushed layer is handed out to the framework as an EngineLayer.
+    std::vector<std::shared_ptr<ContainerLayer>> engine_layers;
+
+    if (use_arena) {
+      auto arena = LayerArena::Create();
+      auto* root = arena->Make<TransformLayer>(matrix);
+      engine_layers.push_back(arena->Share(root));
+      for (int64_t i = 0; i < state.range(0); i++) {
+        auto* clip_layer = arena->Make<ClipRectLayer>(clip, Clip::hardEdge);
+        root->AddUnowned(clip_layer);
+        engine_layers.push_back(arena->Share(clip_layer));
+        clip_layer->AddUnowned(
+            arena->Make<TextureLayer>(SkPoint::Make(0, 0), size, i, false));
+      }
+      layer_tree->set_root_layer(arena->Share<Layer>(root));
+    } else {
+      auto root = std::make_shared<TransformLayer>(matrix);
+      engine_layers.push_back(root);
+      for (int64_t i = 0; i < state.range(0); i++) {
+        auto clip_layer = std::make_shared<ClipRectLayer>(clip, Clip::hardEdge);
+        root->Add(clip_layer);
+        engine_layers.push_back(clip_layer);
+        clip_layer->Add(std::make_unique<TextureLayer>(SkPoint::Make(0, 0),
+                                                       size, i, false));
+      }
+      layer_tree->set_root_layer(root);
+    }
+
+    // The framework releases its engine layers once they are collected and
+    // the rasterizer releases the layer tree once it has been drawn.
+    engine_layers.clear();
+    layer_tree.reset();
+  }
+}
+
+static void BM_LayerTreeBuildAndTeardown(benchmark::State& state) {
+  BuildAndTeardownLayerTree(state, false);
+}
+
+BENCHMARK(BM_LayerTreeBuildAndTeardown)->Range(8, 1024);
+
+static void BM_LayerTreeBuildAndTeardownInArena(benchmark::State& state) {
+  BuildAndTeardownLayerTree(state, true);
+}
+
+BENCHMARK(BM_LayerTreeBuildAndTeardownInArena)->Range(8, 1024);
+
 }  // namespace flutter
@@ -6,6 +6,7 @@
 #define FLUTTER_SHELL_COMMON_SURFACE_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/embedded_views.h"
@@ -31,10 +32,17 @@ class SurfaceFrame {
 
   sk_sp<SkSurface> SkiaSurface() const;
 
+  // The area of the surface that was repainted in this frame. Unset if the
+  // whole surface was repainted.
+  const std::optional<SkIRect>& damage() const { return damage_; }
+
+  void set_damage(const SkIRect& damage) { damage_ = damage; }
+
  private:
   bool submitted_;
   sk_sp<SkSurface> surface_;
   SubmitCallback submit_callback_;
+  std::optional<SkIRect> damage_;
 
   bool PerformSubmit();
 
@@ -60,6 +68,11 @@ class Surface {
 
   virtual bool MakeRenderContextCurrent();
 
+  // Whether frames acquired from this surface still contain the contents of
+  // the previously submitted frame. If so, only the damaged area of each frame
+  // is repainted.
+  virtual bool SupportsPartialRepaint() const;
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Surface);
 };
@@ -229,6 +229,43 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  settings.enable_concurrent_raster_cache = command_line.HasOption(
+      FlagForSwitch(Switch::EnableConcurrentRasterCache));
+
+  settings.enable_adaptive_raster_cache = command_line.HasOption(
+      FlagForSwitch(Switch::EnableAdaptiveRasterCache));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheRasterizationBudgetMs))) {
+    if (!GetSwitchValue(command_line, Switch::RasterCacheRasterizationBudgetMs,
+                        &settings.raster_cache_rasterization_budget_ms)) {
+      FML_LOG(INFO) << "Raster cache rasterization budget specified was "
+                       "malformed. Will default to "
+                    << settings.raster_cache_rasterization_budget_ms;
+    }
+  }
+
+  settings.enable_concurrent_software_paint = command_line.HasOption(
+      FlagForSwitch(Switch::EnableConcurrentSoftwarePaint));
+
+  settings.enable_frame_pipeline_mailbox = command_line.HasOption(
+      FlagForSwitch(Switch::EnableFramePipelineMailbox));
+
+  settings.enable_pointer_event_coalescing = command_line.HasOption(
+      FlagForSwitch(Switch::EnablePointerEventCoalescing));
+
+  settings.disable_frame_throttling =
+      command_line.HasOption(FlagForSwitch(Switch::DisableFrameThrottling));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    if (!GetSwitchValue(command_line, Switch::DecodedImageCacheMaxBytes,
+                        &settings.decoded_image_cache_max_bytes)) {
+      FML_LOG(INFO) << "Decoded image cache size specified was malformed. "
+                       "The cache will be disabled.";
+    }
+  }
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
@@ -330,6 +367,17 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.dump_skp_on_shader_compilation =
       command_line.HasOption(FlagForSwitch(Switch::DumpSkpOnShaderCompilation));
 
+  command_line.GetOptionValue(FlagForSwitch(Switch::ShaderWarmUpSkpPath),
+                              &settings.shader_warm_up_skp_path);
+  if (command_line.HasOption(FlagForSwitch(Switch::ShaderWarmUpBudgetMs))) {
+    if (!GetSwitchValue(command_line, Switch::ShaderWarmUpBudgetMs,
+                        &settings.shader_warm_up_budget_ms)) {
+      FML_LOG(INFO)
+          << "Shader warm-up budget specified was malformed. Will default to "
+          << settings.shader_warm_up_budget_ms;
+    }
+  }
+
   return settings;
 }
 
@@ -98,6 +98,49 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful"
            "when testing Flutter on emulators. By default, Flutter will"
            "attempt to either use OpenGL or Vulkan.")
+DEF_SWITCH(EnableConcurrentRasterCache,
+           "enable-concurrent-raster-cache",
+           "Rasterize raster cache entries for pictures on the concurrent "
+           "worker pool instead of on the GPU thread. Pictures are drawn "
+           "directly until their cache entries are ready.")
+DEF_SWITCH(EnableAdaptiveRasterCache,
+           "enable-adaptive-raster-cache",
+           "Decide which pictures and layers to rasterize into the raster "
+           "cache from their measured paint times instead of from static "
+           "hints and complexity heuristics.")
+DEF_SWITCH(RasterCacheRasterizationBudgetMs,
+           "raster-cache-rasterization-budget-ms",
+           "The time in milliseconds that may be spent rasterizing pictures "
+           "into the raster cache on the GPU thread per frame, instead of "
+           "rasterizing a fixed number of pictures per frame.")
+DEF_SWITCH(EnableConcurrentSoftwarePaint,
+           "enable-concurrent-software-paint",
+           "Split frames rendered by the software backend into horizontal "
+           "bands that are painted concurrently on the worker pool. Frames "
+           "with backdrop filters, textures, platform views or the "
+           "performance overlay are painted on the GPU thread.")
+DEF_SWITCH(EnableFramePipelineMailbox,
+           "enable-frame-pipeline-mailbox",
+           "Let a newly built frame replace the one still waiting to be "
+           "rasterized instead of blocking the UI thread. This reduces "
+           "latency when rasterization is the bottleneck at the cost of "
+           "dropped frames.")
+DEF_SWITCH(EnablePointerEventCoalescing,
+           "enable-pointer-event-coalescing",
+           "Deliver pointer events to the framework once per frame. "
+           "Consecutive moves of a device are merged and resampled to the "
+           "frame time. This reduces the load that high rate input devices "
+           "put on the UI thread.")
+DEF_SWITCH(DisableFrameThrottling,
+           "disable-frame-throttling",
+           "Begin frames as fast as they can be produced instead of waiting "
+           "for vsync. Meant for headless rendering, where frames are "
+           "encoded or captured instead of shown on a display.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The maximum number of bytes of decoded images the engine keeps, "
+           "so that images decoded from the same data with the same target "
+           "size are decoded and uploaded only once. Disabled by default.")
 DEF_SWITCH(SkiaDeterministicRendering,
            "skia-deterministic-rendering",
            "Skips the call to SkGraphics::Init(), thus avoiding swapping out"
@@ -129,6 +172,15 @@ DEF_SWITCH(DumpSkpOnShaderCompilation,
            "Automatically dump the skp that triggers new shader compilations. "
            "This is useful for writing custom ShaderWarmUp to reduce jank. "
            "By default, this is not enabled to reduce the overhead. ")
+DEF_SWITCH(ShaderWarmUpSkpPath,
+           "shader-warm-up-skp-path",
+           "Path to a directory of SKPs (e.g. ones dumped because of "
+           "--dump-skp-on-shader-compilation) that are replayed before the "
+           "first frame to compile the shaders they use ahead of time.")
+DEF_SWITCH(ShaderWarmUpBudgetMs,
+           "shader-warm-up-budget-ms",
+           "The maximum time in milliseconds spent replaying the SKPs given "
+           "by --shader-warm-up-skp-path. Defaults to 500.")
 DEF_SWITCH(
     TraceSystrace,
     "trace-systrace",
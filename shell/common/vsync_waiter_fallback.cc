@@ -20,8 +20,11 @@ static fml::TimePoint SnapToNextTick(fml::TimePoint value,
 
 }  // namespace
 
-VsyncWaiterFallback::VsyncWaiterFallback(TaskRunners task_runners)
-    : VsyncWaiter(std::move(task_runners)), phase_(fml::TimePoint::Now()) {}
+VsyncWaiterFallback::VsyncWaiterFallback(TaskRunners task_runners,
+                                         bool unthrottled)
+    : VsyncWaiter(std::move(task_runners)),
+      phase_(fml::TimePoint::Now()),
+      unthrottled_(unthrottled) {}
 
 VsyncWaiterFallback::~VsyncWaiterFallback() = default;
 
@@ -30,6 +33,14 @@ void VsyncWaiterFallback::AwaitVSync() {
   constexpr fml::TimeDelta kSingleFrameInterval =
       fml::TimeDelta::FromSecondsF(1.0 / 60.0);
 
+  if (unthrottled_) {
+    // The frame still targets a regular interval so that animations do not
+    // see an unrealistic deadline.
+    auto now = fml::TimePoint::Now();
+    FireCallback(now, now + kSingleFrameInterval);
+    return;
+  }
+
   auto next =
       SnapToNextTick(fml::TimePoint::Now(), phase_, kSingleFrameInterval);
 
@@ -15,12 +15,18 @@ namespace flutter {
 /// A |VsyncWaiter| that will fire at 60 fps irrespective of the vsync.
 class VsyncWaiterFallback final : public VsyncWaiter {
  public:
-  VsyncWaiterFallback(TaskRunners task_runners);
+  //----------------------------------------------------------------------------
+  /// @param[in]  unthrottled  Whether to fire immediately instead of waiting
+  ///                          for the next 60Hz tick. Used to render frames
+  ///                          as fast as possible when there is no display.
+  ///
+  VsyncWaiterFallback(TaskRunners task_runners, bool unthrottled = false);
 
   ~VsyncWaiterFallback() override;
 
  private:
   fml::TimePoint phase_;
+  const bool unthrottled_;
 
   // |VsyncWaiter|
   void AwaitVSync() override;
@@ -9,6 +9,16 @@
 
 namespace flutter {
 
+bool GPUSurfaceSoftwareDelegate::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  return PresentBackingStore(std::move(backing_store));
+}
+
+bool GPUSurfaceSoftwareDelegate::RetainsBackingStoreContents() const {
+  return false;
+}
+
 flutter::ExternalViewEmbedder*
 GPUSurfaceSoftwareDelegate::GetExternalViewEmbedder() {
   return nullptr;
@@ -59,6 +69,11 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
+    if (surface_frame.damage()) {
+      return self->delegate_->PresentBackingStoreWithDamage(
+          surface_frame.SkiaSurface(), *surface_frame.damage());
+    }
+
     return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
   };
 
@@ -85,4 +100,9 @@ flutter::ExternalViewEmbedder* GPUSurfaceSoftware::GetExternalViewEmbedder() {
   return delegate_->GetExternalViewEmbedder();
 }
 
+// |Surface|
+bool GPUSurfaceSoftware::SupportsPartialRepaint() const {
+  return delegate_ != nullptr && delegate_->RetainsBackingStoreContents();
+}
+
 }  // namespace flutter
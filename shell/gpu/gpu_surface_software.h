@@ -19,6 +19,16 @@ class GPUSurfaceSoftwareDelegate {
 
   virtual bool PresentBackingStore(sk_sp<SkSurface> backing_store) = 0;
 
+  // Presents a backing store of which only the |damage| area changed since
+  // the last presentation. Only called if |RetainsBackingStoreContents|
+  // returns true. Presents the whole backing store by default.
+  virtual bool PresentBackingStoreWithDamage(sk_sp<SkSurface> backing_store,
+                                             const SkIRect& damage);
+
+  // Whether the backing stores returned by |AcquireBackingStore| keep the
+  // contents of the last presented frame.
+  virtual bool RetainsBackingStoreContents() const;
+
   virtual flutter::ExternalViewEmbedder* GetExternalViewEmbedder();
 };
 
@@ -43,6 +53,9 @@ class GPUSurfaceSoftware : public Surface {
   // |Surface|
   flutter::ExternalViewEmbedder* GetExternalViewEmbedder() override;
 
+  // |Surface|
+  bool SupportsPartialRepaint() const override;
+
  private:
   GPUSurfaceSoftwareDelegate* delegate_;
   fml::WeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
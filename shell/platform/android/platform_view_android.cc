@@ -173,10 +173,10 @@ void PlatformViewAndroid::HandlePlatformMessage(
   auto java_channel = fml::jni::StringToJavaString(env, message->channel());
   if (message->hasData()) {
     fml::jni::ScopedJavaLocalRef<jbyteArray> message_array(
-        env, env->NewByteArray(message->data().size()));
+        env, env->NewByteArray(message->data().GetSize()));
     env->SetByteArrayRegion(
-        message_array.obj(), 0, message->data().size(),
-        reinterpret_cast<const jbyte*>(message->data().data()));
+        message_array.obj(), 0, message->data().GetSize(),
+        reinterpret_cast<const jbyte*>(message->data().GetMapping()));
     message = nullptr;
 
     // This call can re-enter in InvokePlatformMessageXxxResponseCallback.
@@ -22,7 +22,8 @@ void PlatformMessageRouter::HandlePlatformMessage(
     FlutterBinaryMessageHandler handler = it->second;
     NSData* data = nil;
     if (message->hasData()) {
-      data = GetNSDataFromVector(message->data());
+      data = [NSData dataWithBytes:message->data().GetMapping()
+                            length:message->data().GetSize()];
     }
     handler(data, ^(NSData* reply) {
       if (completer) {
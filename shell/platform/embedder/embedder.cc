@@ -29,6 +29,8 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/window/platform_message_stream.h"
+#include "flutter/shell/common/frame_encoder.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/switches.h"
@@ -81,14 +83,30 @@ static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
 
   const FlutterSoftwareRendererConfig* software_config = &config->software;
 
+  // Headless embedders may receive encoded frames instead.
   if (SAFE_ACCESS(software_config, surface_present_callback, nullptr) ==
-      nullptr) {
+          nullptr &&
+      SAFE_ACCESS(software_config, surface_present_encoded_frame_callback,
+                  nullptr) == nullptr) {
     return false;
   }
 
   return true;
 }
 
+static SkEncodedImageFormat ToSkEncodedImageFormat(
+    FlutterEncodedFrameFormat format) {
+  switch (format) {
+    case kFlutterEncodedFrameFormatPNG:
+      return SkEncodedImageFormat::kPNG;
+    case kFlutterEncodedFrameFormatJPEG:
+      return SkEncodedImageFormat::kJPEG;
+    case kFlutterEncodedFrameFormatWEBP:
+      return SkEncodedImageFormat::kWEBP;
+  }
+  return SkEncodedImageFormat::kPNG;
+}
+
 static bool IsRendererValid(const FlutterRendererConfig* config) {
   if (config == nullptr) {
     return false;
@@ -216,19 +234,77 @@ InferSoftwarePlatformViewCreationCallback(
     return nullptr;
   }
 
-  auto software_present_backing_store =
-      [ptr = config->software.surface_present_callback, user_data](
-          const void* allocation, size_t row_bytes, size_t height) -> bool {
-    return ptr(user_data, allocation, row_bytes, height);
-  };
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+  std::function<bool(const void*, size_t, size_t)>
+      software_present_backing_store = nullptr;
+  if (auto ptr =
+          SAFE_ACCESS(software_config, surface_present_callback, nullptr)) {
+    software_present_backing_store =
+        [ptr, user_data](const void* allocation, size_t row_bytes,
+                         size_t height) -> bool {
+      return ptr(user_data, allocation, row_bytes, height);
+    };
+  }
+
+  std::function<bool(const void*, size_t, size_t, const SkIRect&)>
+      software_present_backing_store_damage = nullptr;
+  if (auto damage_ptr = SAFE_ACCESS(software_config,
+                                    surface_present_damage_callback, nullptr)) {
+    software_present_backing_store_damage =
+        [damage_ptr, user_data](const void* allocation, size_t row_bytes,
+                                size_t height, const SkIRect& damage) -> bool {
+      FlutterRect damage_rect = {};
+      damage_rect.left = damage.left();
+      damage_rect.top = damage.top();
+      damage_rect.right = damage.right();
+      damage_rect.bottom = damage.bottom();
+      return damage_ptr(user_data, allocation, row_bytes, height,
+                        &damage_rect);
+    };
+  }
+
+  flutter::FrameEncoder::Callback software_present_encoded_frame = nullptr;
+  if (auto encoded_frame_ptr = SAFE_ACCESS(
+          software_config, surface_present_encoded_frame_callback, nullptr)) {
+    software_present_encoded_frame = [encoded_frame_ptr, user_data](
+                                         uint64_t frame_number,
+                                         const SkISize& size,
+                                         sk_sp<SkData> data) {
+      FlutterEncodedFrame frame = {};
+      frame.struct_size = sizeof(FlutterEncodedFrame);
+      frame.frame_number = frame_number;
+      frame.width = size.width();
+      frame.height = size.height();
+      frame.data = data ? data->bytes() : nullptr;
+      frame.data_size = data ? data->size() : 0;
+      encoded_frame_ptr(user_data, &frame);
+    };
+  }
+
+  // Zero initialized configs get the default quality.
+  int encoded_frame_quality =
+      SAFE_ACCESS(software_config, encoded_frame_quality, 0);
+  if (encoded_frame_quality <= 0) {
+    encoded_frame_quality = 100;
+  }
 
   flutter::EmbedderSurfaceSoftware::SoftwareDispatchTable
       software_dispatch_table = {
-          software_present_backing_store,  // required
+          software_present_backing_store,         // required unless encoding
+          software_present_backing_store_damage,  // optional
+          software_present_encoded_frame,         // optional
+          ToSkEncodedImageFormat(SAFE_ACCESS(software_config,
+                                             encoded_frame_format,
+                                             kFlutterEncodedFrameFormatPNG)),
+          encoded_frame_quality,
       };
 
   return [software_dispatch_table,
-          platform_dispatch_table](flutter::Shell& shell) {
+          platform_dispatch_table](flutter::Shell& shell) mutable {
+    if (software_dispatch_table.software_present_encoded_frame) {
+      software_dispatch_table.encoding_task_runner =
+          shell.GetDartVM()->GetConcurrentWorkerTaskRunner();
+    }
     return std::make_unique<flutter::PlatformViewEmbedder>(
         shell,                    // delegate
         shell.GetTaskRunners(),   // task runners
@@ -265,6 +341,10 @@ struct _FlutterPlatformMessageResponseHandle {
   fml::RefPtr<flutter::PlatformMessage> message;
 };
 
+struct _FlutterPlatformMessageStream {
+  fml::RefPtr<flutter::PlatformMessageStream> stream;
+};
+
 void PopulateSnapshotMappingCallbacks(const FlutterProjectArgs* args,
                                       flutter::Settings& settings) {
   // There are no ownership concerns here as all mappings are owned by the
@@ -496,8 +576,8 @@ FlutterEngineResult FlutterEngineRun(size_t version,
           const FlutterPlatformMessage incoming_message = {
               sizeof(FlutterPlatformMessage),  // struct_size
               message->channel().c_str(),      // channel
-              message->data().data(),          // message
-              message->data().size(),          // message_size
+              message->data().GetMapping(),    // message
+              message->data().GetSize(),       // message_size
               handle,                          // response_handle
           };
           handle->message = std::move(message);
@@ -800,9 +880,23 @@ FlutterEngineResult FlutterEngineSendPointerEvent(
              : LOG_EMBEDDER_ERROR(kInvalidArguments);
 }
 
-FlutterEngineResult FlutterEngineSendPlatformMessage(
+static FlutterEngineResult SendPlatformMessage(
     FlutterEngine engine,
-    const FlutterPlatformMessage* flutter_message) {
+    const FlutterPlatformMessage* flutter_message,
+    VoidCallback release_callback,
+    void* release_user_data) {
+  // Takes over the buffer of a message sent without a copy right away so that
+  // it is released even if the message is never sent.
+  std::unique_ptr<fml::Mapping> message_mapping;
+  if (release_callback != nullptr && flutter_message != nullptr) {
+    message_mapping = std::make_unique<fml::NonOwnedMapping>(
+        SAFE_ACCESS(flutter_message, message, nullptr),
+        SAFE_ACCESS(flutter_message, message_size, 0),
+        [release_callback, release_user_data](const uint8_t*, size_t) {
+          release_callback(release_user_data);
+        });
+  }
+
   if (engine == nullptr || flutter_message == nullptr) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments);
   }
@@ -830,6 +924,9 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
   if (message_size == 0) {
     message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel, response);
+  } else if (message_mapping) {
+    message = fml::MakeRefCounted<flutter::PlatformMessage>(
+        flutter_message->channel, std::move(message_mapping), response);
   } else {
     message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel,
@@ -843,6 +940,24 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
              : LOG_EMBEDDER_ERROR(kInvalidArguments);
 }
 
+FlutterEngineResult FlutterEngineSendPlatformMessage(
+    FlutterEngine engine,
+    const FlutterPlatformMessage* flutter_message) {
+  return SendPlatformMessage(engine, flutter_message, nullptr, nullptr);
+}
+
+FlutterEngineResult FlutterEngineSendPlatformMessageNoCopy(
+    FlutterEngine engine,
+    const FlutterPlatformMessage* flutter_message,
+    VoidCallback release_callback,
+    void* user_data) {
+  if (release_callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments);
+  }
+  return SendPlatformMessage(engine, flutter_message, release_callback,
+                             user_data);
+}
+
 FlutterEngineResult FlutterPlatformMessageCreateResponseHandle(
     FlutterEngine engine,
     FlutterDataCallback data_callback,
@@ -909,6 +1024,79 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineCreatePlatformMessageStream(
+    FlutterEngine engine,
+    const char* channel,
+    size_t max_pending_bytes,
+    VoidCallback drain_callback,
+    void* user_data,
+    FlutterPlatformMessageStream** stream_out) {
+  if (engine == nullptr || channel == nullptr || max_pending_bytes == 0 ||
+      stream_out == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments);
+  }
+
+  fml::closure drain_closure;
+  if (drain_callback != nullptr) {
+    drain_closure = [drain_callback, user_data]() {
+      drain_callback(user_data);
+    };
+  }
+
+  auto handle = new FlutterPlatformMessageStream();
+  handle->stream = fml::MakeRefCounted<flutter::PlatformMessageStream>(
+      channel, max_pending_bytes, std::move(drain_closure));
+  *stream_out = handle;
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineWritePlatformMessageStream(
+    FlutterEngine engine,
+    FlutterPlatformMessageStream* stream,
+    const uint8_t* data,
+    size_t data_length,
+    bool* is_full) {
+  if (engine == nullptr || stream == nullptr || data == nullptr ||
+      data_length == 0) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments);
+  }
+
+  auto message = stream->stream->Write(
+      std::make_unique<fml::DataMapping>(
+          std::vector<uint8_t>(data, data + data_length)),
+      is_full);
+  if (!message) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency);
+  }
+
+  if (!reinterpret_cast<flutter::EmbedderEngine*>(engine)->SendPlatformMessage(
+          message)) {
+    stream->stream->OnChunkConsumed(*message);
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency);
+  }
+
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineClosePlatformMessageStream(
+    FlutterEngine engine,
+    FlutterPlatformMessageStream* stream) {
+  if (engine == nullptr || stream == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments);
+  }
+
+  auto message = stream->stream->Close();
+  delete stream;
+
+  if (!message ||
+      !reinterpret_cast<flutter::EmbedderEngine*>(engine)->SendPlatformMessage(
+          std::move(message))) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency);
+  }
+
+  return kSuccess;
+}
+
 FlutterEngineResult __FlutterEngineFlushPendingTasksNow() {
   fml::MessageLoop::GetCurrent().RunExpiredTasksNow();
   return kSuccess;
@@ -1064,3 +1252,49 @@ FlutterEngineResult FlutterEngineRunTask(FlutterEngine engine,
              ? kSuccess
              : LOG_EMBEDDER_ERROR(kInvalidArguments);
 }
+
+static FlutterFramePhasePercentiles ToFlutterFramePhasePercentiles(
+    const flutter::FrameStatistics::Percentiles& percentiles) {
+  FlutterFramePhasePercentiles result = {};
+  result.p50 = percentiles.p50.ToMicroseconds();
+  result.p90 = percentiles.p90.ToMicroseconds();
+  result.p99 = percentiles.p99.ToMicroseconds();
+  result.p999 = percentiles.p999.ToMicroseconds();
+  result.max = percentiles.max.ToMicroseconds();
+  return result;
+}
+
+FlutterEngineResult FlutterEngineGetFrameStatistics(
+    FlutterEngine engine,
+    FlutterFrameStatistics* statistics) {
+  if (engine == nullptr || statistics == nullptr ||
+      statistics->struct_size < sizeof(FlutterFrameStatistics)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments);
+  }
+
+  flutter::FrameStatistics::Summary summary;
+  if (!reinterpret_cast<flutter::EmbedderEngine*>(engine)->GetFrameStatistics(
+          summary)) {
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency);
+  }
+
+  statistics->frame_count = summary.frame_count;
+  statistics->dropped_frame_count = summary.dropped_frame_count;
+  statistics->shader_compilation_frame_count =
+      summary.shader_compilation_frame_count;
+  statistics->build_time = ToFlutterFramePhasePercentiles(summary.build_time);
+  statistics->raster_time = ToFlutterFramePhasePercentiles(summary.raster_time);
+  statistics->total_time = ToFlutterFramePhasePercentiles(summary.total_time);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineResetFrameStatistics(FlutterEngine engine) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments);
+  }
+
+  return reinterpret_cast<flutter::EmbedderEngine*>(engine)
+                 ->ResetFrameStatistics()
+             ? kSuccess
+             : LOG_EMBEDDER_ERROR(kInternalInconsistency);
+}
@@ -207,6 +207,35 @@ typedef struct {
   VoidCallback destruction_callback;
 } FlutterOpenGLTexture;
 
+typedef struct {
+  double left;
+  double top;
+  double right;
+  double bottom;
+} FlutterRect;
+
+// The image formats frames can be encoded in for headless rendering.
+typedef enum {
+  kFlutterEncodedFrameFormatPNG,
+  kFlutterEncodedFrameFormatJPEG,
+  kFlutterEncodedFrameFormatWEBP,
+} FlutterEncodedFrameFormat;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterEncodedFrame).
+  size_t struct_size;
+  // The number of the frame. Frames are numbered from zero in the order they
+  // were rendered.
+  uint64_t frame_number;
+  // The dimensions of the frame in physical pixels.
+  size_t width;
+  size_t height;
+  // The encoded frame. Null if the frame could not be encoded. The data is
+  // owned by the engine and only valid for the duration of the callback.
+  const uint8_t* data;
+  size_t data_size;
+} FlutterEncodedFrame;
+
 typedef bool (*BoolCallback)(void* /* user data */);
 typedef FlutterTransformation (*TransformationCallback)(void* /* user data */);
 typedef uint32_t (*UIntCallback)(void* /* user data */);
@@ -214,6 +243,15 @@ typedef bool (*SoftwareSurfacePresentCallback)(void* /* user data */,
                                                const void* /* allocation */,
                                                size_t /* row bytes */,
                                                size_t /* height */);
+typedef bool (*SoftwareSurfacePresentDamageCallback)(
+    void* /* user data */,
+    const void* /* allocation */,
+    size_t /* row bytes */,
+    size_t /* height */,
+    const FlutterRect* /* damage */);
+typedef void (*SoftwareSurfacePresentEncodedFrameCallback)(
+    void* /* user data */,
+    const FlutterEncodedFrame* /* frame */);
 typedef void* (*ProcResolver)(void* /* user data */, const char* /* name */);
 typedef bool (*TextureFrameCallback)(void* /* user data */,
                                      int64_t /* texture identifier */,
@@ -260,6 +298,30 @@ typedef struct {
   // format. The buffer is owned by the Flutter engine and must be copied in
   // this callback if needed.
   SoftwareSurfacePresentCallback surface_present_callback;
+  // Optional. When specified, the engine retains the buffer across frames and
+  // only repaints the parts of it that changed since the last presentation.
+  // This callback is then invoked instead of |surface_present_callback| with
+  // the area of the buffer that changed. Pixels outside of that area are the
+  // same as in the previously presented buffer. The damage may be empty if
+  // nothing changed.
+  SoftwareSurfacePresentDamageCallback surface_present_damage_callback;
+  // Optional. For headless rendering. When specified, frames are not handed to
+  // |surface_present_callback|, which may then be null. Instead, each frame is
+  // encoded in |encoded_frame_format| on an engine managed worker thread and
+  // passed to this callback. Frames are delivered one at a time and in the
+  // order they were rendered, but not necessarily on the same thread. The
+  // engine stops rendering while too many frames are waiting to be encoded.
+  //
+  // Combine with the `--disable-frame-throttling` engine switch to render
+  // frames as fast as possible instead of at the display refresh rate.
+  SoftwareSurfacePresentEncodedFrameCallback
+      surface_present_encoded_frame_callback;
+  // The format frames passed to |surface_present_encoded_frame_callback| are
+  // encoded in.
+  FlutterEncodedFrameFormat encoded_frame_format;
+  // The quality of frames encoded in lossy formats, from 1 to 100. Ignored
+  // for PNG. Zero (or leaving the field out) selects the default of 100.
+  int encoded_frame_quality;
 } FlutterSoftwareRendererConfig;
 
 typedef struct {
@@ -383,6 +445,9 @@ typedef struct {
   const FlutterPlatformMessageResponseHandle* response_handle;
 } FlutterPlatformMessage;
 
+struct _FlutterPlatformMessageStream;
+typedef struct _FlutterPlatformMessageStream FlutterPlatformMessageStream;
+
 typedef void (*FlutterPlatformMessageCallback)(
     const FlutterPlatformMessage* /* message*/,
     void* /* user data */);
@@ -391,13 +456,6 @@ typedef void (*FlutterDataCallback)(const uint8_t* /* data */,
                                     size_t /* size */,
                                     void* /* user data */);
 
-typedef struct {
-  double left;
-  double top;
-  double right;
-  double bottom;
-} FlutterRect;
-
 // |FlutterSemanticsNode| ID used as a sentinel to signal the end of a batch of
 // semantics node updates.
 FLUTTER_EXPORT
@@ -687,6 +745,35 @@ typedef struct {
   const FlutterCustomTaskRunners* custom_task_runners;
 } FlutterProjectArgs;
 
+// Percentiles of the duration of a frame phase, in microseconds.
+typedef struct {
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t p999;
+  uint64_t max;
+} FlutterFramePhasePercentiles;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterFrameStatistics).
+  size_t struct_size;
+  // The number of frames rasterized since the engine was started or since the
+  // last call to |FlutterEngineResetFrameStatistics|.
+  uint64_t frame_count;
+  // The number of frames whose build or raster phase took longer than the
+  // interval between two vsyncs.
+  uint64_t dropped_frame_count;
+  // The number of frames during which new shaders had to be compiled.
+  uint64_t shader_compilation_frame_count;
+  // The time spent building the layer tree on the UI thread.
+  FlutterFramePhasePercentiles build_time;
+  // The time spent rasterizing the layer tree on the render thread.
+  FlutterFramePhasePercentiles raster_time;
+  // The time from the vsync that started the frame to the end of its
+  // rasterization.
+  FlutterFramePhasePercentiles total_time;
+} FlutterFrameStatistics;
+
 FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineRun(size_t version,
                                      const FlutterRendererConfig* config,
@@ -713,6 +800,23 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     FlutterEngine engine,
     const FlutterPlatformMessage* message);
 
+// Sends a platform message like |FlutterEngineSendPlatformMessage| but without
+// copying its payload. Instead, the engine takes over the buffer referenced by
+// the |message| field and hands it to the Dart application as is. The buffer
+// must stay valid, and may be written to by the application, till the engine
+// invokes |release_callback| with |user_data|. The callback may be invoked on
+// any thread, and is invoked before this call returns if the message is not
+// sent.
+//
+// This is useful for plugins that send large payloads (e.g. camera frames) at
+// a high rate.
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageNoCopy(
+    FlutterEngine engine,
+    const FlutterPlatformMessage* message,
+    VoidCallback release_callback,
+    void* user_data);
+
 // Creates a platform message response handle that allows the embedder to set a
 // native callback for a response to a message. This handle may be set on the
 // |response_handle| field of any |FlutterPlatformMessage| sent to the engine.
@@ -747,6 +851,54 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
     const uint8_t* data,
     size_t data_length);
 
+// Creates a stream that sends a large payload to the Dart application on the
+// given channel in chunks. Each chunk written to the stream via
+// |FlutterEngineWritePlatformMessageStream| is delivered to the application as
+// soon as possible, so that it can start processing the payload before all of
+// it has been written.
+//
+// Once the chunks that were written but not yet delivered add up to
+// |max_pending_bytes|, the stream reports that it is full. The embedder should
+// then stop writing till |drain_callback| is invoked with |user_data|, which
+// happens once half of the pending bytes have been delivered. The callback is
+// invoked on an internal engine managed thread and is optional.
+//
+// The stream must be collected via a call to
+// |FlutterEngineClosePlatformMessageStream|.
+//
+// Streaming is only available through this API. The Android and iOS embeddings
+// in this repository don't stream their platform messages.
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineCreatePlatformMessageStream(
+    FlutterEngine engine,
+    const char* channel,
+    size_t max_pending_bytes,
+    VoidCallback drain_callback,
+    void* user_data,
+    FlutterPlatformMessageStream** stream_out);
+
+// Copies |data| and sends it as the next chunk of the stream. Chunks are
+// delivered in the order in which they are written. Can be called on any
+// thread, but calls for the same stream must not be made concurrently. If
+// |is_full| is not null, it is set to whether the embedder should wait for the
+// drain callback of the stream before writing again. Chunks written to a full
+// stream are not dropped.
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineWritePlatformMessageStream(
+    FlutterEngine engine,
+    FlutterPlatformMessageStream* stream,
+    const uint8_t* data,
+    size_t data_length,
+    bool* is_full);
+
+// Ends the stream and collects it. The application receives an empty last
+// chunk after all chunks written before this call. The drain callback of the
+// stream is not invoked for chunks delivered after this call.
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineClosePlatformMessageStream(
+    FlutterEngine engine,
+    FlutterPlatformMessageStream* stream);
+
 // This API is only meant to be used by platforms that need to flush tasks on a
 // message loop not controlled by the Flutter engine. This API will be
 // deprecated soon.
@@ -868,6 +1020,21 @@ FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineRunTask(FlutterEngine engine,
                                          const FlutterTask* task);
 
+// Fills |statistics| with a summary of the timings of the frames rasterized by
+// the engine. Frame statistics are always collected and do not require the
+// performance overlay to be enabled. The |struct_size| field of |statistics|
+// must be set by the caller. Can be called on any thread.
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameStatistics(
+    FlutterEngine engine,
+    FlutterFrameStatistics* statistics);
+
+// Clears the frame statistics so that subsequent calls to
+// |FlutterEngineGetFrameStatistics| only account for frames rasterized after
+// this call. Can be called on any thread.
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineResetFrameStatistics(FlutterEngine engine);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/logging.h"
+#include "flutter/shell/platform/embedder/embedder_surface_software.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace flutter {
+
+// Renders and presents frames of the given size through the software surface
+// of the embedder, the way the rasterizer does.
+static void PresentSoftwareFrames(
+    benchmark::State& state,
+    EmbedderSurfaceSoftware::SoftwareDispatchTable dispatch_table) {
+  const SkISize size = SkISize::Make(state.range(0), state.range(0));
+  EmbedderSurfaceSoftware embedder_surface(std::move(dispatch_table));
+  auto surface =
+      static_cast<EmbedderSurface&>(embedder_surface).CreateGPUSurface();
+  FML_CHECK(surface);
+
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  int64_t frame_count = 0;
+  for (auto _ : state) {
+    auto frame = surface->AcquireFrame(size);
+    FML_CHECK(frame);
+    // Change the contents of every frame so that the encoder cannot benefit
+    // from identical input.
+    SkCanvas* canvas = frame->SkiaCanvas();
+    canvas->clear(SK_ColorWHITE);
+    paint.setColor(frame_count % 2 == 0 ? SK_ColorRED : SK_ColorBLUE);
+    canvas->drawCircle(frame_count % size.width(), size.height() / 2,
+                       size.width() / 4, paint);
+    FML_CHECK(frame->Submit());
+    frame_count++;
+  }
+  // Frames that are still being encoded when the surface is destroyed are not
+  // timed. Their number is bounded, so this does not skew the frame rate.
+  state.SetItemsProcessed(frame_count);
+}
+
+// Presents each frame by copying it into a buffer owned by the embedder. This
+// is the baseline for headless rendering with encoded frames.
+static void BM_EmbedderSoftwarePresent(benchmark::State& state) {
+  std::vector<uint8_t> presented_frame;
+  EmbedderSurfaceSoftware::SoftwareDispatchTable dispatch_table;
+  dispatch_table.software_present_backing_store =
+      [&presented_frame](const void* allocation, size_t row_bytes,
+                         size_t height) {
+        const auto* bytes = static_cast<const uint8_t*>(allocation);
+        presented_frame.assign(bytes, bytes + row_bytes * height);
+        return true;
+      };
+  PresentSoftwareFrames(state, std::move(dispatch_table));
+}
+
+BENCHMARK(BM_EmbedderSoftwarePresent)
+    ->RangeMultiplier(2)
+    ->Range(256, 1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Measures the frame rate of headless rendering when every frame is encoded
+// in the given format before it is handed to the embedder.
+static void BM_EmbedderSoftwarePresentEncodedFrame(
+    benchmark::State& state,
+    SkEncodedImageFormat format) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  EmbedderSurfaceSoftware::SoftwareDispatchTable dispatch_table;
+  dispatch_table.software_present_encoded_frame =
+      [](uint64_t, const SkISize&, sk_sp<SkData> data) { FML_CHECK(data); };
+  dispatch_table.encoded_frame_format = format;
+  dispatch_table.encoding_task_runner = loop->GetTaskRunner();
+  PresentSoftwareFrames(state, std::move(dispatch_table));
+}
+
+BENCHMARK_CAPTURE(BM_EmbedderSoftwarePresentEncodedFrame,
+                  png,
+                  SkEncodedImageFormat::kPNG)
+    ->RangeMultiplier(2)
+    ->Range(256, 1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_EmbedderSoftwarePresentEncodedFrame,
+                  jpeg,
+                  SkEncodedImageFormat::kJPEG)
+    ->RangeMultiplier(2)
+    ->Range(256, 1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
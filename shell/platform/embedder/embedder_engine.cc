@@ -229,4 +229,23 @@ bool EmbedderEngine::RunTask(const FlutterTask* task) {
                                 task->task);
 }
 
+bool EmbedderEngine::GetFrameStatistics(
+    FrameStatistics::Summary& summary) const {
+  if (!IsValid()) {
+    return false;
+  }
+
+  summary = shell_->GetFrameStatistics();
+  return true;
+}
+
+bool EmbedderEngine::ResetFrameStatistics() {
+  if (!IsValid()) {
+    return false;
+  }
+
+  shell_->ResetFrameStatistics();
+  return true;
+}
+
 }  // namespace flutter
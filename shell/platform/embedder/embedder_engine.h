@@ -71,6 +71,10 @@ class EmbedderEngine {
 
   bool RunTask(const FlutterTask* task);
 
+  bool GetFrameStatistics(FrameStatistics::Summary& summary) const;
+
+  bool ResetFrameStatistics();
+
  private:
   const std::unique_ptr<EmbedderThreadHost> thread_host_;
   TaskRunners task_runners_;
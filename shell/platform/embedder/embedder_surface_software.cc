@@ -9,10 +9,25 @@
 
 namespace flutter {
 
+// The number of frames that may be waiting to be encoded before rendering
+// blocks. Each one holds a copy of the backing store.
+static constexpr size_t kMaxPendingEncodedFrames = 4;
+
 EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
     SoftwareDispatchTable software_dispatch_table)
     : software_dispatch_table_(software_dispatch_table) {
-  if (!software_dispatch_table_.software_present_backing_store) {
+  if (software_dispatch_table_.software_present_encoded_frame) {
+    if (!software_dispatch_table_.encoding_task_runner) {
+      FML_LOG(ERROR) << "No task runner to encode software frames on.";
+      return;
+    }
+    frame_encoder_ = std::make_unique<FrameEncoder>(
+        software_dispatch_table_.encoding_task_runner,
+        software_dispatch_table_.encoded_frame_format,
+        software_dispatch_table_.encoded_frame_quality,
+        kMaxPendingEncodedFrames,
+        software_dispatch_table_.software_present_encoded_frame);
+  } else if (!software_dispatch_table_.software_present_backing_store) {
     return;
   }
   valid_ = true;
@@ -73,30 +88,45 @@ sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
   return sk_surface_;
 }
 
-// |GPUSurfaceSoftwareDelegate|
-bool EmbedderSurfaceSoftware::PresentBackingStore(
-    sk_sp<SkSurface> backing_store) {
+bool EmbedderSurfaceSoftware::PeekBackingStore(
+    const sk_sp<SkSurface>& backing_store,
+    SkPixmap* pixmap) const {
   if (!IsValid()) {
     FML_LOG(ERROR) << "Tried to present an invalid software surface.";
     return false;
   }
 
-  SkPixmap pixmap;
-  if (!backing_store->peekPixels(&pixmap)) {
+  if (!backing_store->peekPixels(pixmap)) {
     FML_LOG(ERROR) << "Could not peek the pixels of the backing store.";
     return false;
   }
 
   // Some basic sanity checking.
-  uint64_t expected_pixmap_data_size = pixmap.width() * pixmap.height() * 4;
+  uint64_t expected_pixmap_data_size = pixmap->width() * pixmap->height() * 4;
 
-  const size_t pixmap_size = pixmap.computeByteSize();
+  const size_t pixmap_size = pixmap->computeByteSize();
 
   if (expected_pixmap_data_size != pixmap_size) {
     FML_LOG(ERROR) << "Software backing store had unexpected size.";
     return false;
   }
 
+  return true;
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStore(
+    sk_sp<SkSurface> backing_store) {
+  SkPixmap pixmap;
+  if (!PeekBackingStore(backing_store, &pixmap)) {
+    return false;
+  }
+
+  if (frame_encoder_) {
+    frame_encoder_->Encode(pixmap);
+    return true;
+  }
+
   return software_dispatch_table_.software_present_backing_store(
       pixmap.addr(),      //
       pixmap.rowBytes(),  //
@@ -104,4 +134,37 @@ bool EmbedderSurfaceSoftware::PresentBackingStore(
   );
 }
 
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::PresentBackingStoreWithDamage(
+    sk_sp<SkSurface> backing_store,
+    const SkIRect& damage) {
+  if (frame_encoder_ ||
+      !software_dispatch_table_.software_present_backing_store_damage) {
+    return PresentBackingStore(std::move(backing_store));
+  }
+
+  SkPixmap pixmap;
+  if (!PeekBackingStore(backing_store, &pixmap)) {
+    return false;
+  }
+
+  return software_dispatch_table_.software_present_backing_store_damage(
+      pixmap.addr(),      //
+      pixmap.rowBytes(),  //
+      pixmap.height(),    //
+      damage              //
+  );
+}
+
+// |GPUSurfaceSoftwareDelegate|
+bool EmbedderSurfaceSoftware::RetainsBackingStoreContents() const {
+  // The same backing store is reused as long as the frame size does not
+  // change. The embedder has to opt in since it must then be able to deal
+  // with partially updated buffers. Encoded frames are copies, so the backing
+  // store is always free to be retained then.
+  return frame_encoder_ ||
+         static_cast<bool>(
+             software_dispatch_table_.software_present_backing_store_damage);
+}
+
 }  // namespace flutter
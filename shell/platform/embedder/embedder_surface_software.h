@@ -5,7 +5,9 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
+#include "flutter/shell/common/frame_encoder.h"
 #include "flutter/shell/gpu/gpu_surface_software.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
 
@@ -16,7 +18,17 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
  public:
   struct SoftwareDispatchTable {
     std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
-        software_present_backing_store;  // required
+        software_present_backing_store;  // required unless encoding frames
+    std::function<bool(const void* allocation,
+                       size_t row_bytes,
+                       size_t height,
+                       const SkIRect& damage)>
+        software_present_backing_store_damage;  // optional
+    FrameEncoder::Callback software_present_encoded_frame;  // optional
+    SkEncodedImageFormat encoded_frame_format = SkEncodedImageFormat::kPNG;
+    int encoded_frame_quality = 100;
+    // Required when |software_present_encoded_frame| is specified.
+    std::shared_ptr<fml::ConcurrentTaskRunner> encoding_task_runner;
   };
 
   EmbedderSurfaceSoftware(SoftwareDispatchTable software_dispatch_table);
@@ -27,6 +39,8 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   bool valid_ = false;
   SoftwareDispatchTable software_dispatch_table_;
   sk_sp<SkSurface> sk_surface_;
+  // Set when frames are encoded instead of presented to the embedder.
+  std::unique_ptr<FrameEncoder> frame_encoder_;
 
   // |EmbedderSurface|
   bool IsValid() const override;
@@ -43,6 +57,16 @@ class EmbedderSurfaceSoftware final : public EmbedderSurface,
   // |GPUSurfaceSoftwareDelegate|
   bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
 
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStoreWithDamage(sk_sp<SkSurface> backing_store,
+                                     const SkIRect& damage) override;
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool RetainsBackingStoreContents() const override;
+
+  bool PeekBackingStore(const sk_sp<SkSurface>& backing_store,
+                        SkPixmap* pixmap) const;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
 };
 
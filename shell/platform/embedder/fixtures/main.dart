@@ -168,6 +168,21 @@ void platform_messages_no_response() {
   signalNativeTest();
 }
 
+@pragma('vm:entry-point')
+void platform_message_streams() {
+  final Map<int, List<int>> payloads = <int, List<int>>{};
+  window.onPlatformMessageChunk = (String name, int streamId, ByteData data, bool isLast) {
+    final List<int> payload = payloads.putIfAbsent(streamId, () => <int>[]);
+    if (!isLast) {
+      payload.addAll(data.buffer.asUint8List(data.offsetInBytes, data.lengthInBytes));
+      return;
+    }
+    payloads.remove(streamId);
+    signalNativeMessage('$name:${utf8.decode(payload)}');
+  };
+  signalNativeTest();
+}
+
 @pragma('vm:entry-point')
 void null_platform_messages() {
   window.onPlatformMessage =
@@ -400,6 +400,140 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that a platform message large enough to be handed to Dart without a
+/// copy can be sent without the engine copying it either.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutCopies) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  const std::string message_data(4096, 'a');
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&message, &message_data](Dart_NativeArguments args) {
+            auto received_message = tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0));
+            ASSERT_EQ(received_message, message_data);
+            message.Signal();
+          })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  // The buffer is released by the engine once Dart has collected the message.
+  auto* buffer = new std::string(message_data);
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message = reinterpret_cast<const uint8_t*>(buffer->data());
+  platform_message.message_size = buffer->size();
+  platform_message.response_handle = nullptr;
+
+  auto result = FlutterEngineSendPlatformMessageNoCopy(
+      engine.get(), &platform_message,
+      [](void* user_data) { delete reinterpret_cast<std::string*>(user_data); },
+      buffer);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+}
+
+//------------------------------------------------------------------------------
+/// Tests that the buffer of a platform message sent without a copy is released
+/// right away if the message is invalid.
+///
+TEST_F(EmbedderTest, InvalidPlatformMessagesSentWithoutCopiesAreReleased) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  const std::string message_data = "Hello";
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = nullptr;
+  platform_message.message =
+      reinterpret_cast<const uint8_t*>(message_data.data());
+  platform_message.message_size = message_data.size();
+
+  bool released = false;
+  auto result = FlutterEngineSendPlatformMessageNoCopy(
+      engine.get(), &platform_message,
+      [](void* user_data) { *reinterpret_cast<bool*>(user_data) = true; },
+      &released);
+  ASSERT_EQ(result, kInvalidArguments);
+  ASSERT_TRUE(released);
+}
+
+//------------------------------------------------------------------------------
+/// Tests that a payload can be streamed to the application in chunks and that
+/// the writer is told to wait while too much of it is pending.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeStreamed) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+
+  builder.SetDartEntrypoint("platform_message_streams");
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(([&message](Dart_NativeArguments args) {
+        auto received_message = tonic::DartConverter<std::string>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        ASSERT_EQ("test_channel:Hello World", received_message);
+        message.Signal();
+      })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  fml::AutoResetWaitableEvent drained;
+  FlutterPlatformMessageStream* stream = nullptr;
+  auto result = FlutterEngineCreatePlatformMessageStream(
+      engine.get(), "test_channel", 5,
+      [](void* user_data) {
+        reinterpret_cast<fml::AutoResetWaitableEvent*>(user_data)->Signal();
+      },
+      &drained, &stream);
+  ASSERT_EQ(result, kSuccess);
+  ASSERT_NE(stream, nullptr);
+
+  const std::string chunks[] = {"Hello", " ", "World"};
+  for (const auto& chunk : chunks) {
+    bool is_full = false;
+    result = FlutterEngineWritePlatformMessageStream(
+        engine.get(), stream, reinterpret_cast<const uint8_t*>(chunk.data()),
+        chunk.size(), &is_full);
+    ASSERT_EQ(result, kSuccess);
+    if (is_full) {
+      drained.Wait();
+    }
+  }
+
+  result = FlutterEngineClosePlatformMessageStream(engine.get(), stream);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
@@ -465,5 +599,31 @@ TEST_F(EmbedderTest, InvalidPlatformMessages) {
   ASSERT_EQ(result, kInvalidArguments);
 }
 
+//------------------------------------------------------------------------------
+/// Tests that frame statistics can be queried without the performance overlay
+/// and that the struct size is validated.
+///
+TEST_F(EmbedderTest, CanGetFrameStatistics) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameStatistics statistics = {};
+  ASSERT_EQ(FlutterEngineGetFrameStatistics(engine.get(), &statistics),
+            kInvalidArguments);
+
+  statistics.struct_size = sizeof(FlutterFrameStatistics);
+  ASSERT_EQ(FlutterEngineGetFrameStatistics(engine.get(), &statistics),
+            kSuccess);
+  ASSERT_GE(statistics.frame_count, statistics.dropped_frame_count);
+  ASSERT_LE(statistics.build_time.p50, statistics.build_time.max);
+
+  ASSERT_EQ(FlutterEngineResetFrameStatistics(engine.get()), kSuccess);
+  ASSERT_EQ(FlutterEngineResetFrameStatistics(nullptr), kInvalidArguments);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -58,6 +58,33 @@ void main() {
         expect(Uint8List.view(data.buffer), expected);
       });
     });
+
+    group('JPEG format', () {
+      test('works with simple image', () async {
+        final Image image = await Square4x4Image.image;
+        final ByteData data = await image.toByteData(format: ImageByteFormat.jpeg);
+        final Uint8List bytes = data.buffer.asUint8List();
+        // Starts with the JPEG start of image marker.
+        expect(bytes.sublist(0, 2), <int>[0xFF, 0xD8]);
+      });
+
+      test('lower quality produces fewer bytes', () async {
+        final Image image = await Square4x4Image.image;
+        final ByteData best = await image.toByteData(format: ImageByteFormat.jpeg, quality: 100);
+        final ByteData worst = await image.toByteData(format: ImageByteFormat.jpeg, quality: 0);
+        expect(worst.lengthInBytes, lessThan(best.lengthInBytes));
+      });
+    });
+
+    group('WebP format', () {
+      test('works with simple image', () async {
+        final Image image = await Square4x4Image.image;
+        final ByteData data = await image.toByteData(format: ImageByteFormat.webp);
+        final Uint8List bytes = data.buffer.asUint8List();
+        expect(String.fromCharCodes(bytes.sublist(0, 4)), 'RIFF');
+        expect(String.fromCharCodes(bytes.sublist(8, 12)), 'WEBP');
+      });
+    });
   });
 }
 
@@ -62,6 +62,31 @@ void main() {
     expect(codecWidth, 10);
   });
 
+  test('decode a subset of the image', () async {
+    final Uint8List bytes = await readFile('4x4.png');
+    final Codec codec = await instantiateImageCodec(bytes,
+        targetSubset: const Rect.fromLTWH(1, 0, 1, 2));
+    final FrameInfo frame = await codec.getNextFrame();
+    expect(frame.image.height, 2);
+    expect(frame.image.width, 1);
+  });
+
+  test('resize a subset of the image', () async {
+    final Uint8List bytes = await readFile('4x4.png');
+    final Codec codec = await instantiateImageCodec(bytes,
+        targetWidth: 5, targetSubset: const Rect.fromLTWH(0, 0, 1, 2));
+    final FrameInfo frame = await codec.getNextFrame();
+    expect(frame.image.height, 10);
+    expect(frame.image.width, 5);
+  });
+
+  test('decoding a subset outside of the image fails', () async {
+    final Uint8List bytes = await readFile('4x4.png');
+    final Codec codec = await instantiateImageCodec(bytes,
+        targetSubset: const Rect.fromLTWH(1, 1, 4, 4));
+    expect(codec.getNextFrame(), throwsA(anything));
+  });
+
   test('pixels: no resize by default', () async {
     final BlackSquare blackSquare = BlackSquare.create();
     final Image resized = await blackSquare.resize();
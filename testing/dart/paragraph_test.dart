@@ -2,6 +2,7 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+import 'dart:typed_data';
 import 'dart:ui';
 
 import 'package:test/test.dart';
@@ -59,4 +60,41 @@ void main() {
       );
     }
   });
+  test('layoutAll matches layout', () {
+    Paragraph build(String text) {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+        fontFamily: 'Ahem',
+        fontSize: 10.0,
+        maxLines: 1,
+        ellipsis: '...',
+      ));
+      builder.addText(text);
+      return builder.build();
+    }
+
+    const List<String> texts = <String>['Test', 'Test Ahem', 'Test'];
+    const List<ParagraphConstraints> constraints = <ParagraphConstraints>[
+      ParagraphConstraints(width: 400.0),
+      ParagraphConstraints(width: 50.0),
+      ParagraphConstraints(width: 20.0),
+    ];
+    final List<Paragraph> paragraphs = texts.map(build).toList();
+    final Float64List metrics = Paragraph.layoutAll(paragraphs, constraints);
+    expect(metrics.length, 8 * texts.length);
+
+    for (int i = 0; i < texts.length; i += 1) {
+      final Paragraph expected = build(texts[i])..layout(constraints[i]);
+      final int offset = i * 8;
+      expect(paragraphs[i].width, expected.width);
+      expect(paragraphs[i].height, expected.height);
+      expect(metrics[offset + 0], expected.width);
+      expect(metrics[offset + 1], expected.height);
+      expect(metrics[offset + 2], expected.longestLine);
+      expect(metrics[offset + 3], expected.minIntrinsicWidth);
+      expect(metrics[offset + 4], expected.maxIntrinsicWidth);
+      expect(metrics[offset + 5], expected.alphabeticBaseline);
+      expect(metrics[offset + 6], expected.ideographicBaseline);
+      expect(metrics[offset + 7], expected.didExceedMaxLines ? 1.0 : 0.0);
+    }
+  });
 }
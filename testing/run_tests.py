@@ -102,6 +102,8 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'shell_benchmarks', filter)
 
+  RunEngineExecutable(build_dir, 'embedder_benchmarks', filter)
+
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter)
 
   if IsLinux():
@@ -42,4 +42,33 @@ static void BM_PaintRecordInit(benchmark::State& state) {
 }
 BENCHMARK(BM_PaintRecordInit);
 
+// Creates the records of a laid out line of rich text. The records refer to
+// the interned style of their run instead of copying its font families,
+// locale and shadows, so creating them does not allocate.
+static void BM_PaintRecordInitRichStyle(benchmark::State& state) {
+  TextStyle style;
+  style.font_families = {"Roboto", "Noto Sans", "Noto Color Emoji"};
+  style.locale = "en_US";
+  style.text_shadows.emplace_back(SK_ColorGRAY, SkPoint::Make(1, 1), 2);
+
+  SkFont font;
+  font.setSize(14);
+  SkTextBlobBuilder builder;
+  builder.allocRunPos(font, 10);
+  auto text_blob = builder.make();
+
+  const size_t record_count = 64;
+  std::vector<PaintRecord> records;
+  records.reserve(record_count);
+  while (state.KeepRunning()) {
+    records.clear();
+    for (size_t i = 0; i < record_count; i++) {
+      records.emplace_back(style, text_blob, SkFontMetrics(), 0, 0, 0, false);
+    }
+  }
+  state.counters["record_bytes"] = sizeof(PaintRecord);
+  state.SetItemsProcessed(state.iterations() * record_count);
+}
+BENCHMARK(BM_PaintRecordInitRichStyle);
+
 }  // namespace txt
@@ -17,6 +17,7 @@
 #include <minikin/Layout.h>
 
 #include "flutter/fml/command_line.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/third_party/txt/tests/txt_test_utils.h"
 #include "minikin/LayoutUtils.h"
@@ -30,6 +31,7 @@
 #include "txt/font_style.h"
 #include "txt/font_weight.h"
 #include "txt/paragraph.h"
+#include "txt/paragraph_batch.h"
 #include "txt/paragraph_builder_txt.h"
 
 namespace txt {
@@ -100,6 +102,51 @@ static void BM_ParagraphLongLayout(benchmark::State& state) {
 }
 BENCHMARK(BM_ParagraphLongLayout);
 
+// Lays out a paragraph at a sequence of widths, as during a window resize.
+// With an argument of 1, the paragraph is marked dirty before every layout to
+// show the cost of measuring the text again for each width.
+static void BM_ParagraphResizeLayout(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  const bool measure_every_layout = state.range(0) != 0;
+  const int min_width = 200;
+  const int max_width = 600;
+  int width = min_width;
+  while (state.KeepRunning()) {
+    if (measure_every_layout) {
+      paragraph->SetDirty();
+    }
+    paragraph->Layout(width);
+    width = width < max_width ? width + 10 : min_width;
+  }
+}
+BENCHMARK(BM_ParagraphResizeLayout)->Arg(0)->Arg(1);
+
 static void BM_ParagraphJustifyLayout(benchmark::State& state) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
@@ -228,6 +275,139 @@ BENCHMARK(BM_ParagraphStylesBigO)
     ->Range(1 << 3, 1 << 12)
     ->Complexity(benchmark::oN);
 
+// Lays out a paragraph on each benchmark thread. The threads share a font
+// collection and the layout caches, so the throughput shows how well layout
+// scales across cores.
+static void BM_ParagraphConcurrentLayout(benchmark::State& state) {
+  static std::shared_ptr<txt::FontCollection> font_collection =
+      GetTestFontCollection();
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParagraphConcurrentLayout)->ThreadRange(1, 8)->UseRealTime();
+
+// Lays out a table of short labels in one batch, as list and table screens do
+// every frame. Many of the labels repeat. Arg 1 spreads the layout across a
+// worker pool.
+static void BM_ParagraphLayoutBatch(benchmark::State& state) {
+  const size_t label_count = 300;
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  std::vector<std::unique_ptr<ParagraphTxt>> labels;
+  std::vector<Paragraph*> paragraphs;
+  std::vector<double> widths;
+  for (size_t i = 0; i < label_count; i++) {
+    auto icu_text = icu::UnicodeString::fromUTF8(
+        i % 3 == 0 ? "Status" : "Row " + std::to_string(i % 50));
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    labels.push_back(BuildParagraph(builder));
+    paragraphs.push_back(labels.back().get());
+    widths.push_back(120);
+  }
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  if (state.range(0) != 0) {
+    loop = fml::ConcurrentMessageLoop::Create();
+  }
+  auto task_runner = loop ? loop->GetTaskRunner() : nullptr;
+  while (state.KeepRunning()) {
+    for (auto& label : labels) {
+      label->SetDirty();
+    }
+    LayoutParagraphs(paragraphs, widths, task_runner.get());
+  }
+  state.SetItemsProcessed(state.iterations() * label_count);
+}
+BENCHMARK(BM_ParagraphLayoutBatch)->Arg(0)->Arg(1)->UseRealTime();
+
+// Lays out the messages of a chat, which repeat many of their words. The first
+// argument selects whether the shaped words cached by earlier frames are purged
+// before each frame.
+static void BM_ParagraphLayoutFeed(benchmark::State& state) {
+  const size_t message_count = 200;
+  const std::vector<std::string> words = {
+      "Alice", "Bob",  "sent", "a",     "photo", "see", "you",
+      "at",    "the",  "cafe", "today", "12:30", "PM",  "ok"};
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  std::vector<std::unique_ptr<ParagraphTxt>> messages;
+  for (size_t i = 0; i < message_count; i++) {
+    std::string text;
+    for (size_t j = 0; j < 8; j++) {
+      text += words[(i * 7 + j * 3) % words.size()] + " ";
+    }
+    auto icu_text = icu::UnicodeString::fromUTF8(text);
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    messages.push_back(BuildParagraph(builder));
+  }
+
+  const bool purge = state.range(0) == 0;
+  minikin::LayoutCacheStats before = minikin::Layout::getCacheStats();
+  while (state.KeepRunning()) {
+    if (purge) {
+      minikin::Layout::purgeCaches();
+    }
+    for (auto& message : messages) {
+      message->SetDirty();
+      message->Layout(300);
+    }
+  }
+  minikin::LayoutCacheStats after = minikin::Layout::getCacheStats();
+  const size_t lookups =
+      after.hits + after.misses - before.hits - before.misses;
+  state.counters["hit_rate"] =
+      lookups ? static_cast<double>(after.hits - before.hits) / lookups : 0;
+  state.counters["cached_bytes"] = after.bytes;
+  state.SetItemsProcessed(state.iterations() * message_count);
+}
+BENCHMARK(BM_ParagraphLayoutFeed)->Arg(0)->Arg(1);
+
 static void BM_ParagraphPaintSimple(benchmark::State& state) {
   const char* text = "Hello world! This is a simple sentence to test drawing.";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
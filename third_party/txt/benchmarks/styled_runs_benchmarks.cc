@@ -35,4 +35,31 @@ static void BM_StyledRunsGetRun(benchmark::State& state) {
 }
 BENCHMARK(BM_StyledRunsGetRun);
 
+// Adds the runs of rich text in which a few styles alternate, as in text with
+// links or highlighted search matches. Equal styles are interned, so the runs
+// hold one copy of each distinct style no matter how many runs use it.
+static void BM_StyledRunsAddRepeatedStyles(benchmark::State& state) {
+  std::vector<TextStyle> styles(4);
+  for (size_t i = 0; i < styles.size(); i++) {
+    styles[i].font_families = {"Roboto", "Noto Sans", "Noto Color Emoji"};
+    styles[i].locale = "en_US";
+    styles[i].color = SK_ColorBLACK + i;
+    styles[i].text_shadows.emplace_back(SK_ColorGRAY, SkPoint::Make(1, 1), 2);
+  }
+  const size_t run_count = state.range(0);
+  size_t style_count = 0;
+  while (state.KeepRunning()) {
+    StyledRuns runs;
+    for (size_t i = 0; i < run_count; i++) {
+      runs.StartRun(runs.AddStyle(styles[i % styles.size()]), i * 10);
+    }
+    runs.EndRunIfNeeded(run_count * 10);
+    style_count = runs.style_count();
+  }
+  state.counters["stored_styles"] = style_count;
+  state.counters["stored_style_bytes"] = style_count * sizeof(TextStyle);
+  state.SetItemsProcessed(state.iterations() * run_count);
+}
+BENCHMARK(BM_StyledRunsAddRepeatedStyles)->Range(8, 1024);
+
 }  // namespace txt
@@ -18,6 +18,8 @@
 
 #include "HbFontCache.h"
 
+#include <mutex>
+
 #include <log/log.h>
 #include <utils/LruCache.h>
 
@@ -54,46 +56,46 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
   android::LruCache<int32_t, hb_font_t*> mCache;
 };
 
-HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+// Guards the font cache.
+static std::mutex gHbFontCacheLock;
+
+static HbFontCache* getFontCache() {
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
-  getFontCacheLocked()->clear();
+void purgeHbFontCache() {
+  std::scoped_lock _l(gHbFontCacheLock);
+  getFontCache()->clear();
 }
 
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+void purgeHbFont(const MinikinFont* minikinFont) {
   const int32_t fontId = minikinFont->GetUniqueId();
-  getFontCacheLocked()->remove(fontId);
+  std::scoped_lock _l(gHbFontCacheLock);
+  getFontCache()->remove(fontId);
 }
 
 // Returns a new reference to a hb_font_t object, caller is
 // responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
   // TODO: get rid of nullFaceFont
-  static hb_font_t* nullFaceFont = nullptr;
+  static hb_font_t* nullFaceFont = hb_font_create(nullptr);
   if (minikinFont == nullptr) {
-    if (nullFaceFont == nullptr) {
-      nullFaceFont = hb_font_create(nullptr);
-    }
     return hb_font_reference(nullFaceFont);
   }
 
-  HbFontCache* fontCache = getFontCacheLocked();
+  HbFontCache* fontCache = getFontCache();
   const int32_t fontId = minikinFont->GetUniqueId();
-  hb_font_t* font = fontCache->get(fontId);
-  if (font != nullptr) {
-    return hb_font_reference(font);
+  {
+    std::scoped_lock _l(gHbFontCacheLock);
+    hb_font_t* font = fontCache->get(fontId);
+    if (font != nullptr) {
+      return hb_font_reference(font);
+    }
   }
 
+  // The font is created without holding the lock, as it may need to read
+  // tables from the typeface.
   hb_face_t* face = minikinFont->CreateHarfBuzzFace();
 
   hb_font_t* parent_font = hb_font_create(face);
@@ -102,7 +104,7 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
   unsigned int upem = hb_face_get_upem(face);
   hb_font_set_scale(parent_font, upem, upem);
 
-  font = hb_font_create_sub_font(parent_font);
+  hb_font_t* font = hb_font_create_sub_font(parent_font);
   std::vector<hb_variation_t> variations;
   for (const FontVariation& variation : minikinFont->GetAxes()) {
       variations.push_back({variation.axisTag, variation.value});
@@ -110,6 +112,15 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
   hb_font_set_variations(font, variations.data(), variations.size());
   hb_font_destroy(parent_font);
   hb_face_destroy(face);
+  hb_font_make_immutable(font);
+
+  std::scoped_lock _l(gHbFontCacheLock);
+  // Another thread may have created the font in the meantime.
+  hb_font_t* cached = fontCache->get(fontId);
+  if (cached != nullptr) {
+    hb_font_destroy(font);
+    return hb_font_reference(cached);
+  }
   fontCache->put(fontId, font);
   return hb_font_reference(font);
 }
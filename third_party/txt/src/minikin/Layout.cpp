@@ -20,8 +20,11 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -99,6 +102,11 @@ class LayoutCacheKey {
     mChars = NULL;
   }
 
+  // Bytes used by the key once its text is copied.
+  size_t getMemoryUsage() const {
+    return sizeof(LayoutCacheKey) + mNchars * sizeof(uint16_t);
+  }
+
   void doLayout(Layout* layout,
                 LayoutContext* ctx,
                 const std::shared_ptr<FontCollection>& collection) const {
@@ -129,53 +137,171 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// A part of the layout cache with its own lock. Words are spread over the
+// shards by their hash, so threads laying out different words rarely wait for
+// each other.
+class LayoutCacheShard
+    : private android::OnEntryRemoved<LayoutCacheKey, std::shared_ptr<Layout>> {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
+  explicit LayoutCacheShard(size_t maxBytes)
+      : mCache(android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>>::
+                   kUnlimitedCapacity),
+        mMaxBytes(maxBytes),
+        mBytes(0) {
     mCache.setOnEntryRemovedListener(this);
   }
 
-  void clear() { mCache.clear(); }
+  void clear() {
+    std::scoped_lock _l(mMutex);
+    mCache.clear();
+  }
+
+  void setMaxBytes(size_t maxBytes) {
+    std::scoped_lock _l(mMutex);
+    mMaxBytes = maxBytes;
+    trimLocked();
+  }
+
+  std::shared_ptr<Layout> get(const LayoutCacheKey& key) {
+    std::scoped_lock _l(mMutex);
+    return mCache.get(key);
+  }
 
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  // Returns the layout that is cached for the key, which is a layout cached by
+  // another thread if it laid out the same word first.
+  std::shared_ptr<Layout> put(LayoutCacheKey& key,
+                              std::shared_ptr<Layout> layout) {
+    std::scoped_lock _l(mMutex);
+    std::shared_ptr<Layout> cached = mCache.get(key);
+    if (cached != nullptr) {
+      return cached;
     }
+    key.copyText();
+    mBytes += getEntryBytes(key, *layout);
+    mCache.put(key, layout);
+    trimLocked();
     return layout;
   }
 
+  void addStats(LayoutCacheStats* stats) {
+    std::scoped_lock _l(mMutex);
+    stats->entries += mCache.size();
+    stats->bytes += mBytes;
+    stats->budgetBytes += mMaxBytes;
+  }
+
  private:
+  static size_t getEntryBytes(const LayoutCacheKey& key,
+                              const Layout& layout) {
+    return key.getMemoryUsage() + layout.getMemoryUsage();
+  }
+
+  void trimLocked() {
+    while (mBytes > mMaxBytes && mCache.removeOldest()) {
+    }
+  }
+
   // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
+  void operator()(LayoutCacheKey& key, std::shared_ptr<Layout>& value) {
+    mBytes -= getEntryBytes(key, *value);
+    // Threads that got the layout from the cache keep it alive until they are
+    // done with it.
     key.freeText();
-    delete value;
   }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+  std::mutex mMutex;
+  android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> mCache;
+  size_t mMaxBytes;
+  // Bytes used by the keys and layouts in the cache.
+  size_t mBytes;
+};
+
+// Caches the shaped words that layouts are assembled from. The words are keyed
+// by the font collection, the style and the text, so paragraphs that share
+// words, such as the messages of a chat, reuse each other's shaping. The cache
+// is bounded by the memory its words use rather than by their number, as the
+// glyphs of a word can be anything from a few bytes to kilobytes.
+class LayoutCache {
+ public:
+  LayoutCache() : mHits(0), mMisses(0) {
+    for (auto& shard : mShards) {
+      shard = std::make_unique<LayoutCacheShard>(kDefaultMaxBytes /
+                                                 kShardCount);
+    }
+  }
+
+  void clear() {
+    for (auto& shard : mShards) {
+      shard->clear();
+    }
+  }
+
+  void setMaxBytes(size_t maxBytes) {
+    for (auto& shard : mShards) {
+      shard->setMaxBytes(maxBytes / kShardCount);
+    }
+  }
+
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    LayoutCacheShard& shard = getShard(key);
+    std::shared_ptr<Layout> layout = shard.get(key);
+    if (layout != nullptr) {
+      mHits.fetch_add(1, std::memory_order_relaxed);
+      return layout;
+    }
+    mMisses.fetch_add(1, std::memory_order_relaxed);
+    // The word is laid out without holding the lock of the shard.
+    layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+    return shard.put(key, std::move(layout));
+  }
+
+  LayoutCacheStats getStats() {
+    LayoutCacheStats stats = {};
+    stats.hits = mHits.load(std::memory_order_relaxed);
+    stats.misses = mMisses.load(std::memory_order_relaxed);
+    for (auto& shard : mShards) {
+      shard->addStats(&stats);
+    }
+    return stats;
+  }
+
+ private:
+  LayoutCacheShard& getShard(const LayoutCacheKey& key) {
+    // The low bits of the hash also pick the bucket within a shard, so the
+    // shard is picked with the high bits.
+    return *mShards[static_cast<uint32_t>(key.hash()) >>
+                    (32 - kShardCountLog2)];
+  }
+
+  static const size_t kShardCountLog2 = 4;
+  static const size_t kShardCount = 1 << kShardCountLog2;
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+  static const size_t kDefaultMaxBytes = 4 * 1024 * 1024;
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  std::unique_ptr<LayoutCacheShard> mShards[kShardCount];
+  std::atomic<size_t> mHits;
+  std::atomic<size_t> mMisses;
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
+    hb_unicode_funcs_make_immutable(unicodeFunctions);
+  }
+
+  // HarfBuzz buffers must not be shared between threads, so each thread that
+  // lays out text shapes into its own buffer.
+  hb_buffer_t* getHbBuffer() {
+    thread_local std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)>
+        buffer(createHbBuffer(), &hb_buffer_destroy);
+    return buffer.get();
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -183,6 +309,13 @@ class LayoutEngine {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+ private:
+  hb_buffer_t* createHbBuffer() {
+    hb_buffer_t* buffer = hb_buffer_create();
+    hb_buffer_set_unicode_funcs(buffer, unicodeFunctions);
+    return buffer;
+  }
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
@@ -254,34 +387,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +446,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared with other threads, so the scale of the run is
+    // set on a sub font that belongs to this layout.
+    hb_font_t* cachedFont = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(cachedFont);
+    hb_font_destroy(cachedFont);
     // Temporarily removed to fix advance integer rounding.
     // This is likely due to very old versions of harfbuzz and ICU.
     // hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
@@ -327,10 +461,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -590,8 +721,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -614,8 +743,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -722,9 +849,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -921,7 +1048,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1194,11 +1321,24 @@ void Layout::getBounds(MinikinRect* bounds) const {
   bounds->set(mBounds);
 }
 
+size_t Layout::getMemoryUsage() const {
+  return sizeof(Layout) + mGlyphs.capacity() * sizeof(LayoutGlyph) +
+         mAdvances.capacity() * sizeof(float) +
+         mFaces.capacity() * sizeof(FakedFont);
+}
+
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
+}
+
+void Layout::setCacheBudget(size_t bytes) {
+  LayoutEngine::getInstance().layoutCache.setMaxBytes(bytes);
+}
+
+LayoutCacheStats Layout::getCacheStats() {
+  return LayoutEngine::getInstance().layoutCache.getStats();
 }
 
 }  // namespace minikin
@@ -57,6 +57,15 @@ enum {
   kBidi_Mask = 0x7
 };
 
+// Statistics of the cache of shaped words that layouts are assembled from.
+struct LayoutCacheStats {
+  size_t hits;
+  size_t misses;
+  size_t entries;
+  size_t bytes;
+  size_t budgetBytes;
+};
+
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
 // may not mutate it at the same time.
@@ -114,9 +123,18 @@ class Layout {
 
   void getBounds(MinikinRect* rect) const;
 
+  // Approximate number of bytes used by the layout, including its glyphs.
+  size_t getMemoryUsage() const;
+
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // Sets the number of bytes that the shaped words cached across all layouts
+  // may use. The least recently used words are evicted to stay within it.
+  static void setCacheBudget(size_t bytes);
+
+  static LayoutCacheStats getCacheStats();
+
  private:
   friend class LayoutCacheKey;
 
@@ -121,14 +121,37 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                size_t start,
                                size_t end,
                                bool isRtl) {
+  return addStyleRunImpl(paint, typeface, style, start, end, isRtl, true);
+}
+
+void LineBreaker::addMeasuredStyleRun(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl) {
+  addStyleRunImpl(paint, typeface, style, start, end, isRtl, false);
+}
+
+float LineBreaker::addStyleRunImpl(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl,
+    bool measure) {
   float width = 0.0f;
   int bidiFlags = isRtl ? kBidi_Force_RTL : kBidi_Force_LTR;
 
   float hyphenPenalty = 0.0;
   if (paint != nullptr) {
-    width = Layout::measureText(mTextBuf.data(), start, end - start,
-                                mTextBuf.size(), bidiFlags, style, *paint,
-                                typeface, mCharWidths.data() + start);
+    if (measure) {
+      width = Layout::measureText(mTextBuf.data(), start, end - start,
+                                  mTextBuf.size(), bidiFlags, style, *paint,
+                                  typeface, mCharWidths.data() + start);
+    }
 
     // a heuristic that seems to perform well
     hyphenPenalty =
@@ -145,6 +145,17 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Like addStyleRun, but assumes that the widths of the code units in
+  // the range were already measured with the same paint and stored in the width
+  // buffer, e.g. when breaking the same text at another width. The breaks are
+  // the same as those of addStyleRun, but the text is not shaped again.
+  void addMeasuredStyleRun(MinikinPaint* paint,
+                           const std::shared_ptr<FontCollection>& typeface,
+                           FontStyle style,
+                           size_t start,
+                           size_t end,
+                           bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -190,6 +201,14 @@ class LineBreaker {
 
   float currentLineWidth() const;
 
+  float addStyleRunImpl(MinikinPaint* paint,
+                        const std::shared_ptr<FontCollection>& typeface,
+                        FontStyle style,
+                        size_t start,
+                        size_t end,
+                        bool isRtl,
+                        bool measure);
+
   void addWordBreak(size_t offset,
                     ParaWidth preBreak,
                     ParaWidth postBreak,
@@ -27,6 +27,7 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "font_skia.h"
+#include "minikin/Layout.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
 
@@ -130,6 +131,7 @@ std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  std::scoped_lock lock(cache_mutex_);
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -238,6 +240,7 @@ std::shared_ptr<minikin::FontFamily> FontCollection::CreateMinikinFontFamily(
 const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  std::scoped_lock lock(cache_mutex_);
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
@@ -299,9 +302,21 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
+  std::scoped_lock lock(cache_mutex_);
   font_collections_cache_.clear();
 }
 
+void FontCollection::TraceShapedWordCacheCounters() {
+  minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  FML_TRACE_COUNTER("flutter", "ShapedWordCache", 0u,         //
+                    "Hits", stats.hits,                       //
+                    "Misses", stats.misses,                   //
+                    "WordCount", stats.entries,               //
+                    "MBytes", stats.bytes * 1e-6,             //
+                    "BudgetMBytes", stats.budgetBytes * 1e-6  //
+  );
+}
+
 #if FLUTTER_ENABLE_SKSHAPER
 
 sk_sp<skia::textlayout::FontCollection>
@@ -40,4 +40,8 @@ std::string FontFeatures::GetFeatureSettings() const {
   return stream.str();
 }
 
+bool FontFeatures::operator==(const FontFeatures& other) const {
+  return feature_map_ == other.feature_map_;
+}
+
 }  // namespace txt
@@ -31,6 +31,8 @@ class FontFeatures {
 
   std::string GetFeatureSettings() const;
 
+  bool operator==(const FontFeatures& other) const;
+
  private:
   std::map<std::string, int> feature_map_;
 };
@@ -22,7 +22,7 @@ namespace txt {
 
 PaintRecord::~PaintRecord() = default;
 
-PaintRecord::PaintRecord(TextStyle style,
+PaintRecord::PaintRecord(const TextStyle& style,
                          SkPoint offset,
                          sk_sp<SkTextBlob> text,
                          SkFontMetrics metrics,
@@ -30,7 +30,7 @@ PaintRecord::PaintRecord(TextStyle style,
                          double x_start,
                          double x_end,
                          bool is_ghost)
-    : style_(style),
+    : style_(&style),
       offset_(offset),
       text_(std::move(text)),
       metrics_(metrics),
@@ -39,7 +39,7 @@ PaintRecord::PaintRecord(TextStyle style,
       x_end_(x_end),
       is_ghost_(is_ghost) {}
 
-PaintRecord::PaintRecord(TextStyle style,
+PaintRecord::PaintRecord(const TextStyle& style,
                          SkPoint offset,
                          sk_sp<SkTextBlob> text,
                          SkFontMetrics metrics,
@@ -48,7 +48,7 @@ PaintRecord::PaintRecord(TextStyle style,
                          double x_end,
                          bool is_ghost,
                          PlaceholderRun* placeholder_run)
-    : style_(style),
+    : style_(&style),
       offset_(offset),
       text_(std::move(text)),
       metrics_(metrics),
@@ -58,14 +58,14 @@ PaintRecord::PaintRecord(TextStyle style,
       is_ghost_(is_ghost),
       placeholder_run_(placeholder_run) {}
 
-PaintRecord::PaintRecord(TextStyle style,
+PaintRecord::PaintRecord(const TextStyle& style,
                          sk_sp<SkTextBlob> text,
                          SkFontMetrics metrics,
                          size_t line,
                          double x_start,
                          double x_end,
                          bool is_ghost)
-    : style_(style),
+    : style_(&style),
       text_(std::move(text)),
       metrics_(metrics),
       line_(line),
@@ -29,13 +29,16 @@ namespace txt {
 // PaintRecord holds the layout data after Paragraph::Layout() is called. This
 // stores all necessary offsets, blobs, metrics, and more for Skia to draw the
 // text.
+//
+// The style of a record is not copied. It must outlive the record, as the
+// interned styles of the StyledRuns of a paragraph outlive its layout.
 class PaintRecord {
  public:
   PaintRecord() = delete;
 
   ~PaintRecord();
 
-  PaintRecord(TextStyle style,
+  PaintRecord(const TextStyle& style,
               SkPoint offset,
               sk_sp<SkTextBlob> text,
               SkFontMetrics metrics,
@@ -44,7 +47,7 @@ class PaintRecord {
               double x_end,
               bool is_ghost);
 
-  PaintRecord(TextStyle style,
+  PaintRecord(const TextStyle& style,
               SkPoint offset,
               sk_sp<SkTextBlob> text,
               SkFontMetrics metrics,
@@ -54,7 +57,7 @@ class PaintRecord {
               bool is_ghost,
               PlaceholderRun* placeholder_run);
 
-  PaintRecord(TextStyle style,
+  PaintRecord(const TextStyle& style,
               sk_sp<SkTextBlob> text,
               SkFontMetrics metrics,
               size_t line,
@@ -74,7 +77,7 @@ class PaintRecord {
 
   const SkFontMetrics& metrics() const { return metrics_; }
 
-  const TextStyle& style() const { return style_; }
+  const TextStyle& style() const { return *style_; }
 
   size_t line() const { return line_; }
 
@@ -89,7 +92,7 @@ class PaintRecord {
   bool isPlaceholder() const { return placeholder_run_ == nullptr; }
 
  private:
-  TextStyle style_;
+  const TextStyle* style_;
   // offset_ is the overall offset of the origin of the SkTextBlob.
   SkPoint offset_;
   // SkTextBlob stores the glyphs and coordinates to draw them.
@@ -171,6 +171,12 @@ class Paragraph {
   // Finds the first and last glyphs that define a word containing the glyph at
   // index offset.
   virtual Range<size_t> GetWordBoundary(size_t offset) = 0;
+
+  // Returns a key that is equal for paragraphs that are likely to shape the
+  // same words, such as paragraphs with the same text. LayoutParagraphs() lays
+  // out paragraphs with equal keys one after another so that they share cached
+  // shaping results. Zero means that the paragraph has no such key.
+  virtual size_t GetShapingKey() { return 0; }
 };
 
 }  // namespace txt
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "paragraph_batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/trace_event.h"
+
+namespace txt {
+
+namespace {
+
+// Groups the indexes of the paragraphs by shaping key, in the order in which
+// the keys first appear. A paragraph that is in the list more than once is
+// always in a single group, so that it is never laid out on two threads at
+// once.
+std::vector<std::vector<size_t>> GroupByShapingKey(
+    const std::vector<Paragraph*>& paragraphs) {
+  std::vector<std::vector<size_t>> groups;
+  std::unordered_map<Paragraph*, size_t> paragraph_groups;
+  std::unordered_map<size_t, size_t> key_groups;
+  for (size_t i = 0; i < paragraphs.size(); i++) {
+    Paragraph* paragraph = paragraphs[i];
+    auto found = paragraph_groups.find(paragraph);
+    if (found != paragraph_groups.end()) {
+      groups[found->second].push_back(i);
+      continue;
+    }
+    size_t group = groups.size();
+    const size_t key = paragraph->GetShapingKey();
+    if (key != 0) {
+      group = key_groups.emplace(key, group).first->second;
+    }
+    if (group == groups.size()) {
+      groups.emplace_back();
+    }
+    groups[group].push_back(i);
+    paragraph_groups.emplace(paragraph, group);
+  }
+  return groups;
+}
+
+}  // namespace
+
+void LayoutParagraphs(const std::vector<Paragraph*>& paragraphs,
+                      const std::vector<double>& widths,
+                      fml::ConcurrentTaskRunner* task_runner) {
+  TRACE_EVENT0("flutter", "LayoutParagraphs");
+  FML_DCHECK(paragraphs.size() == widths.size());
+
+  auto groups = GroupByShapingKey(paragraphs);
+  auto layout_group = [&paragraphs, &widths](const std::vector<size_t>& group) {
+    for (size_t index : group) {
+      paragraphs[index]->Layout(widths[index]);
+    }
+  };
+
+  const size_t task_count = std::min<size_t>(
+      groups.size(), std::max(std::thread::hardware_concurrency(), 1u));
+  if (task_runner == nullptr || task_count < 2) {
+    for (const auto& group : groups) {
+      layout_group(group);
+    }
+    return;
+  }
+
+  // Groups are claimed by whichever thread gets to them first, including the
+  // calling thread, so that the layout does not stall when the workers are
+  // busy. The state is shared with the tasks as they may only start running
+  // after all groups were laid out.
+  struct Groups {
+    Groups(std::vector<std::vector<size_t>> groups,
+           std::function<void(const std::vector<size_t>&)> layout)
+        : groups(std::move(groups)),
+          latch(this->groups.size()),
+          layout(std::move(layout)) {}
+
+    const std::vector<std::vector<size_t>> groups;
+    std::atomic<size_t> next{0};
+    fml::CountDownLatch latch;
+    const std::function<void(const std::vector<size_t>&)> layout;
+
+    void LayoutUnclaimed() {
+      for (size_t index = next++; index < groups.size(); index = next++) {
+        layout(groups[index]);
+        latch.CountDown();
+      }
+    }
+  };
+  auto state = std::make_shared<Groups>(std::move(groups), layout_group);
+
+  std::vector<fml::closure> tasks;
+  for (size_t i = 1; i < task_count; i++) {
+    tasks.push_back([state]() { state->LayoutUnclaimed(); });
+  }
+  task_runner->PostTasks(std::move(tasks), fml::ConcurrentTaskPriority::kHigh);
+
+  state->LayoutUnclaimed();
+  state->latch.Wait();
+}
+
+}  // namespace txt
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_PARAGRAPH_BATCH_H_
+#define LIB_TXT_SRC_PARAGRAPH_BATCH_H_
+
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "paragraph.h"
+
+namespace txt {
+
+// Lays out each of the paragraphs at the width with the same index, as if
+// Layout() was called on each of them in order.
+//
+// Paragraphs with the same shaping key are laid out one after another, so
+// that the words shaped for the first of them are found in the layout cache
+// by the rest instead of being shaped again by another thread. If a task
+// runner is given, the groups of paragraphs are laid out concurrently by its
+// workers and the calling thread, and the call returns once all of them were
+// laid out.
+void LayoutParagraphs(const std::vector<Paragraph*>& paragraphs,
+                      const std::vector<double>& widths,
+                      fml::ConcurrentTaskRunner* task_runner = nullptr);
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_PARAGRAPH_BATCH_H_
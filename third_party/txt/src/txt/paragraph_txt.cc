@@ -23,6 +23,7 @@
 #include <limits>
 #include <map>
 #include <numeric>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -233,9 +234,12 @@ ParagraphTxt::~ParagraphTxt() = default;
 
 void ParagraphTxt::SetText(std::vector<uint16_t> text, StyledRuns runs) {
   needs_layout_ = true;
+  needs_measurement_ = true;
   if (text.size() == 0)
     return;
   text_ = std::move(text);
+  // The records refer to the styles of the runs that are replaced.
+  records_.clear();
   runs_ = std::move(runs);
 }
 
@@ -243,6 +247,7 @@ void ParagraphTxt::SetInlinePlaceholders(
     std::vector<PlaceholderRun> inline_placeholders,
     std::unordered_set<size_t> obj_replacement_char_indexes) {
   needs_layout_ = true;
+  needs_measurement_ = true;
   inline_placeholders_ = std::move(inline_placeholders);
   obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
 }
@@ -250,7 +255,14 @@ void ParagraphTxt::SetInlinePlaceholders(
 bool ParagraphTxt::ComputeLineBreaks() {
   line_ranges_.clear();
   line_widths_.clear();
-  max_intrinsic_width_ = 0;
+
+  // The text is only measured when it changed, as the widths of the code units
+  // and the max intrinsic width do not depend on the width of the paragraph.
+  const bool measure = needs_measurement_;
+  if (measure) {
+    char_widths_.assign(text_.size(), 0);
+    max_intrinsic_width_ = 0;
+  }
 
   std::vector<size_t> newline_positions;
   // Discover and add all hard breaks.
@@ -290,6 +302,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
     breaker_.setText();
+    if (!measure) {
+      memcpy(breaker_.charWidths(), char_widths_.data() + block_start,
+             block_size * sizeof(char_widths_[0]));
+    }
 
     // Add the runs that include this line to the LineBreaker.
     double block_total_width = 0;
@@ -339,18 +355,26 @@ bool ParagraphTxt::ComputeLineBreaks() {
         breaker_.addStyleRun(nullptr, collection, font, run_start, run_end,
                              isRtl);
         inline_placeholder_index++;
-      } else {
+      } else if (measure) {
         // Is a regular text run.
         double run_width = breaker_.addStyleRun(&paint, collection, font,
                                                 run_start, run_end, isRtl);
         block_total_width += run_width;
+      } else {
+        // Is a regular text run that was measured by a previous layout.
+        breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                     run_end, isRtl);
       }
 
       if (run.end > block_end)
         break;
       run_index++;
     }
-    max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+    if (measure) {
+      max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+      memcpy(char_widths_.data() + block_start, breaker_.charWidths(),
+             block_size * sizeof(char_widths_[0]));
+    }
 
     size_t breaks_count = breaker_.computeBreaks();
     const int* breaks = breaker_.getBreaks();
@@ -655,9 +679,12 @@ void ParagraphTxt::Layout(double width) {
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
-    return;
+  if (needs_measurement_) {
+    bidi_runs_.clear();
+    if (!ComputeBidiRuns(&bidi_runs_))
+      return;
+    needs_measurement_ = false;
+  }
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -719,7 +746,7 @@ void ParagraphTxt::Layout(double width) {
 
     // Find the runs comprising this line.
     std::vector<BidiRun> line_runs;
-    for (const BidiRun& bidi_run : bidi_runs) {
+    for (const BidiRun& bidi_run : bidi_runs_) {
       // A "ghost" run is a run that does not impact the layout, breaking,
       // alignment, width, etc but is still "visible" through getRectsForRange.
       // For example, trailing whitespace on centered text can be scrolled
@@ -1234,11 +1261,13 @@ double ParagraphTxt::GetLongestLine() {
 
 void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
   needs_layout_ = true;
+  needs_measurement_ = true;
   paragraph_style_ = style;
 }
 
 void ParagraphTxt::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
+  needs_measurement_ = true;
   font_collection_ = std::move(font_collection);
 }
 
@@ -1869,6 +1898,13 @@ Paragraph::Range<size_t> ParagraphTxt::GetWordBoundary(size_t offset) {
   return Range<size_t>(prev_boundary, next_boundary);
 }
 
+size_t ParagraphTxt::GetShapingKey() {
+  if (text_.empty())
+    return 0;
+  return std::hash<std::u16string_view>()(std::u16string_view(
+      reinterpret_cast<const char16_t*>(text_.data()), text_.size()));
+}
+
 size_t ParagraphTxt::GetLineCount() {
   return line_heights_.size();
 }
@@ -1879,6 +1915,9 @@ bool ParagraphTxt::DidExceedMaxLines() {
 
 void ParagraphTxt::SetDirty(bool dirty) {
   needs_layout_ = dirty;
+  if (dirty) {
+    needs_measurement_ = true;
+  }
 }
 
 }  // namespace txt
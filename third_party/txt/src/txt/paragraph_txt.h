@@ -106,6 +106,10 @@ class ParagraphTxt : public Paragraph {
 
   Range<size_t> GetWordBoundary(size_t offset) override;
 
+  // Hashes the text of the paragraph, as words of equal text are likely to be
+  // shaped the same.
+  size_t GetShapingKey() override;
+
   // Returns the number of lines the paragraph takes up. If the text exceeds the
   // amount width and maxlines provides, Layout() truncates the extra text from
   // the layout and this will return the max lines allowed.
@@ -114,8 +118,9 @@ class ParagraphTxt : public Paragraph {
   bool DidExceedMaxLines() override;
 
   // Sets the needs_layout_ to dirty. When Layout() is called, a new Layout will
-  // be performed when this is set to true. Can also be used to prevent a new
-  // Layout from being calculated by setting to false.
+  // be performed when this is set to true, which also measures the text again.
+  // Can also be used to prevent a new Layout from being calculated by setting
+  // to false.
   void SetDirty(bool dirty = true);
 
  private:
@@ -141,6 +146,7 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST_WINDOWS_DISABLED(ParagraphTest, EmojiParagraph);
   FRIEND_TEST(ParagraphTest, HyphenBreakParagraph);
   FRIEND_TEST(ParagraphTest, RepeatLayoutParagraph);
+  FRIEND_TEST(ParagraphTest, RelayoutAtNewWidthReusesMeasurements);
   FRIEND_TEST(ParagraphTest, Ellipsize);
   FRIEND_TEST(ParagraphTest, UnderlineShiftParagraph);
   FRIEND_TEST(ParagraphTest, WavyDecorationParagraph);
@@ -320,6 +326,14 @@ class ParagraphTxt : public Paragraph {
 
   bool needs_layout_ = true;
 
+  // The widths of the code units of text_ and the bidi runs of the text. They
+  // do not depend on the width of the paragraph, so a Layout() that only
+  // changes the width reuses them and breaks and positions the lines without
+  // shaping the text again.
+  std::vector<float> char_widths_;
+  std::vector<BidiRun> bidi_runs_;
+  bool needs_measurement_ = true;
+
   struct WaveCoordinates {
     double x_start;
     double y_start;
@@ -42,9 +42,7 @@ void StyledRuns::swap(StyledRuns& other) {
 }
 
 size_t StyledRuns::AddStyle(const TextStyle& style) {
-  const size_t style_index = styles_.size();
-  styles_.push_back(style);
-  return style_index;
+  return styles_.Intern(style);
 }
 
 const TextStyle& StyledRuns::GetStyle(size_t style_index) const {
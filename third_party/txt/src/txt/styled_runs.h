@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "text_style.h"
+#include "text_style_table.h"
 #include "third_party/googletest/googletest/include/gtest/gtest_prod.h"  // nogncheck
 #include "utils/WindowsUtils.h"
 
@@ -48,6 +49,8 @@ class StyledRuns {
 
   void swap(StyledRuns& other);
 
+  // Returns the index of the style for use with StartRun(). Equal styles are
+  // stored once and share an index.
   size_t AddStyle(const TextStyle& style);
 
   const TextStyle& GetStyle(size_t style_index) const;
@@ -58,6 +61,9 @@ class StyledRuns {
 
   size_t size() const { return runs_.size(); }
 
+  // Returns the number of distinct styles.
+  size_t style_count() const { return styles_.size(); }
+
   Run GetRun(size_t index) const;
 
  private:
@@ -92,7 +98,7 @@ class StyledRuns {
         : style_index(style_index), start(start), end(end) {}
   };
 
-  std::vector<TextStyle> styles_;
+  TextStyleTable styles_;
   std::vector<IndexedRun> runs_;
 };
 
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "text_style_table.h"
+
+#include <functional>
+
+#include "utils/JenkinsHash.h"
+
+namespace txt {
+
+namespace {
+
+uint32_t HashDouble(double value) {
+  return static_cast<uint32_t>(std::hash<double>()(value));
+}
+
+uint32_t HashString(const std::string& value) {
+  return android::JenkinsHashMixBytes(
+      0, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+// Hashes the properties that usually tell styles apart. Equal styles have
+// equal hashes, SameStyle() resolves the collisions.
+size_t HashStyle(const TextStyle& style) {
+  uint32_t hash = android::JenkinsHashMix(0, style.color);
+  hash = android::JenkinsHashMix(hash, style.decoration);
+  hash = android::JenkinsHashMix(hash,
+                                 static_cast<uint32_t>(style.font_weight));
+  hash = android::JenkinsHashMix(hash,
+                                 static_cast<uint32_t>(style.font_style));
+  hash = android::JenkinsHashMix(hash, HashDouble(style.font_size));
+  hash = android::JenkinsHashMix(hash, HashDouble(style.letter_spacing));
+  hash = android::JenkinsHashMix(hash, HashDouble(style.height));
+  for (const std::string& family : style.font_families) {
+    hash = android::JenkinsHashMix(hash, HashString(family));
+  }
+  hash = android::JenkinsHashMix(hash, HashString(style.locale));
+  return android::JenkinsHashWhiten(hash);
+}
+
+// Unlike TextStyle::equals, compares every property that affects the layout
+// or painting of the text.
+bool SameStyle(const TextStyle& a, const TextStyle& b) {
+  return a.color == b.color && a.decoration == b.decoration &&
+         a.decoration_color == b.decoration_color &&
+         a.decoration_style == b.decoration_style &&
+         a.decoration_thickness_multiplier ==
+             b.decoration_thickness_multiplier &&
+         a.font_weight == b.font_weight && a.font_style == b.font_style &&
+         a.text_baseline == b.text_baseline &&
+         a.font_families == b.font_families && a.font_size == b.font_size &&
+         a.letter_spacing == b.letter_spacing &&
+         a.word_spacing == b.word_spacing && a.height == b.height &&
+         a.has_height_override == b.has_height_override &&
+         a.locale == b.locale && a.has_background == b.has_background &&
+         a.background == b.background &&
+         a.has_foreground == b.has_foreground &&
+         a.foreground == b.foreground && a.text_shadows == b.text_shadows &&
+         a.font_features == b.font_features;
+}
+
+}  // namespace
+
+TextStyleTable::TextStyleTable() = default;
+
+TextStyleTable::~TextStyleTable() = default;
+
+TextStyleTable::TextStyleTable(TextStyleTable&& other) = default;
+
+TextStyleTable& TextStyleTable::operator=(TextStyleTable&& other) = default;
+
+void TextStyleTable::swap(TextStyleTable& other) {
+  styles_.swap(other.styles_);
+  handles_.swap(other.handles_);
+}
+
+TextStyleTable::Handle TextStyleTable::Intern(const TextStyle& style) {
+  const size_t hash = HashStyle(style);
+  auto range = handles_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (SameStyle(styles_[it->second], style)) {
+      return it->second;
+    }
+  }
+  const Handle handle = styles_.size();
+  styles_.push_back(style);
+  handles_.emplace(hash, handle);
+  return handle;
+}
+
+}  // namespace txt
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_TEXT_STYLE_TABLE_H_
+#define LIB_TXT_SRC_TEXT_STYLE_TABLE_H_
+
+#include <deque>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "text_style.h"
+
+namespace txt {
+
+// An append-only table of distinct text styles. Equal styles are stored once
+// and are referred to by the same integer handle, so that the runs of a
+// paragraph and the paint records of its layout share the styles instead of
+// each holding a copy of the font families, locale and shadows.
+//
+// Styles are never moved or removed, so references to them stay valid for as
+// long as the table, or the table it was moved into, lives.
+class TextStyleTable {
+ public:
+  using Handle = size_t;
+
+  TextStyleTable();
+
+  ~TextStyleTable();
+
+  TextStyleTable(TextStyleTable&& other);
+
+  TextStyleTable& operator=(TextStyleTable&& other);
+
+  void swap(TextStyleTable& other);
+
+  // Returns the handle of the style in the table that is equal to |style|,
+  // adding a copy of |style| if there is none.
+  Handle Intern(const TextStyle& style);
+
+  const TextStyle& operator[](Handle handle) const { return styles_[handle]; }
+
+  size_t size() const { return styles_.size(); }
+
+ private:
+  std::deque<TextStyle> styles_;
+  // Maps the hashes of the styles to their handles.
+  std::unordered_multimap<size_t, Handle> handles_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextStyleTable);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_TEXT_STYLE_TABLE_H_
@@ -63,7 +63,6 @@ void itemize(const std::shared_ptr<FontCollection>& collection,
 
   result->clear();
   ParseUnicode(buf, BUF_SIZE, str, &len, NULL);
-  std::scoped_lock _l(gMinikinLock);
   collection->itemize(buf, len, style, result);
 }
 
@@ -76,7 +75,6 @@ const std::string& getFontPath(const FontCollection::Run& run) {
 // Utility function to obtain FontLanguages from string.
 const FontLanguages& registerAndGetFontLanguages(
     const std::string& lang_string) {
-  std::scoped_lock _l(gMinikinLock);
   return FontLanguageListCache::getById(
       FontLanguageListCache::getId(lang_string));
 }
@@ -16,13 +16,16 @@
 
 #include <iostream>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "third_party/skia/include/core/SkPath.h"
 #include "txt/font_style.h"
 #include "txt/font_weight.h"
+#include "txt/paragraph_batch.h"
 #include "txt/paragraph_builder_txt.h"
 #include "txt/paragraph_txt.h"
 #include "txt/placeholder_run.h"
@@ -4148,6 +4151,168 @@ TEST_F(ParagraphTest, RepeatLayoutParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, RelayoutAtNewWidthReusesMeasurements) {
+  const char* text =
+      "Sentence to layout at diff widths to get diff line counts. short words "
+      "short words short words short words short words short words short words "
+      "short words short words short words short words short words short words "
+      "end";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  paragraph_style.text_align = TextAlign::justify;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 31;
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph = build_paragraph();
+  paragraph->Layout(300);
+  ASSERT_FALSE(paragraph->needs_measurement_);
+  size_t narrow_line_count = paragraph->GetLineCount();
+
+  // Only line breaking and positioning run again for the new width.
+  paragraph->Layout(600);
+  ASSERT_FALSE(paragraph->needs_measurement_);
+
+  ASSERT_LT(paragraph->GetLineCount(), narrow_line_count);
+
+  auto fresh_paragraph = build_paragraph();
+  fresh_paragraph->Layout(600);
+  ASSERT_EQ(paragraph->GetLineCount(), fresh_paragraph->GetLineCount());
+  ASSERT_EQ(paragraph->GetHeight(), fresh_paragraph->GetHeight());
+  ASSERT_EQ(paragraph->GetLongestLine(), fresh_paragraph->GetLongestLine());
+  ASSERT_EQ(paragraph->GetMaxIntrinsicWidth(),
+            fresh_paragraph->GetMaxIntrinsicWidth());
+  ASSERT_EQ(paragraph->GetMinIntrinsicWidth(),
+            fresh_paragraph->GetMinIntrinsicWidth());
+
+  std::vector<txt::Paragraph::TextBox> boxes = paragraph->GetRectsForRange(
+      0, u16_text.length(), Paragraph::RectHeightStyle::kTight,
+      Paragraph::RectWidthStyle::kTight);
+  std::vector<txt::Paragraph::TextBox> fresh_boxes =
+      fresh_paragraph->GetRectsForRange(0, u16_text.length(),
+                                        Paragraph::RectHeightStyle::kTight,
+                                        Paragraph::RectWidthStyle::kTight);
+  ASSERT_EQ(boxes.size(), fresh_boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) {
+    EXPECT_EQ(boxes[i].rect, fresh_boxes[i].rect);
+  }
+
+  // A dirty paragraph is measured again.
+  paragraph->SetDirty();
+  ASSERT_TRUE(paragraph->needs_measurement_);
+  paragraph->Layout(600);
+  ASSERT_FALSE(paragraph->needs_measurement_);
+  ASSERT_EQ(paragraph->GetLineCount(), fresh_paragraph->GetLineCount());
+}
+
+TEST_F(ParagraphTest, LayoutParagraphsMatchesLayout) {
+  const std::vector<std::string> texts = {
+      "Label", "A longer label that wraps at narrow widths", "Label 2"};
+  const std::vector<double> widths = {50, 120, 400};
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 20;
+  text_style.color = SK_ColorBLACK;
+
+  auto build_paragraph = [&](const std::string& text) {
+    auto icu_text = icu::UnicodeString::fromUTF8(text);
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  std::vector<std::unique_ptr<ParagraphTxt>> batched;
+  std::vector<std::unique_ptr<ParagraphTxt>> expected;
+  std::vector<double> batch_widths;
+  for (int copy = 0; copy < 4; copy++) {
+    for (const auto& text : texts) {
+      for (double width : widths) {
+        batched.push_back(build_paragraph(text));
+        expected.push_back(build_paragraph(text));
+        expected.back()->Layout(width);
+        batch_widths.push_back(width);
+      }
+    }
+  }
+
+  ASSERT_EQ(batched[0]->GetShapingKey(), batched[1]->GetShapingKey());
+  ASSERT_NE(batched[0]->GetShapingKey(), batched[3]->GetShapingKey());
+
+  std::vector<Paragraph*> paragraphs;
+  for (const auto& paragraph : batched) {
+    paragraphs.push_back(paragraph.get());
+  }
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  txt::LayoutParagraphs(paragraphs, batch_widths, loop->GetTaskRunner().get());
+
+  for (size_t i = 0; i < batched.size(); i++) {
+    EXPECT_EQ(batched[i]->GetMaxWidth(), expected[i]->GetMaxWidth());
+    EXPECT_EQ(batched[i]->GetHeight(), expected[i]->GetHeight());
+    EXPECT_EQ(batched[i]->GetLongestLine(), expected[i]->GetLongestLine());
+    EXPECT_EQ(batched[i]->GetLineCount(), expected[i]->GetLineCount());
+    EXPECT_EQ(batched[i]->GetMinIntrinsicWidth(),
+              expected[i]->GetMinIntrinsicWidth());
+    EXPECT_EQ(batched[i]->GetMaxIntrinsicWidth(),
+              expected[i]->GetMaxIntrinsicWidth());
+  }
+}
+
+TEST_F(ParagraphTest, LayoutParagraphsLaysOutRepeatedParagraphsInOrder) {
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 20;
+
+  auto build_paragraph = [&](const std::u16string& text) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+  auto empty = build_paragraph(u"");
+  auto label = build_paragraph(u"A label that wraps");
+  ASSERT_EQ(empty->GetShapingKey(), 0u);
+
+  // A paragraph that is in the list more than once is laid out by one thread,
+  // in list order, so that it ends up laid out at its last width.
+  std::vector<Paragraph*> paragraphs;
+  std::vector<double> widths;
+  for (int i = 0; i < 64; i++) {
+    paragraphs.push_back(empty.get());
+    paragraphs.push_back(label.get());
+    widths.push_back(10 + i);
+    widths.push_back(i % 2 ? 50 : 400);
+  }
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  txt::LayoutParagraphs(paragraphs, widths, loop->GetTaskRunner().get());
+
+  auto expected = build_paragraph(u"A label that wraps");
+  expected->Layout(50);
+  EXPECT_EQ(label->GetMaxWidth(), 50);
+  EXPECT_EQ(label->GetLineCount(), expected->GetLineCount());
+  EXPECT_EQ(empty->GetMaxWidth(), 73);
+}
+
 TEST_F(ParagraphTest, Ellipsize) {
   const char* text =
       "This is a very long sentence to test if the text will properly wrap "
@@ -5154,4 +5319,73 @@ TEST_F(ParagraphTest, FontFeaturesParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, ShapedWordsAreReusedAcrossParagraphs) {
+  const char* text = "Hello World Text Dialog";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto layout_paragraph = [&]() {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(GetTestCanvasWidth());
+    return paragraph;
+  };
+
+  minikin::Layout::purgeCaches();
+  auto first = layout_paragraph();
+  minikin::LayoutCacheStats after_first = minikin::Layout::getCacheStats();
+  ASSERT_GT(after_first.entries, 0u);
+  ASSERT_GT(after_first.bytes, 0u);
+  ASSERT_LE(after_first.bytes, after_first.budgetBytes);
+
+  // The second paragraph finds every word in the cache.
+  auto second = layout_paragraph();
+  minikin::LayoutCacheStats after_second = minikin::Layout::getCacheStats();
+  EXPECT_EQ(after_second.misses, after_first.misses);
+  EXPECT_GT(after_second.hits, after_first.hits);
+  EXPECT_EQ(after_second.entries, after_first.entries);
+  EXPECT_EQ(second->GetLongestLine(), first->GetLongestLine());
+}
+
+TEST_F(ParagraphTest, ShapedWordCacheStaysWithinItsBudget) {
+  const size_t budget = minikin::Layout::getCacheStats().budgetBytes;
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  minikin::Layout::purgeCaches();
+  minikin::Layout::setCacheBudget(16 * 1024);
+  for (int i = 0; i < 1000; i++) {
+    auto icu_text = icu::UnicodeString::fromUTF8("word" + std::to_string(i));
+    std::u16string u16_text(icu_text.getBuffer(),
+                            icu_text.getBuffer() + icu_text.length());
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    BuildParagraph(builder)->Layout(GetTestCanvasWidth());
+  }
+  minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  EXPECT_LE(stats.bytes, stats.budgetBytes);
+  EXPECT_GT(stats.entries, 0u);
+  EXPECT_LT(stats.entries, 1000u);
+
+  minikin::Layout::setCacheBudget(0);
+  EXPECT_EQ(minikin::Layout::getCacheStats().entries, 0u);
+  EXPECT_EQ(minikin::Layout::getCacheStats().bytes, 0u);
+
+  minikin::Layout::setCacheBudget(budget);
+}
+
 }  // namespace txt
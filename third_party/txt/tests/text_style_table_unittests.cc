@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "txt/styled_runs.h"
+#include "txt/text_style_table.h"
+
+namespace txt {
+
+TEST(TextStyleTable, InternsEqualStyles) {
+  TextStyle style;
+  style.font_families = std::vector<std::string>(1, "Roboto");
+  style.locale = "en_US";
+  style.text_shadows.emplace_back(SK_ColorBLACK, SkPoint::Make(1, 1), 2);
+
+  TextStyleTable table;
+  auto handle = table.Intern(style);
+  TextStyle copy = style;
+  ASSERT_EQ(table.Intern(copy), handle);
+  ASSERT_EQ(table.size(), 1u);
+  ASSERT_TRUE(table[handle].equals(style));
+}
+
+TEST(TextStyleTable, KeepsStylesThatDifferInAnyProperty) {
+  TextStyle style;
+  style.font_families = std::vector<std::string>(1, "Roboto");
+
+  // TextStyle::equals does not compare the font size.
+  TextStyle larger = style;
+  larger.font_size = style.font_size * 2;
+  TextStyle shadowed = style;
+  shadowed.text_shadows.emplace_back(SK_ColorBLACK, SkPoint::Make(1, 1), 2);
+  TextStyle featured = style;
+  featured.font_features.SetFeature("tnum", 1);
+
+  TextStyleTable table;
+  auto handle = table.Intern(style);
+  ASSERT_NE(table.Intern(larger), handle);
+  ASSERT_NE(table.Intern(shadowed), handle);
+  ASSERT_NE(table.Intern(featured), handle);
+  ASSERT_EQ(table.size(), 4u);
+  ASSERT_EQ(table[handle].font_size, style.font_size);
+}
+
+TEST(TextStyleTable, StylesKeepTheirAddressWhenTheTableGrowsOrMoves) {
+  TextStyleTable table;
+  TextStyle style;
+  style.font_size = 0;
+  const TextStyle& first = table[table.Intern(style)];
+  for (int i = 1; i < 1000; i++) {
+    style.font_size = i;
+    table.Intern(style);
+  }
+  TextStyleTable moved(std::move(table));
+  ASSERT_EQ(&moved[0], &first);
+  ASSERT_EQ(moved.size(), 1000u);
+}
+
+TEST(TextStyleTable, StyledRunsShareInternedStyles) {
+  TextStyle link;
+  link.color = SK_ColorBLUE;
+  link.decoration = TextDecoration::kUnderline;
+  TextStyle plain;
+
+  StyledRuns runs;
+  for (size_t i = 0; i < 10; i++) {
+    runs.StartRun(runs.AddStyle(i % 2 ? link : plain), i * 5);
+  }
+  runs.EndRunIfNeeded(50);
+  ASSERT_EQ(runs.size(), 10u);
+  ASSERT_EQ(runs.style_count(), 2u);
+  ASSERT_EQ(&runs.GetRun(1).style, &runs.GetRun(3).style);
+  ASSERT_EQ(runs.GetRun(1).style.color, SK_ColorBLUE);
+}
+
+}  // namespace txt